@@ -0,0 +1,92 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Plays games of twixt::MctsAgent against itself with a deadline per move
+// (see MctsAgent::StepUntil) and reports the search and the latency of the
+// moves, e.g.
+//
+//   ./build/examples/twixt_anytime --board_size=24 --move_ms=50 --games=10
+//
+// The deadline of a move is set when the move is asked for, so the latency
+// includes nothing but the search.
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+
+#include "open_spiel/abseil-cpp/absl/flags/flag.h"
+#include "open_spiel/abseil-cpp/absl/flags/parse.h"
+#include "open_spiel/games/twixt/twixt.h"
+#include "open_spiel/games/twixt/twixtagent.h"
+#include "open_spiel/spiel.h"
+
+ABSL_FLAG(int, board_size, 24, "Board size.");
+ABSL_FLAG(double, move_ms, 50, "Time per move in milliseconds.");
+ABSL_FLAG(int, games, 10, "Number of games.");
+ABSL_FLAG(bool, prune_useless_moves, true, "No children for useless moves.");
+ABSL_FLAG(int, seed, 0, "Seed of the games.");
+
+namespace open_spiel {
+namespace twixt {
+namespace {
+
+void RunAnytime() {
+  std::shared_ptr<const Game> game = LoadGame(
+      "twixt",
+      {{"board_size", GameParameter(absl::GetFlag(FLAGS_board_size))}});
+  MctsOptions options;
+  options.prune_useless_moves = absl::GetFlag(FLAGS_prune_useless_moves);
+  MctsAgent agent(*game, options);
+  const auto move_time = std::chrono::duration_cast<MctsAgent::Clock::duration>(
+      std::chrono::duration<double, std::milli>(absl::GetFlag(FLAGS_move_ms)));
+
+  std::mt19937 rng(absl::GetFlag(FLAGS_seed));
+  for (int g = 0; g < absl::GetFlag(FLAGS_games); g++) {
+    std::unique_ptr<State> state = game->NewInitialState();
+    while (!state->IsTerminal()) {
+      state->ApplyAction(agent.StepUntil(static_cast<TwixTState&>(*state),
+                                         &rng,
+                                         MctsAgent::Clock::now() + move_time));
+    }
+  }
+
+  const SearchStats& stats = agent.stats();
+  std::printf("moves           %lld in %d games\n",
+              static_cast<long long>(stats.num_moves),
+              absl::GetFlag(FLAGS_games));
+  std::printf("simulations     %.1f per move, %.0f per second\n",
+              static_cast<double>(stats.num_simulations) / stats.num_moves,
+              stats.num_simulations / stats.total_latency);
+  std::printf("nodes           %.1f per move\n",
+              static_cast<double>(stats.num_nodes) / stats.num_moves);
+  std::printf("latency ms      mean %.2f, p50 %.2f, p90 %.2f, p99 %.2f, "
+              "max %.2f\n",
+              1e3 * stats.total_latency / stats.num_moves,
+              1e3 * stats.LatencyPercentile(0.5),
+              1e3 * stats.LatencyPercentile(0.9),
+              1e3 * stats.LatencyPercentile(0.99), 1e3 * stats.max_latency);
+  std::printf("overruns        %lld (%.2f%%)\n",
+              static_cast<long long>(stats.num_overruns),
+              100.0 * stats.num_overruns / stats.num_moves);
+}
+
+}  // namespace
+}  // namespace twixt
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  open_spiel::twixt::RunAnytime();
+}
@@ -0,0 +1,107 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Steps K random TwixT games in lockstep, on a BatchBoard and on K Boards,
+// for K from --min_games to --max_games, and compares the time per move,
+// e.g.
+//
+//   ./build/examples/twixt_batch --board_size=24 --min_games=64
+//       --max_games=8192 --steps=200 --check
+//
+// Build with vectorization for the target (e.g. -O3 -march=native) to let
+// the compiler use SIMD gathers in BatchBoard::ApplyActions.
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/flags/flag.h"
+#include "open_spiel/abseil-cpp/absl/flags/parse.h"
+#include "open_spiel/games/twixt/twixtbatch.h"
+#include "open_spiel/games/twixt/twixtboard.h"
+#include "open_spiel/spiel.h"
+
+ABSL_FLAG(int, board_size, 24, "Board size.");
+ABSL_FLAG(int, min_games, 64, "Smallest number of games K.");
+ABSL_FLAG(int, max_games, 8192, "Largest number of games K.");
+ABSL_FLAG(int, steps, 200, "Moves applied to each game per K.");
+ABSL_FLAG(bool, check, false,
+          "Check after every step that the results are the same.");
+
+namespace open_spiel {
+namespace twixt {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+void RunBenchmark() {
+  const int board_size = absl::GetFlag(FLAGS_board_size);
+  const Board initial_board(board_size, false);
+  std::mt19937 rng(0);
+  std::printf("%8s %12s %12s %12s %8s\n", "K", "moves", "batch ns", "board ns",
+              "speedup");
+  for (int k = absl::GetFlag(FLAGS_min_games);
+       k <= absl::GetFlag(FLAGS_max_games); k *= 2) {
+    BatchBoard batch(board_size, k);
+    std::vector<Board> boards(k, initial_board);
+    std::vector<Action> actions(k);
+    std::chrono::duration<double> batch_time(0), board_time(0);
+    int64_t moves = 0;
+
+    for (int step = 0; step < absl::GetFlag(FLAGS_steps); step++) {
+      // random legal actions by rejection, finished games start over
+      for (int g = 0; g < k; g++) {
+        if (batch.result(g) != kOpen) {
+          batch.ResetGame(g);
+          boards[g] = initial_board;
+        }
+        do {
+          actions[g] = rng() % (board_size * board_size);
+        } while (!batch.IsLegalAction(g, actions[g]));
+      }
+      moves += k;
+
+      auto start = Clock::now();
+      batch.ApplyActions(actions);
+      batch_time += Clock::now() - start;
+
+      start = Clock::now();
+      for (int g = 0; g < k; g++) {
+        boards[g].ApplyAction(boards[g].move_counter() % 2, actions[g]);
+      }
+      board_time += Clock::now() - start;
+
+      if (absl::GetFlag(FLAGS_check)) {
+        for (int g = 0; g < k; g++) {
+          SPIEL_CHECK_EQ(batch.result(g), boards[g].result());
+        }
+      }
+    }
+    double batch_ns = batch_time.count() * 1e9 / moves;
+    double board_ns = board_time.count() * 1e9 / moves;
+    std::printf("%8d %12lld %12.1f %12.1f %8.2f\n", k,
+                static_cast<long long>(moves), batch_ns, board_ns,
+                board_ns / batch_ns);
+  }
+}
+
+}  // namespace
+}  // namespace twixt
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  open_spiel::twixt::RunBenchmark();
+}
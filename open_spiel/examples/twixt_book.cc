@@ -0,0 +1,155 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Builds a TwixT opening book from game records (see twixtrecord.h) or from
+// action files as written by twixt_import and self-play, one game per line
+// (board size followed by the actions), e.g.
+//
+//   ./build/examples/twixt_book --files=games.txt --action_files=selfplay.txt
+//       --board_size=24 --max_moves=12 --min_visits=4 --output=twixt24.book
+//
+// or prints the book moves of a position:
+//
+//   ./build/examples/twixt_book --book=twixt24.book --actions=110,110
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/flags/flag.h"
+#include "open_spiel/abseil-cpp/absl/flags/parse.h"
+#include "open_spiel/abseil-cpp/absl/strings/numbers.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_split.h"
+#include "open_spiel/games/twixt/twixt.h"
+#include "open_spiel/games/twixt/twixtbook.h"
+#include "open_spiel/games/twixt/twixtrecord.h"
+#include "open_spiel/spiel.h"
+
+ABSL_FLAG(std::vector<std::string>, files, {},
+          "Comma separated files of game records.");
+ABSL_FLAG(std::vector<std::string>, action_files, {},
+          "Comma separated files of games, one line of actions per game.");
+ABSL_FLAG(int, board_size, 24, "Board size of the book.");
+ABSL_FLAG(int, max_moves, 12, "Number of moves of each game in the book.");
+ABSL_FLAG(int, min_visits, 2, "Moves played less often are left out.");
+ABSL_FLAG(int, threads, std::thread::hardware_concurrency(),
+          "Number of threads the record files are shared out among.");
+ABSL_FLAG(std::string, output, "", "Book file to write.");
+ABSL_FLAG(std::string, book, "", "Book file to look up a position in.");
+ABSL_FLAG(std::string, actions, "",
+          "Comma separated actions leading to the position to look up.");
+
+namespace open_spiel {
+namespace twixt {
+namespace {
+
+void BuildBook() {
+  const int board_size = absl::GetFlag(FLAGS_board_size);
+  OpeningBookBuilder builder(board_size, absl::GetFlag(FLAGS_max_moves));
+  int num_games = 0;
+
+  std::mutex mutex;
+  ImportOptions options;
+  options.board_size = board_size;
+  ImportStats stats = ImportFiles(
+      absl::GetFlag(FLAGS_files), options, absl::GetFlag(FLAGS_threads),
+      [&](const GameRecord& record) {
+        if (record.board.size() == board_size) {
+          std::lock_guard<std::mutex> lock(mutex);
+          builder.AddGame(record.actions, record.declared_result);
+          num_games++;
+        }
+      });
+  for (const std::string& error : stats.errors) {
+    std::fprintf(stderr, "%s\n", error.c_str());
+  }
+
+  for (const std::string& path : absl::GetFlag(FLAGS_action_files)) {
+    std::ifstream file(path);
+    if (!file) {
+      SpielFatalError("Cannot read " + path);
+    }
+    std::string line;
+    std::vector<Action> actions;
+    while (std::getline(file, line)) {
+      std::istringstream numbers(line);
+      int size;
+      Action action;
+      actions.clear();
+      if (!(numbers >> size) || size != board_size) {
+        continue;
+      }
+      while (numbers >> action) {
+        actions.push_back(action);
+      }
+      builder.AddGame(actions, kOpen);
+      num_games++;
+    }
+  }
+
+  builder.Write(absl::GetFlag(FLAGS_output), absl::GetFlag(FLAGS_min_visits));
+  OpeningBook book(absl::GetFlag(FLAGS_output));
+  std::printf("games %d, positions %d, book entries %llu\n", num_games,
+              builder.num_positions(),
+              static_cast<unsigned long long>(book.num_entries()));
+}
+
+void LookupPosition() {
+  OpeningBook book(absl::GetFlag(FLAGS_book));
+  GameParameters params;
+  params["board_size"] = GameParameter(book.board_size());
+  params["ansi_color_output"] = GameParameter(false);
+  std::shared_ptr<const Game> game = LoadGame("twixt", params);
+  std::unique_ptr<State> state = game->NewInitialState();
+  for (absl::string_view token :
+       absl::StrSplit(absl::GetFlag(FLAGS_actions), ',', absl::SkipEmpty())) {
+    int action;
+    if (!absl::SimpleAtoi(token, &action)) {
+      SpielFatalError("Not an action: " + std::string(token));
+    }
+    state->ApplyAction(action);
+  }
+  std::printf("%s\n\n", state->ToString().c_str());
+
+  std::printf("%-8s %8s %10s %10s %8s\n", "move", "action", "visits", "wins",
+              "score");
+  for (const BookMove& move :
+       book.Lookup(static_cast<const TwixTState&>(*state))) {
+    std::printf("%-8s %8lld %10u %10u %8.3f\n",
+                state->ActionToString(state->CurrentPlayer(), move.action)
+                    .c_str(),
+                static_cast<long long>(move.action), move.visits, move.wins,
+                move.Score());
+  }
+}
+
+}  // namespace
+}  // namespace twixt
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  if (!absl::GetFlag(FLAGS_output).empty()) {
+    open_spiel::twixt::BuildBook();
+  } else if (!absl::GetFlag(FLAGS_book).empty()) {
+    open_spiel::twixt::LookupPosition();
+  } else {
+    open_spiel::SpielFatalError("Give --output to build or --book to look up.");
+  }
+}
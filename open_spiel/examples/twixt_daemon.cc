@@ -0,0 +1,121 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Analysis daemon for the tools of a host (see twixtdaemon.h for the
+// protocol), e.g.
+//
+//   ./build/examples/twixt_daemon --socket=/tmp/twixt.sock --board_size=24
+//       --threads=8 --simulations=800
+//
+// and from a shell
+//
+//   echo "best 290,315" | nc -U -q1 /tmp/twixt.sock
+//
+// Runs until SIGINT or SIGTERM, then prints its counters.
+
+#include <csignal>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/flags/flag.h"
+#include "open_spiel/abseil-cpp/absl/flags/parse.h"
+#include "open_spiel/games/twixt/twixt.h"
+#include "open_spiel/games/twixt/twixtdaemon.h"
+#include "open_spiel/games/twixt/twixtselfplay.h"
+#include "open_spiel/spiel.h"
+
+ABSL_FLAG(std::string, socket, "/tmp/twixt.sock", "Path of the socket.");
+ABSL_FLAG(int, board_size, 24, "Board size.");
+ABSL_FLAG(bool, link_removal, false, "Game with link removal.");
+ABSL_FLAG(int, threads, 1, "Threads for the searches and rollouts.");
+ABSL_FLAG(int, simulations, 800, "Simulations per best request.");
+ABSL_FLAG(int, rollouts, 64, "Rollouts per eval request (rollout).");
+ABSL_FLAG(int, max_batch_requests, 256, "Requests answered together.");
+ABSL_FLAG(int, batch_size, 64, "Observations per evaluator call (stub).");
+ABSL_FLAG(int, cache_size, 1 << 16, "Results kept, 0 for no cache.");
+ABSL_FLAG(std::string, evaluator, "rollout",
+          "rollout: twixt::RolloutPolicy, stub: twixt::StubEvaluator.");
+ABSL_FLAG(bool, prune_useless_moves, true, "No children for useless moves.");
+
+namespace open_spiel {
+namespace twixt {
+namespace {
+
+AnalysisDaemon* running_daemon = nullptr;
+
+void StopDaemon(int) { running_daemon->Stop(); }
+
+void RunDaemon() {
+  std::shared_ptr<const Game> game = LoadGame(
+      "twixt",
+      {{"board_size", GameParameter(absl::GetFlag(FLAGS_board_size))},
+       {"link_removal", GameParameter(absl::GetFlag(FLAGS_link_removal))}});
+  DaemonOptions options;
+  options.num_threads = absl::GetFlag(FLAGS_threads);
+  options.num_simulations = absl::GetFlag(FLAGS_simulations);
+  options.num_rollouts = absl::GetFlag(FLAGS_rollouts);
+  options.max_batch_requests = absl::GetFlag(FLAGS_max_batch_requests);
+  options.batch_size = absl::GetFlag(FLAGS_batch_size);
+  options.cache_size = absl::GetFlag(FLAGS_cache_size);
+  options.prune_useless_moves = absl::GetFlag(FLAGS_prune_useless_moves);
+  const std::string evaluator = absl::GetFlag(FLAGS_evaluator);
+  std::vector<std::unique_ptr<StubEvaluator>> stubs;
+  std::vector<LeafEvaluator*> evaluators;
+  if (evaluator == "stub") {
+    for (int t = 0; t < options.num_threads; t++) {
+      stubs.emplace_back(new StubEvaluator(*game, 64, 0));
+      evaluators.push_back(stubs.back().get());
+    }
+  } else if (evaluator != "rollout") {
+    SpielFatalError("Unknown evaluator: " + evaluator);
+  }
+
+  AnalysisDaemon analysis_daemon(game, options, evaluators);
+  analysis_daemon.Listen(absl::GetFlag(FLAGS_socket));
+  running_daemon = &analysis_daemon;
+  std::signal(SIGINT, StopDaemon);
+  std::signal(SIGTERM, StopDaemon);
+  std::printf("listening on %s\n", absl::GetFlag(FLAGS_socket).c_str());
+  std::fflush(stdout);
+  analysis_daemon.Serve();
+
+  const DaemonStats& stats = analysis_daemon.stats();
+  std::printf("connections     %lld\n",
+              static_cast<long long>(stats.num_connections));
+  std::printf("requests        %lld, %lld errors\n",
+              static_cast<long long>(stats.num_requests),
+              static_cast<long long>(stats.num_errors));
+  std::printf("batches         %lld, %.1f requests each, %.1f s\n",
+              static_cast<long long>(stats.num_batches),
+              stats.num_batches > 0
+                  ? static_cast<double>(stats.num_requests) / stats.num_batches
+                  : 0.0,
+              stats.batch_seconds);
+  std::printf("computed        %lld evaluations, %lld searches\n",
+              static_cast<long long>(stats.num_evaluations),
+              static_cast<long long>(stats.num_searches));
+  std::printf("cache hits      %lld\n",
+              static_cast<long long>(stats.num_cache_hits));
+}
+
+}  // namespace
+}  // namespace twixt
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  open_spiel::twixt::RunDaemon();
+}
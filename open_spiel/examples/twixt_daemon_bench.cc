@@ -0,0 +1,209 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Latency and throughput of a twixt::AnalysisDaemon for each number of
+// concurrent clients, e.g.
+//
+//   ./build/examples/twixt_daemon_bench --board_size=24 --clients=1,4,16
+//       --command=best --requests=200 --positions=1000 --threads=8
+//
+// Each client sends one request at a time over its own connection and
+// waits for the response; the positions are taken from random games, so
+// with fewer positions than requests some come from the cache. Without
+// --socket the daemon runs in this process with the flags below, else the
+// clients talk to the daemon at --socket (whose flags then apply).
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/flags/flag.h"
+#include "open_spiel/abseil-cpp/absl/flags/parse.h"
+#include "open_spiel/abseil-cpp/absl/strings/numbers.h"
+#include "open_spiel/games/twixt/twixt.h"
+#include "open_spiel/games/twixt/twixtdaemon.h"
+#include "open_spiel/spiel.h"
+
+ABSL_FLAG(std::string, socket, "", "Socket of a running daemon.");
+ABSL_FLAG(int, board_size, 24, "Board size.");
+ABSL_FLAG(std::vector<std::string>, clients,
+          std::vector<std::string>({"1", "4", "16"}),
+          "Comma separated numbers of concurrent clients.");
+ABSL_FLAG(std::string, command, "best", "best, eval, legal or mix.");
+ABSL_FLAG(int, requests, 200, "Requests per client.");
+ABSL_FLAG(int, positions, 1000, "Number of positions asked about.");
+ABSL_FLAG(bool, compact, false, "Positions as compact encodings.");
+ABSL_FLAG(int, threads, 1, "Threads of the daemon in this process.");
+ABSL_FLAG(int, simulations, 800, "Simulations per best request.");
+ABSL_FLAG(int, rollouts, 64, "Rollouts per eval request.");
+ABSL_FLAG(int, cache_size, 1 << 16, "Results kept, 0 for no cache.");
+ABSL_FLAG(int, seed, 0, "Seed of the positions and the requests.");
+
+namespace open_spiel {
+namespace twixt {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const char* const kCommands[] = {"best", "eval", "legal"};
+
+// the requests, requests=<n> batches=<n> cache_hits=<n>, of a stats
+// response
+std::vector<int64_t> ParseStats(const std::string& response) {
+  std::vector<int64_t> counters;
+  for (const char* name : {" requests=", " batches=", " cache_hits="}) {
+    size_t start = response.find(name);
+    SPIEL_CHECK_NE(start, std::string::npos);
+    start += std::string(name).size();
+    int64_t value;
+    SPIEL_CHECK_TRUE(absl::SimpleAtoi(
+        response.substr(start, response.find(' ', start) - start), &value));
+    counters.push_back(value);
+  }
+  return counters;
+}
+
+void RunDaemonBench() {
+  std::shared_ptr<const Game> game = LoadGame(
+      "twixt",
+      {{"board_size", GameParameter(absl::GetFlag(FLAGS_board_size))}});
+  const std::string command = absl::GetFlag(FLAGS_command);
+  if (command != "best" && command != "eval" && command != "legal" &&
+      command != "mix") {
+    SpielFatalError("Unknown command: " + command);
+  }
+
+  // positions of random games that are not over, as request arguments
+  std::mt19937 rng(absl::GetFlag(FLAGS_seed));
+  std::vector<std::string> positions;
+  while (positions.size() < absl::GetFlag(FLAGS_positions)) {
+    std::unique_ptr<State> state = game->NewInitialState();
+    std::vector<Action> actions;
+    const int length = rng() % game->MaxGameLength();
+    while (actions.size() < length && !state->IsTerminal()) {
+      std::vector<Action> legal = state->LegalActions();
+      actions.push_back(legal[rng() % legal.size()]);
+      state->ApplyAction(actions.back());
+    }
+    if (state->IsTerminal()) {
+      continue;
+    }
+    std::string position;
+    if (absl::GetFlag(FLAGS_compact)) {
+      position = CompactEncoding(*game, actions);
+    } else {
+      for (Action action : actions) {
+        position += (position.empty() ? "" : ",") + std::to_string(action);
+      }
+    }
+    positions.push_back(position.empty() ? "-" : position);
+  }
+
+  std::string path = absl::GetFlag(FLAGS_socket);
+  std::unique_ptr<AnalysisDaemon> daemon;
+  std::thread daemon_thread;
+  if (path.empty()) {
+    DaemonOptions options;
+    options.num_threads = absl::GetFlag(FLAGS_threads);
+    options.num_simulations = absl::GetFlag(FLAGS_simulations);
+    options.num_rollouts = absl::GetFlag(FLAGS_rollouts);
+    options.cache_size = absl::GetFlag(FLAGS_cache_size);
+    options.prune_useless_moves = true;
+    path = "/tmp/twixt_daemon_bench." + std::to_string(getpid()) + ".sock";
+    daemon.reset(new AnalysisDaemon(game, options));
+    daemon->Listen(path);
+    daemon_thread = std::thread(&AnalysisDaemon::Serve, daemon.get());
+  }
+
+  std::printf("%8s %12s %9s %9s %9s %9s %10s %10s\n", "clients", "requests/s",
+              "mean ms", "p50 ms", "p99 ms", "max ms", "per batch",
+              "cache");
+  AnalysisClient stats_client(path);
+  for (const std::string& flag : absl::GetFlag(FLAGS_clients)) {
+    int num_clients;
+    if (!absl::SimpleAtoi(flag, &num_clients) || num_clients <= 0) {
+      SpielFatalError("Bad number of clients: " + flag);
+    }
+    const std::vector<int64_t> before =
+        ParseStats(stats_client.Request("stats"));
+    std::vector<std::vector<double>> latencies(num_clients);
+    const auto start = Clock::now();
+    std::vector<std::thread> threads;
+    for (int c = 0; c < num_clients; c++) {
+      threads.emplace_back([&, c]() {
+        AnalysisClient client(path);
+        std::mt19937 client_rng(absl::GetFlag(FLAGS_seed) * 1000003 + c);
+        for (int r = 0; r < absl::GetFlag(FLAGS_requests); r++) {
+          std::string request =
+              command == "mix" ? kCommands[client_rng() % 3] : command;
+          request += " " + positions[client_rng() % positions.size()];
+          const auto sent = Clock::now();
+          const std::string response = client.Request(request);
+          latencies[c].push_back(
+              std::chrono::duration<double, std::milli>(Clock::now() - sent)
+                  .count());
+          if (response.compare(0, 3, "ok ") != 0) {
+            SpielFatalError("Request " + request + " failed: " + response);
+          }
+        }
+      });
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+    const double seconds =
+        std::chrono::duration<double>(Clock::now() - start).count();
+    const std::vector<int64_t> after =
+        ParseStats(stats_client.Request("stats"));
+
+    std::vector<double> all;
+    for (const auto& client_latencies : latencies) {
+      all.insert(all.end(), client_latencies.begin(), client_latencies.end());
+    }
+    std::sort(all.begin(), all.end());
+    double sum = 0;
+    for (double latency : all) {
+      sum += latency;
+    }
+    // the stats request after is counted too
+    const int64_t requests = after[0] - before[0] - 1;
+    const int64_t batches = after[1] - before[1] - 1;
+    std::printf("%8d %12.1f %9.2f %9.2f %9.2f %9.2f %10.2f %9.1f%%\n",
+                num_clients, all.size() / seconds, sum / all.size(),
+                all[all.size() / 2], all[all.size() * 99 / 100], all.back(),
+                batches > 0 ? static_cast<double>(requests) / batches : 0.0,
+                100.0 * (after[2] - before[2]) / all.size());
+  }
+
+  if (daemon != nullptr) {
+    daemon->Stop();
+    daemon_thread.join();
+  }
+}
+
+}  // namespace
+}  // namespace twixt
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  open_spiel::twixt::RunDaemonBench();
+}
@@ -0,0 +1,103 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Imports TwixT game records (see twixtrecord.h for the notation) and writes
+// the valid games as action sequences, one game per line, e.g.
+//
+//   ./build/examples/twixt_import --files=games1.txt,games2.txt
+//       --board_size=24 --threads=8 --output=games.actions
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/flags/flag.h"
+#include "open_spiel/abseil-cpp/absl/flags/parse.h"
+#include "open_spiel/games/twixt/twixtrecord.h"
+#include "open_spiel/spiel.h"
+
+ABSL_FLAG(std::vector<std::string>, files, {},
+          "Comma separated files of game records.");
+ABSL_FLAG(int, board_size, 24, "Board size of records without a Size tag.");
+ABSL_FLAG(bool, rows_from_bottom, false,
+          "Row 1 is the bottom row instead of the top row.");
+ABSL_FLAG(int, threads, std::thread::hardware_concurrency(),
+          "Number of threads the files are shared out among.");
+ABSL_FLAG(std::string, output, "",
+          "File the games are written to, one line per game: the board "
+          "size followed by the actions.");
+
+namespace open_spiel {
+namespace twixt {
+namespace {
+
+void RunImport() {
+  ImportOptions options;
+  options.board_size = absl::GetFlag(FLAGS_board_size);
+  options.rows_from_bottom = absl::GetFlag(FLAGS_rows_from_bottom);
+
+  FILE* output = nullptr;
+  if (!absl::GetFlag(FLAGS_output).empty()) {
+    output = std::fopen(absl::GetFlag(FLAGS_output).c_str(), "w");
+    if (output == nullptr) {
+      SpielFatalError("Cannot write " + absl::GetFlag(FLAGS_output));
+    }
+  }
+  std::mutex output_mutex;
+  RecordCallback write_game = [&](const GameRecord& record) {
+    if (output == nullptr) {
+      return;
+    }
+    std::string line = std::to_string(record.board.size());
+    for (Action action : record.actions) {
+      line += " " + std::to_string(action);
+    }
+    line += "\n";
+    std::lock_guard<std::mutex> lock(output_mutex);
+    std::fputs(line.c_str(), output);
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  ImportStats stats = ImportFiles(absl::GetFlag(FLAGS_files), options,
+                                  absl::GetFlag(FLAGS_threads), write_game);
+  std::chrono::duration<double> seconds =
+      std::chrono::steady_clock::now() - start;
+  if (output != nullptr) {
+    std::fclose(output);
+  }
+
+  for (const std::string& error : stats.errors) {
+    std::fprintf(stderr, "%s\n", error.c_str());
+  }
+  std::printf("records %lld, games %lld, moves %lld, errors %lld\n",
+              static_cast<long long>(stats.num_records),
+              static_cast<long long>(stats.num_games),
+              static_cast<long long>(stats.num_moves),
+              static_cast<long long>(stats.num_errors));
+  std::printf("%.3f s, %.0f moves/s\n", seconds.count(),
+              stats.num_moves / std::max(seconds.count(), 1e-9));
+}
+
+}  // namespace
+}  // namespace twixt
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  open_spiel::twixt::RunImport();
+}
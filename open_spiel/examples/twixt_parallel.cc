@@ -0,0 +1,128 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Simulations per second of twixt::ParallelMctsAgent (one tree shared by
+// all threads) for each number of threads, e.g.
+//
+//   ./build/examples/twixt_parallel --board_size=24
+//       --threads=1,2,4,8,16,32,64 --simulations=20000 --positions=4
+//
+// Each thread count searches the same positions, taken every 10 plies
+// from a game of random moves. The speedup is relative to the first
+// thread count; collisions are leaves valued while another thread was
+// expanding them.
+
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/flags/flag.h"
+#include "open_spiel/abseil-cpp/absl/flags/parse.h"
+#include "open_spiel/abseil-cpp/absl/strings/numbers.h"
+#include "open_spiel/games/twixt/twixt.h"
+#include "open_spiel/games/twixt/twixtparallel.h"
+#include "open_spiel/spiel.h"
+
+ABSL_FLAG(int, board_size, 24, "Board size.");
+ABSL_FLAG(std::vector<std::string>, threads,
+          std::vector<std::string>({"1", "2", "4", "8", "16", "32", "64"}),
+          "Comma separated numbers of threads.");
+ABSL_FLAG(int, simulations, 20000, "Simulations per move.");
+ABSL_FLAG(int, positions, 4, "Number of positions searched.");
+ABSL_FLAG(int, virtual_loss, 1, "Virtual loss per thread on a path.");
+ABSL_FLAG(std::string, evaluator, "rollout",
+          "rollout: twixt::RolloutPolicy, stub: twixt::StubEvaluator.");
+ABSL_FLAG(bool, prune_useless_moves, true, "No children for useless moves.");
+ABSL_FLAG(int, seed, 0, "Seed of the positions and the searches.");
+
+namespace open_spiel {
+namespace twixt {
+namespace {
+
+const int kPliesBetweenPositions = 10;
+
+void RunParallel() {
+  std::shared_ptr<const Game> game = LoadGame(
+      "twixt",
+      {{"board_size", GameParameter(absl::GetFlag(FLAGS_board_size))}});
+  const std::string evaluator = absl::GetFlag(FLAGS_evaluator);
+  if (evaluator != "rollout" && evaluator != "stub") {
+    SpielFatalError("Unknown evaluator: " + evaluator);
+  }
+
+  std::vector<std::unique_ptr<State>> positions;
+  std::mt19937 rng(absl::GetFlag(FLAGS_seed));
+  std::unique_ptr<State> state = game->NewInitialState();
+  while (positions.size() < absl::GetFlag(FLAGS_positions) &&
+         !state->IsTerminal()) {
+    positions.push_back(state->Clone());
+    for (int ply = 0; ply < kPliesBetweenPositions && !state->IsTerminal();
+         ply++) {
+      std::vector<Action> legal = state->LegalActions();
+      state->ApplyAction(legal[rng() % legal.size()]);
+    }
+  }
+
+  std::printf("%8s %12s %8s %10s %12s %11s\n", "threads", "sims/s",
+              "speedup", "efficiency", "nodes/move", "collisions");
+  double base = 0;
+  int base_threads = 0;
+  for (const std::string& flag : absl::GetFlag(FLAGS_threads)) {
+    int num_threads;
+    if (!absl::SimpleAtoi(flag, &num_threads) || num_threads <= 0) {
+      SpielFatalError("Bad number of threads: " + flag);
+    }
+    ParallelMctsOptions options;
+    options.num_simulations = absl::GetFlag(FLAGS_simulations);
+    options.num_threads = num_threads;
+    options.virtual_loss = absl::GetFlag(FLAGS_virtual_loss);
+    options.prune_useless_moves = absl::GetFlag(FLAGS_prune_useless_moves);
+    std::vector<std::unique_ptr<StubEvaluator>> stubs;
+    std::vector<LeafEvaluator*> evaluators;
+    if (evaluator == "stub") {
+      for (int t = 0; t < num_threads; t++) {
+        stubs.emplace_back(new StubEvaluator(*game, 64, 0));
+        evaluators.push_back(stubs.back().get());
+      }
+    }
+    ParallelMctsAgent agent(*game, options, evaluators);
+    std::mt19937 search_rng(absl::GetFlag(FLAGS_seed));
+    for (const auto& position : positions) {
+      agent.Step(static_cast<const TwixTState&>(*position), &search_rng);
+    }
+
+    const ParallelSearchStats& stats = agent.stats();
+    const double rate = stats.num_simulations / stats.seconds;
+    if (base == 0) {
+      base = rate;
+      base_threads = num_threads;
+    }
+    std::printf("%8d %12.0f %7.2fx %9.1f%% %12.0f %10.2f%%\n", num_threads,
+                rate, rate / base,
+                100 * rate / base * base_threads / num_threads,
+                static_cast<double>(stats.num_nodes) / stats.num_moves,
+                100.0 * stats.num_collisions / stats.num_simulations);
+  }
+}
+
+}  // namespace
+}  // namespace twixt
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  open_spiel::twixt::RunParallel();
+}
@@ -0,0 +1,111 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Counts the TwixT move tree below a position, depth by depth, e.g.
+//
+//   ./build/examples/twixt_perft --board_size=8 --depth=4 --threads=8
+//   ./build/examples/twixt_perft --actions=19,43 --depth=3 --divide
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/flags/flag.h"
+#include "open_spiel/abseil-cpp/absl/flags/parse.h"
+#include "open_spiel/abseil-cpp/absl/strings/numbers.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_split.h"
+#include "open_spiel/games/twixt/twixt.h"
+#include "open_spiel/games/twixt/twixtperft.h"
+#include "open_spiel/spiel.h"
+
+ABSL_FLAG(int, board_size, 8, "Board size.");
+ABSL_FLAG(int, depth, 3, "Count all depths from 1 up to this one.");
+ABSL_FLAG(int, threads, std::thread::hardware_concurrency(),
+          "Number of threads the root actions are shared out among.");
+ABSL_FLAG(std::string, actions, "",
+          "Comma separated actions leading to the root position.");
+ABSL_FLAG(bool, divide, false, "Print the counts of each root action.");
+
+namespace open_spiel {
+namespace twixt {
+namespace {
+
+void PrintCounts(const std::string& label, const PerftCounts& counts) {
+  std::printf("%-8s %14llu %14llu %12llu %12llu %10llu %6llu", label.c_str(),
+              static_cast<unsigned long long>(counts.nodes),
+              static_cast<unsigned long long>(counts.leaves),
+              static_cast<unsigned long long>(counts.red_wins),
+              static_cast<unsigned long long>(counts.blue_wins),
+              static_cast<unsigned long long>(counts.draws),
+              static_cast<unsigned long long>(counts.swaps));
+}
+
+void RunPerft() {
+  GameParameters params;
+  params["board_size"] = GameParameter(absl::GetFlag(FLAGS_board_size));
+  params["ansi_color_output"] = GameParameter(false);
+  std::shared_ptr<const Game> game = LoadGame("twixt", params);
+  std::unique_ptr<State> state = game->NewInitialState();
+
+  for (absl::string_view token :
+       absl::StrSplit(absl::GetFlag(FLAGS_actions), ',', absl::SkipEmpty())) {
+    int action;
+    if (!absl::SimpleAtoi(token, &action)) {
+      SpielFatalError("Not an action: " + std::string(token));
+    }
+    state->ApplyAction(action);
+  }
+  std::printf("%s\n\n", state->ToString().c_str());
+
+  const TwixTState& twixt_state = static_cast<const TwixTState&>(*state);
+  const int num_threads = absl::GetFlag(FLAGS_threads);
+  std::printf("%-8s %14s %14s %12s %12s %10s %6s %10s %12s\n", "depth",
+              "nodes", "leaves", "x wins", "o wins", "draws", "swaps",
+              "seconds", "nodes/s");
+  for (int depth = 1; depth <= absl::GetFlag(FLAGS_depth); depth++) {
+    std::vector<std::pair<Action, PerftCounts>> divide;
+    auto start = std::chrono::steady_clock::now();
+    PerftCounts counts =
+        ParallelPerft(twixt_state.board(), state->CurrentPlayer(), depth,
+                      num_threads, &divide);
+    std::chrono::duration<double> seconds =
+        std::chrono::steady_clock::now() - start;
+
+    PrintCounts(std::to_string(depth), counts);
+    std::printf(" %10.3f %12.0f\n", seconds.count(),
+                counts.nodes / std::max(seconds.count(), 1e-9));
+
+    if (absl::GetFlag(FLAGS_divide) &&
+        depth == absl::GetFlag(FLAGS_depth)) {
+      for (const auto& entry : divide) {
+        PrintCounts(state->ActionToString(state->CurrentPlayer(),
+                                          entry.first),
+                    entry.second);
+        std::printf("\n");
+      }
+    }
+  }
+}
+
+}  // namespace
+}  // namespace twixt
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  open_spiel::twixt::RunPerft();
+}
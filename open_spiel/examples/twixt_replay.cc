@@ -0,0 +1,204 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Replays a trace of TwixT engine calls (see twixttrace.h) and reports the
+// time per call type, e.g.
+//
+//   ./build/examples/twixt_replay --trace=production.trace --repeat=5
+//
+// With --record, a synthetic trace of random games is written instead, which
+// is useful to try the replayer:
+//
+//   ./build/examples/twixt_replay --record=random.trace --games=1000
+
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/flags/flag.h"
+#include "open_spiel/abseil-cpp/absl/flags/parse.h"
+#include "open_spiel/games/twixt/twixt.h"
+#include "open_spiel/games/twixt/twixtrecord.h"
+#include "open_spiel/games/twixt/twixttrace.h"
+#include "open_spiel/spiel.h"
+
+ABSL_FLAG(std::string, trace, "", "Trace file to replay.");
+ABSL_FLAG(int, repeat, 1, "Number of times the trace is replayed.");
+ABSL_FLAG(std::string, record, "", "Trace file to record random games into.");
+ABSL_FLAG(int, games, 100, "Number of random games to record.");
+ABSL_FLAG(int, board_size, 24, "Board size of the random games.");
+
+namespace open_spiel {
+namespace twixt {
+namespace {
+
+struct OpStats {
+  int64_t calls = 0;
+  double seconds = 0;
+};
+
+// random games with a clone per move and an observation per position,
+// roughly the calls of a self-play loop
+void RecordRandomGames() {
+  GameParameters params;
+  params["board_size"] = GameParameter(absl::GetFlag(FLAGS_board_size));
+  params["ansi_color_output"] = GameParameter(false);
+  std::shared_ptr<const Game> game = LoadGame("twixt", params);
+  std::mt19937 rng(0);
+
+  TraceRecorder recorder(absl::GetFlag(FLAGS_record));
+  TraceRecorder::SetActive(&recorder);
+  std::vector<float> observation(game->ObservationTensorSize());
+  for (int i = 0; i < absl::GetFlag(FLAGS_games); i++) {
+    std::unique_ptr<State> state = game->NewInitialState();
+    while (!state->IsTerminal()) {
+      state->ObservationTensor(state->CurrentPlayer(),
+                               absl::MakeSpan(observation));
+      std::vector<Action> actions = state->LegalActions();
+      std::unique_ptr<State> child = state->Clone();
+      child->ApplyAction(actions[rng() % actions.size()]);
+      state = std::move(child);
+    }
+    state->ToString();
+  }
+  TraceRecorder::SetActive(nullptr);
+  recorder.Flush();
+  std::printf("%lld records\n",
+              static_cast<long long>(recorder.num_records()));
+}
+
+// replays the trace once, adding the time of each call to stats; returns the
+// number of calls whose result differs from the recorded one
+int64_t Replay(absl::string_view trace, std::vector<OpStats>* stats,
+               int64_t* skipped) {
+  std::map<uint64_t, std::shared_ptr<const Game>> games;
+  std::unordered_map<uint64_t, std::unique_ptr<State>> states;
+  std::vector<float> observation;
+  int64_t mismatches = 0;
+
+  TraceReader reader(trace);
+  TraceRecord record;
+  while (reader.Next(&record)) {
+    auto it = states.find(record.state_id);
+    if (record.op != kTraceNew && it == states.end()) {
+      // the state was created before recording started
+      (*skipped)++;
+      continue;
+    }
+
+    if (record.op == kTraceNew && games.count(record.arg) == 0) {
+      GameParameters params;
+      params["board_size"] = GameParameter(static_cast<int>(record.arg % 256));
+      params["ansi_color_output"] = GameParameter((record.arg & 256) != 0);
+      params["adjudicate"] = GameParameter((record.arg & 512) != 0);
+      params["link_removal"] = GameParameter((record.arg & 1024) != 0);
+      games[record.arg] = LoadGame("twixt", params);
+    }
+    if (record.op == kTraceObservationTensor) {
+      observation.resize(it->second->GetGame()->ObservationTensorSize());
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    switch (record.op) {
+    case kTraceNew:
+      states[record.state_id] = games[record.arg]->NewInitialState();
+      break;
+    case kTraceClone: {
+      auto target = states.find(record.arg);
+      if (target == states.end()) {
+        states[record.arg] = it->second->Clone();
+      } else {
+        static_cast<const TwixTState&>(*it->second)
+            .CloneInto(static_cast<TwixTState*>(target->second.get()));
+      }
+      break;
+    }
+    case kTraceApplyAction:
+      it->second->ApplyAction(record.arg);
+      break;
+    case kTraceLegalActions:
+      mismatches += it->second->LegalActions().size() != record.arg;
+      break;
+    case kTraceObservationTensor:
+      it->second->ObservationTensor(record.arg, absl::MakeSpan(observation));
+      break;
+    case kTraceToString:
+      mismatches += it->second->ToString().size() != record.arg;
+      break;
+    case kTraceDelete:
+      states.erase(it);
+      break;
+    default:
+      break;
+    }
+    std::chrono::duration<double> seconds =
+        std::chrono::steady_clock::now() - start;
+    (*stats)[record.op].calls++;
+    (*stats)[record.op].seconds += seconds.count();
+  }
+  return mismatches;
+}
+
+void ReplayTrace() {
+  MappedFile file(absl::GetFlag(FLAGS_trace));
+  if (!file.ok() || !TraceReader(file.contents()).ok()) {
+    SpielFatalError("Not a trace: " + absl::GetFlag(FLAGS_trace));
+  }
+
+  std::vector<OpStats> stats(kNumTraceOps);
+  int64_t mismatches = 0;
+  int64_t skipped = 0;
+  for (int i = 0; i < absl::GetFlag(FLAGS_repeat); i++) {
+    mismatches += Replay(file.contents(), &stats, &skipped);
+  }
+
+  std::printf("%-18s %12s %12s %10s\n", "call", "count", "ms", "ns/call");
+  double total = 0;
+  for (int op = 0; op < kNumTraceOps; op++) {
+    if (stats[op].calls > 0) {
+      std::printf("%-18s %12lld %12.1f %10.0f\n", TraceOpName(op),
+                  static_cast<long long>(stats[op].calls),
+                  stats[op].seconds * 1e3,
+                  stats[op].seconds * 1e9 / stats[op].calls);
+      total += stats[op].seconds;
+    }
+  }
+  std::printf("%-18s %12s %12.1f\n", "total", "", total * 1e3);
+  if (skipped > 0) {
+    std::printf("skipped %lld calls on states created before recording\n",
+                static_cast<long long>(skipped));
+  }
+  if (mismatches > 0) {
+    std::printf("%lld calls returned other results than recorded\n",
+                static_cast<long long>(mismatches));
+  }
+}
+
+}  // namespace
+}  // namespace twixt
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  if (!absl::GetFlag(FLAGS_record).empty()) {
+    open_spiel::twixt::RecordRandomGames();
+  } else {
+    open_spiel::twixt::ReplayTrace();
+  }
+}
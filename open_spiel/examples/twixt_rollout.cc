@@ -0,0 +1,105 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares uniform rollouts with the pattern rollouts of RolloutPolicy:
+// the time per move, the moves per rollout and the share of decided games,
+// e.g.
+//
+//   ./build/examples/twixt_rollout --sizes=8,12,24 --rollouts=2000
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/flags/flag.h"
+#include "open_spiel/abseil-cpp/absl/flags/parse.h"
+#include "open_spiel/abseil-cpp/absl/strings/numbers.h"
+#include "open_spiel/games/twixt/twixtboard.h"
+#include "open_spiel/games/twixt/twixtrollout.h"
+#include "open_spiel/spiel.h"
+
+ABSL_FLAG(std::vector<std::string>, sizes,
+          std::vector<std::string>({"8", "12", "24"}),
+          "Comma separated board sizes.");
+ABSL_FLAG(int, rollouts, 1000, "Number of rollouts per board size.");
+
+namespace open_spiel {
+namespace twixt {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+int UniformRollout(Board* board, std::mt19937* rng) {
+  const int num_cells = board->size() * board->size();
+  while (board->result() == kOpen) {
+    Player player = board->move_counter() % 2;
+    Action action;
+    do {
+      action = (*rng)() % num_cells;
+    } while (!board->IsLegalAction(player, action));
+    board->ApplyAction(player, action);
+  }
+  return board->result();
+}
+
+void PrintRow(int size, const char* policy, std::chrono::duration<double> time,
+              int64_t moves, int decided) {
+  const int rollouts = absl::GetFlag(FLAGS_rollouts);
+  std::printf("%6d %8s %10.1f %10.1f %10.1f\n", size, policy,
+              time.count() * 1e9 / moves,
+              static_cast<double>(moves) / rollouts,
+              100.0 * decided / rollouts);
+}
+
+void RunBenchmark() {
+  std::printf("%6s %8s %10s %10s %10s\n", "size", "policy", "move ns",
+              "moves", "decided %");
+  for (const std::string& flag : absl::GetFlag(FLAGS_sizes)) {
+    int size;
+    if (!absl::SimpleAtoi(flag, &size) || size < kMinBoardSize ||
+        size > kMaxBoardSize) {
+      SpielFatalError("Not a board size: " + flag);
+    }
+    const Board initial_board(size, false);
+    RolloutPolicy policy(size);
+
+    for (bool patterns : {false, true}) {
+      std::mt19937 rng(0);
+      std::chrono::duration<double> time(0);
+      int64_t moves = 0;
+      int decided = 0;
+      for (int i = 0; i < absl::GetFlag(FLAGS_rollouts); i++) {
+        Board board = initial_board;
+        auto start = Clock::now();
+        int result = patterns ? policy.Rollout(&board, &rng)
+                              : UniformRollout(&board, &rng);
+        time += Clock::now() - start;
+        moves += board.move_counter();
+        decided += result != kDraw;
+      }
+      PrintRow(size, patterns ? "pattern" : "uniform", time, moves, decided);
+    }
+  }
+}
+
+}  // namespace
+}  // namespace twixt
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  open_spiel::twixt::RunBenchmark();
+}
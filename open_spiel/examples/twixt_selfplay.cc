@@ -0,0 +1,85 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Plays self-play games with twixt::PlaySelfPlayGames and the stub model
+// and reports the batch fill rate, the latencies and the throughput, e.g.
+//
+//   ./build/examples/twixt_selfplay --board_size=12 --games=2000
+//       --games_in_flight=1024 --batch_size=256 --threads=4
+
+#include <cstdio>
+#include <memory>
+
+#include "open_spiel/abseil-cpp/absl/flags/flag.h"
+#include "open_spiel/abseil-cpp/absl/flags/parse.h"
+#include "open_spiel/games/twixt/twixtselfplay.h"
+#include "open_spiel/spiel.h"
+
+ABSL_FLAG(int, board_size, 8, "Board size.");
+ABSL_FLAG(int, games, 256, "Number of games.");
+ABSL_FLAG(int, games_in_flight, 256, "Searches that run at the same time.");
+ABSL_FLAG(int, simulations, 100, "MCTS simulations per move.");
+ABSL_FLAG(int, batch_size, 64, "Maximum leaves per evaluator call.");
+ABSL_FLAG(int, threads, 1, "Threads that advance the searches.");
+ABSL_FLAG(int, hidden, 64, "Hidden units of the stub model.");
+ABSL_FLAG(bool, compact_actions, false,
+          "Policy head over compact indices (see twixtcompact.h).");
+
+namespace open_spiel {
+namespace twixt {
+namespace {
+
+void RunSelfPlay() {
+  std::shared_ptr<const Game> game = LoadGame(
+      "twixt",
+      {{"board_size", GameParameter(absl::GetFlag(FLAGS_board_size))}});
+  StubEvaluator evaluator(*game, absl::GetFlag(FLAGS_hidden), 0,
+                          absl::GetFlag(FLAGS_compact_actions));
+  SelfPlayOptions options;
+  options.num_games = absl::GetFlag(FLAGS_games);
+  options.games_in_flight = absl::GetFlag(FLAGS_games_in_flight);
+  options.num_simulations = absl::GetFlag(FLAGS_simulations);
+  options.batch_size = absl::GetFlag(FLAGS_batch_size);
+  options.num_threads = absl::GetFlag(FLAGS_threads);
+  options.compact_actions = absl::GetFlag(FLAGS_compact_actions);
+
+  SelfPlayStats stats = PlaySelfPlayGames(game, &evaluator, options);
+  std::printf("games           %lld (red %lld, blue %lld, draws %lld)\n",
+              static_cast<long long>(stats.num_games),
+              static_cast<long long>(stats.num_results[0]),
+              static_cast<long long>(stats.num_results[1]),
+              static_cast<long long>(stats.num_results[2]));
+  std::printf("moves/game      %.1f\n",
+              static_cast<double>(stats.num_moves) / stats.num_games);
+  std::printf("evaluations     %lld in %lld batches, %lld rounds\n",
+              static_cast<long long>(stats.num_evaluations),
+              static_cast<long long>(stats.num_batches),
+              static_cast<long long>(stats.num_rounds));
+  std::printf("batch fill      %.1f%%\n",
+              100 * stats.FillRate(options.batch_size));
+  std::printf("batch latency   %.1f us\n", stats.MeanBatchSeconds() * 1e6);
+  std::printf("leaf latency    %.1f us\n", stats.MeanLeafSeconds() * 1e6);
+  std::printf("evaluator time  %.1f%%\n",
+              100 * stats.evaluation_seconds / stats.seconds);
+  std::printf("evaluations/s   %.0f\n", stats.num_evaluations / stats.seconds);
+}
+
+}  // namespace
+}  // namespace twixt
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  open_spiel::twixt::RunSelfPlay();
+}
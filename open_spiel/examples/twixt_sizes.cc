@@ -0,0 +1,97 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Plays random TwixT games on boards of several sizes and reports the time
+// per move, the time per board copy and the memory of a board, e.g.
+//
+//   ./build/examples/twixt_sizes --sizes=8,24,32,48 --games=500
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/flags/flag.h"
+#include "open_spiel/abseil-cpp/absl/flags/parse.h"
+#include "open_spiel/abseil-cpp/absl/strings/numbers.h"
+#include "open_spiel/games/twixt/twixtboard.h"
+#include "open_spiel/spiel.h"
+
+ABSL_FLAG(std::vector<std::string>, sizes,
+          std::vector<std::string>({"8", "12", "16", "24", "32", "40", "48"}),
+          "Comma separated board sizes.");
+ABSL_FLAG(int, games, 200, "Number of random games per board size.");
+
+namespace open_spiel {
+namespace twixt {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+void RunBenchmark() {
+  std::mt19937 rng(0);
+  std::printf("%6s %10s %10s %10s %10s %12s\n", "size", "moves", "moves/game",
+              "move ns", "copy ns", "board bytes");
+  for (const std::string& flag : absl::GetFlag(FLAGS_sizes)) {
+    int size;
+    if (!absl::SimpleAtoi(flag, &size) || size < kMinBoardSize ||
+        size > kMaxBoardSize) {
+      SpielFatalError("Not a board size: " + flag);
+    }
+    const Board initial_board(size, false);
+    std::chrono::duration<double> move_time(0), copy_time(0);
+    int64_t moves = 0;
+
+    for (int i = 0; i < absl::GetFlag(FLAGS_games); i++) {
+      Board board = initial_board;
+      while (board.result() == kOpen) {
+        Player player = board.move_counter() % 2;
+        Action action;
+        do {
+          action = rng() % (size * size);
+        } while (!board.IsLegalAction(player, action));
+
+        // a copy per move, as in a search that keeps the parent position
+        auto start = Clock::now();
+        Board child = board;
+        copy_time += Clock::now() - start;
+
+        start = Clock::now();
+        child.ApplyAction(player, action);
+        move_time += Clock::now() - start;
+        board = child;
+        moves++;
+      }
+    }
+
+    // the board and its cells, the columns are shared until written to
+    int64_t bytes = sizeof(Board) + size * size * sizeof(Cell);
+    std::printf("%6d %10lld %10.1f %10.1f %10.1f %12lld\n", size,
+                static_cast<long long>(moves),
+                static_cast<double>(moves) / absl::GetFlag(FLAGS_games),
+                move_time.count() * 1e9 / moves,
+                copy_time.count() * 1e9 / moves,
+                static_cast<long long>(bytes));
+  }
+}
+
+}  // namespace
+}  // namespace twixt
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  open_spiel::twixt::RunBenchmark();
+}
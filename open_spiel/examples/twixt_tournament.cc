@@ -0,0 +1,201 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Plays a round-robin tournament of local agents with
+// twixt::PlayTournament and prints their Elo ratings, e.g.
+//
+//   ./build/examples/twixt_tournament --board_size=12
+//       --agents=random,mcts:100,mcts:400,stub:400 --games=200
+//       --threads=8 --output=tournament.txt
+//
+// Agents:
+// * random: uniform legal moves
+// * mcts:N: MCTS with N simulations per move and rollouts of
+//   twixt::RolloutPolicy
+// * stub:N: MCTS with N simulations per move and the priors and values of
+//   twixt::StubEvaluator (an in-process model)
+// * time:MS: MCTS with rollouts for MS milliseconds per move (the games
+//   then depend on the speed of the machine)
+//
+// The games are written to --output as they finish, as game records that
+// twixt_import reads; the first agent has the rating 0.
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/flags/flag.h"
+#include "open_spiel/abseil-cpp/absl/flags/parse.h"
+#include "open_spiel/abseil-cpp/absl/strings/numbers.h"
+#include "open_spiel/games/twixt/twixt.h"
+#include "open_spiel/games/twixt/twixtagent.h"
+#include "open_spiel/games/twixt/twixtselfplay.h"
+#include "open_spiel/games/twixt/twixttournament.h"
+#include "open_spiel/spiel.h"
+
+ABSL_FLAG(int, board_size, 8, "Board size.");
+ABSL_FLAG(std::vector<std::string>, agents,
+          std::vector<std::string>({"random", "mcts:100", "mcts:400"}),
+          "Comma separated agents: random, mcts:N, stub:N or time:MS.");
+ABSL_FLAG(int, games, 100, "Games per pair of agents.");
+ABSL_FLAG(int, threads, std::max(1u, std::thread::hardware_concurrency()),
+          "Number of threads.");
+ABSL_FLAG(int, seed, 0, "Seed of the games.");
+ABSL_FLAG(std::string, output, "", "File for the game records, if any.");
+ABSL_FLAG(double, prior_draws, 2, "Virtual draws per pair of agents.");
+
+namespace open_spiel {
+namespace twixt {
+namespace {
+
+// an MCTS agent with its own evaluator
+class StubAgent : public Agent {
+ public:
+  StubAgent(const Game& game, const MctsOptions& options)
+      : evaluator_(game, 64, 0), agent_(game, options, &evaluator_) {}
+
+  Action Step(const TwixTState& state, std::mt19937* rng) override {
+    return agent_.Step(state, rng);
+  }
+
+ private:
+  StubEvaluator evaluator_;
+  MctsAgent agent_;
+};
+
+TournamentEntry MakeEntry(std::shared_ptr<const Game> game,
+                          const std::string& spec) {
+  if (spec == "random") {
+    return {spec, []() { return std::unique_ptr<Agent>(new RandomAgent()); }};
+  }
+  size_t colon = spec.find(':');
+  int number;
+  if (colon == std::string::npos ||
+      !absl::SimpleAtoi(spec.substr(colon + 1), &number) || number <= 0) {
+    SpielFatalError("Unknown agent: " + spec);
+  }
+  std::string kind = spec.substr(0, colon);
+  MctsOptions options;
+  options.num_simulations = number;
+  if (kind == "time") {
+    options.move_seconds = number / 1000.0;
+  }
+  if (kind == "mcts" || kind == "time") {
+    return {spec, [game, options]() {
+              return std::unique_ptr<Agent>(new MctsAgent(*game, options));
+            }};
+  } else if (kind == "stub") {
+    return {spec, [game, options]() {
+              return std::unique_ptr<Agent>(new StubAgent(*game, options));
+            }};
+  }
+  SpielFatalError("Unknown agent: " + spec);
+}
+
+const char* ResultString(int result) {
+  switch (result) {
+    case kRedWin:
+      return "1-0";
+    case kBlueWin:
+      return "0-1";
+    default:
+      return "1/2-1/2";
+  }
+}
+
+// writes played as a game record, see twixtrecord.h
+void WriteRecord(const Game& game, const std::vector<TournamentEntry>& entries,
+                 const TournamentGame& played, FILE* file) {
+  std::fprintf(file, "# game %d\n[Size \"%d\"]\n", played.game,
+               absl::GetFlag(FLAGS_board_size));
+  std::fprintf(file, "[Red \"%s\"]\n[Blue \"%s\"]\n[Result \"%s\"]\n",
+               entries[played.red].name.c_str(),
+               entries[played.blue].name.c_str(),
+               ResultString(played.result));
+  std::unique_ptr<State> state = game.NewInitialState();
+  for (int i = 0; i < played.actions.size(); i++) {
+    Action action = played.actions[i];
+    std::string move = i == 1 && action == played.actions[0]
+                           ? "swap"
+                           : state->ActionToString(state->CurrentPlayer(),
+                                                   action);
+    std::fprintf(file, "%d. %s%s", i + 1, move.c_str(),
+                 i % 10 == 9 || i + 1 == played.actions.size() ? "\n" : " ");
+    state->ApplyAction(action);
+  }
+  std::fprintf(file, "\n");
+  std::fflush(file);
+}
+
+void RunTournament() {
+  std::shared_ptr<const Game> game = LoadGame(
+      "twixt",
+      {{"board_size", GameParameter(absl::GetFlag(FLAGS_board_size))},
+       {"ansi_color_output", GameParameter(false)}});
+  std::vector<TournamentEntry> entries;
+  for (const std::string& spec : absl::GetFlag(FLAGS_agents)) {
+    entries.push_back(MakeEntry(game, spec));
+  }
+  FILE* file = nullptr;
+  const std::string output = absl::GetFlag(FLAGS_output);
+  if (!output.empty()) {
+    file = std::fopen(output.c_str(), "w");
+    if (file == nullptr) {
+      SpielFatalError("Cannot write " + output);
+    }
+  }
+
+  TournamentOptions options;
+  options.games_per_pairing = absl::GetFlag(FLAGS_games);
+  options.num_threads = absl::GetFlag(FLAGS_threads);
+  options.seed = absl::GetFlag(FLAGS_seed);
+  std::vector<TournamentGame> games = PlayTournament(
+      game, entries, options, [&](const TournamentGame& played) {
+        if (file != nullptr) {
+          WriteRecord(*game, entries, played, file);
+        }
+      });
+  if (file != nullptr) {
+    std::fclose(file);
+  }
+
+  std::vector<Rating> ratings = ComputeRatings(
+      entries.size(), games, absl::GetFlag(FLAGS_prior_draws));
+  std::vector<int> order(entries.size());
+  for (int i = 0; i < order.size(); i++) {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+    return ratings[a].elo > ratings[b].elo;
+  });
+  std::printf("%-20s %8s %8s %8s %8s\n", "agent", "games", "score", "elo",
+              "+/-");
+  for (int i : order) {
+    std::printf("%-20s %8d %7.1f%% %8.0f %8.0f\n", entries[i].name.c_str(),
+                ratings[i].games, 100 * ratings[i].score / ratings[i].games,
+                ratings[i].elo, ratings[i].margin);
+  }
+}
+
+}  // namespace
+}  // namespace twixt
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  open_spiel::twixt::RunTournament();
+}
@@ -0,0 +1,315 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Plays seeded TwixT games on several board sizes and writes statistics of
+// the workload as CSV or JSON, one record per board size: game length,
+// branching factor (legal moves of the player to move, per ply, and the
+// legal moves that are not useless, see Board::IsUselessMove), swap,
+// win and draw rates, ExploreLocalGraph runs and blocked links (see
+// twixt::BoardCounters) and time per move, with percentiles, e.g.
+//
+//   ./build/examples/twixt_workload --sizes=5,8,12,16,24 --games=10000
+//       --threads=8 --policy=rollout --format=json
+//
+// Game i of a size is seeded with --seed, the size and i, so the numbers
+// other than the times do not depend on --threads. The time per move
+// includes reading the clock (some 20 ns).
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/flags/flag.h"
+#include "open_spiel/abseil-cpp/absl/flags/parse.h"
+#include "open_spiel/abseil-cpp/absl/strings/numbers.h"
+#include "open_spiel/games/twixt/twixtboard.h"
+#include "open_spiel/games/twixt/twixtrollout.h"
+#include "open_spiel/spiel.h"
+
+ABSL_FLAG(std::vector<std::string>, sizes,
+          std::vector<std::string>({"5", "6", "7", "8", "9", "10", "11",
+                                    "12", "13", "14", "15", "16", "17", "18",
+                                    "19", "20", "21", "22", "23", "24"}),
+          "Comma separated board sizes.");
+ABSL_FLAG(int, games, 1000, "Number of games per board size.");
+ABSL_FLAG(int, threads, 1, "Number of threads.");
+ABSL_FLAG(int, seed, 0, "Seed of the games.");
+ABSL_FLAG(std::string, policy, "random",
+          "random: uniform moves, rollout: twixt::RolloutPolicy.");
+ABSL_FLAG(std::string, format, "csv", "csv or json.");
+
+namespace open_spiel {
+namespace twixt {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const int kMaxMoveNanos = 100000;
+
+// counts of non-negative samples; larger samples count as the largest
+class Histogram {
+ public:
+  explicit Histogram(int max_value) : counts_(max_value + 1) {}
+
+  void Add(int64_t value) {
+    counts_[std::min<int64_t>(value, counts_.size() - 1)]++;
+    sum_ += value;
+    num_samples_++;
+  }
+
+  void Merge(const Histogram& other) {
+    for (int i = 0; i < counts_.size(); i++) {
+      counts_[i] += other.counts_[i];
+    }
+    sum_ += other.sum_;
+    num_samples_ += other.num_samples_;
+  }
+
+  double Mean() const {
+    return num_samples_ > 0 ? static_cast<double>(sum_) / num_samples_ : 0;
+  }
+
+  // the smallest value that at least fraction of the samples do not exceed
+  int Percentile(double fraction) const {
+    int64_t count = 0;
+    for (int value = 0; value < counts_.size(); value++) {
+      count += counts_[value];
+      if (count > 0 && count >= fraction * num_samples_) {
+        return value;
+      }
+    }
+    return counts_.size() - 1;
+  }
+
+ private:
+  std::vector<int64_t> counts_;
+  int64_t sum_ = 0;
+  int64_t num_samples_ = 0;
+};
+
+struct SizeStats {
+  explicit SizeStats(int size)
+      : lengths(size * size), branching(size * size),
+        live_branching(size * size), move_nanos(kMaxMoveNanos) {}
+
+  void Merge(const SizeStats& other) {
+    lengths.Merge(other.lengths);
+    branching.Merge(other.branching);
+    live_branching.Merge(other.live_branching);
+    move_nanos.Merge(other.move_nanos);
+    num_games += other.num_games;
+    num_moves += other.num_moves;
+    num_swaps += other.num_swaps;
+    for (int i = 0; i < 3; i++) {
+      num_results[i] += other.num_results[i];
+    }
+    counters.links += other.counters.links;
+    counters.blocked_links += other.counters.blocked_links;
+    counters.explorations += other.counters.explorations;
+    counters.explored_cells += other.counters.explored_cells;
+  }
+
+  Histogram lengths;
+  Histogram branching;
+  Histogram live_branching;
+  Histogram move_nanos;
+  int64_t num_games = 0;
+  int64_t num_moves = 0;
+  int64_t num_swaps = 0;
+  int64_t num_results[3] = {0, 0, 0};  // red wins, blue wins, draws
+  BoardCounters counters;
+};
+
+// plays game number game and adds it to stats
+void PlayGame(int size, int game, RolloutPolicy* policy, SizeStats* stats) {
+  std::seed_seq seed{absl::GetFlag(FLAGS_seed), size, game};
+  std::mt19937 rng(seed);
+  std::vector<Action> actions;
+  if (policy != nullptr) {
+    Board board(size, false);
+    policy->Rollout(&board, &rng, &actions);
+  }
+
+  // the moves of a rollout are replayed to measure them
+  GetBoardCounters() = BoardCounters();
+  Board board(size, false);
+  for (int ply = 0; board.result() == kOpen; ply++) {
+    Player player = board.move_counter() % 2;
+    stats->branching.Add(board.num_legal_actions(player));
+    stats->live_branching.Add(board.GetLiveLegalActions(player).size());
+    Action action;
+    if (policy != nullptr) {
+      action = actions[ply];
+    } else {
+      do {
+        action = rng() % (size * size);
+      } while (!board.IsLegalAction(player, action));
+    }
+    auto start = Clock::now();
+    board.ApplyAction(player, action);
+    stats->move_nanos.Add(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                             start)
+            .count());
+  }
+
+  const BoardCounters& counters = GetBoardCounters();
+  stats->counters.links += counters.links;
+  stats->counters.blocked_links += counters.blocked_links;
+  stats->counters.explorations += counters.explorations;
+  stats->counters.explored_cells += counters.explored_cells;
+  stats->lengths.Add(board.move_counter());
+  stats->num_games++;
+  stats->num_moves += board.move_counter();
+  stats->num_swaps += board.swapped();
+  stats->num_results[board.result() - kRedWin]++;
+}
+
+SizeStats AnalyzeSize(int size) {
+  const int num_games = absl::GetFlag(FLAGS_games);
+  const bool rollouts = absl::GetFlag(FLAGS_policy) == "rollout";
+  const int num_threads =
+      std::max(1, std::min(absl::GetFlag(FLAGS_threads), num_games));
+  std::vector<SizeStats> thread_stats(num_threads, SizeStats(size));
+
+  // each thread takes the next unplayed game until none are left
+  std::atomic<int> next_game(0);
+  auto worker = [&](int thread) {
+    std::unique_ptr<RolloutPolicy> policy;
+    if (rollouts) {
+      policy.reset(new RolloutPolicy(size));
+    }
+    for (int game = next_game++; game < num_games; game = next_game++) {
+      PlayGame(size, game, policy.get(), &thread_stats[thread]);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int t = 1; t < num_threads; t++) {
+    threads.emplace_back(worker, t);
+  }
+  worker(0);
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  SizeStats stats(size);
+  for (const SizeStats& from : thread_stats) {
+    stats.Merge(from);
+  }
+  return stats;
+}
+
+double Ratio(int64_t a, int64_t b) {
+  return b > 0 ? static_cast<double>(a) / b : 0;
+}
+
+// the fields of the record of a board size, in output order
+std::vector<std::pair<std::string, double>> Record(int size,
+                                                   const SizeStats& stats) {
+  std::vector<std::pair<std::string, double>> record = {{"size", size}};
+  auto add_histogram = [&record](const std::string& name,
+                                 const Histogram& histogram) {
+    record.push_back({name + "_mean", histogram.Mean()});
+    for (int percent : {50, 90, 99}) {
+      record.push_back({name + "_p" + std::to_string(percent),
+                        histogram.Percentile(percent / 100.0)});
+    }
+  };
+  const int64_t num_moves = stats.num_moves;
+  const BoardCounters& counters = stats.counters;
+  record.push_back({"games", stats.num_games});
+  add_histogram("length", stats.lengths);
+  add_histogram("branching", stats.branching);
+  add_histogram("live_branching", stats.live_branching);
+  record.push_back({"swap_rate", Ratio(stats.num_swaps, stats.num_games)});
+  record.push_back({"red_win_rate",
+                    Ratio(stats.num_results[0], stats.num_games)});
+  record.push_back({"blue_win_rate",
+                    Ratio(stats.num_results[1], stats.num_games)});
+  record.push_back({"draw_rate", Ratio(stats.num_results[2], stats.num_games)});
+  record.push_back({"explorations_per_move",
+                    Ratio(counters.explorations, num_moves)});
+  record.push_back({"cells_per_exploration",
+                    Ratio(counters.explored_cells, counters.explorations)});
+  record.push_back({"links_per_move", Ratio(counters.links, num_moves)});
+  record.push_back({"blocked_link_rate",
+                    Ratio(counters.blocked_links,
+                          counters.links + counters.blocked_links)});
+  add_histogram("move_ns", stats.move_nanos);
+  return record;
+}
+
+void RunAnalysis() {
+  const std::string format = absl::GetFlag(FLAGS_format);
+  if (format != "csv" && format != "json") {
+    SpielFatalError("Unknown format: " + format);
+  }
+  const std::string policy = absl::GetFlag(FLAGS_policy);
+  if (policy != "random" && policy != "rollout") {
+    SpielFatalError("Unknown policy: " + policy);
+  }
+
+  std::vector<std::string> flags = absl::GetFlag(FLAGS_sizes);
+  if (format == "json") {
+    std::printf("[\n");
+  }
+  for (int i = 0; i < flags.size(); i++) {
+    int size;
+    if (!absl::SimpleAtoi(flags[i], &size) || size < kMinBoardSize ||
+        size > kMaxBoardSize) {
+      SpielFatalError("Not a board size: " + flags[i]);
+    }
+    std::vector<std::pair<std::string, double>> record =
+        Record(size, AnalyzeSize(size));
+    if (format == "csv") {
+      if (i == 0) {
+        for (int f = 0; f < record.size(); f++) {
+          std::printf("%s%s", f > 0 ? "," : "", record[f].first.c_str());
+        }
+        std::printf("\n");
+      }
+      for (int f = 0; f < record.size(); f++) {
+        std::printf("%s%.10g", f > 0 ? "," : "", record[f].second);
+      }
+      std::printf("\n");
+    } else {
+      std::printf("  {");
+      for (int f = 0; f < record.size(); f++) {
+        std::printf("%s\"%s\": %.10g", f > 0 ? ", " : "",
+                    record[f].first.c_str(), record[f].second);
+      }
+      std::printf("}%s\n", i + 1 < flags.size() ? "," : "");
+    }
+    std::fflush(stdout);
+  }
+  if (format == "json") {
+    std::printf("]\n");
+  }
+}
+
+}  // namespace
+}  // namespace twixt
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  open_spiel::twixt::RunAnalysis();
+}
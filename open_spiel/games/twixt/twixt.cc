@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <map>
 #include <memory>
@@ -43,12 +44,14 @@ const GameType kGameType{
     /*max_num_players=*/2,
     /*min_num_players=*/2,
     /*provides_information_state_string=*/true,
-    /*provides_information_state_tensor=*/false,
+    /*provides_information_state_tensor=*/true,
     /*provides_observation_string=*/true,
     /*provides_observation_tensor=*/true,
     /*parameter_specification=*/
     {{"board_size", GameParameter(kDefaultBoardSize)},
-     {"ansi_color_output", GameParameter(kDefaultAnsiColorOutput)}},
+     {"ansi_color_output", GameParameter(kDefaultAnsiColorOutput)},
+     {"adjudicate", GameParameter(kDefaultAdjudicate)},
+     {"link_removal", GameParameter(kDefaultLinkRemoval)}},
 };
 
 std::unique_ptr<Game> Factory(const GameParameters &params) {
@@ -57,52 +60,89 @@ std::unique_ptr<Game> Factory(const GameParameters &params) {
 
 REGISTER_SPIEL_GAME(kGameType, Factory);
 
+// IEEE 754 half precision
+const uint16_t kHalfZero = 0x0000;
+const uint16_t kHalfOne = 0x3c00;
+
+float HalfToFloat(uint16_t half) {
+  uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+  uint32_t exponent = (half >> 10) & 0x1f;
+  uint32_t mantissa = half & 0x3ff;
+  uint32_t bits;
+  if (exponent == 0x1f) {
+    // inf, nan
+    bits = sign | 0x7f800000 | (mantissa << 13);
+  } else if (exponent != 0) {
+    // normal: rebias the exponent from 15 to 127
+    bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+  } else if (mantissa == 0) {
+    bits = sign;
+  } else {
+    // subnormal: shift the mantissa until it is normal
+    exponent = 113;
+    while ((mantissa & 0x400) == 0) {
+      mantissa <<= 1;
+      exponent--;
+    }
+    bits = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+  }
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
 }  // namespace
 
 TwixTState::TwixTState(std::shared_ptr<const Game> game) : State(game) {
   const TwixTGame &parent_game = static_cast<const TwixTGame &>(*game);
-  board_ = Board(parent_game.board_size(), parent_game.ansi_color_output());
+  board_ = Board(parent_game.board_size(), parent_game.ansi_color_output(),
+                 parent_game.adjudicate(), parent_game.link_removal());
+  trace_id_.Record(kTraceNew, parent_game.board_size() +
+                                  256 * parent_game.ansi_color_output() +
+                                  512 * parent_game.adjudicate() +
+                                  1024 * parent_game.link_removal());
 }
 
 std::string TwixTState::ActionToString(open_spiel::Player player,
                                        Action action) const {
-  Position position = board_.ActionToPosition(action);
   std::string s = (player == kRedPlayer) ? "x" : "o";
-  s += static_cast<int>('a') + position.x;
-  s.append(std::to_string(board_.size() - position.y));
+  auto append_position = [&](Position position) {
+    s.append(ColumnLabel(position.x));
+    s.append(std::to_string(board_.size() - position.y));
+  };
+  if (board_.IsLinkRemoval(action)) {
+    // the removal of a link, e.g. xc5-d3
+    Link link = board_.ActionToLink(action);
+    append_position(link.position);
+    s.append("-");
+    append_position(link.position +
+                    GetLinkDescriptor(link.direction).offsets);
+  } else {
+    append_position(board_.ActionToPosition(action));
+  }
   return s;
 }
 
-void TwixTState::SetPegAndLinksOnTensor(absl::Span<float> values,
-                                        const Cell& cell, int offset, bool turn,
-                                        Position position) const {
-  TensorView<3> view(
-      values, {kNumPlanes, board_.size(), board_.size() - 2}, false);
-  Position tensorPosition = board_.GetTensorPosition(position, turn);
-
-  if (cell.HasLinks()) {
-    for (int dir = 0; dir < 4; dir++) {
-      if (cell.HasLink(dir)) {
-        // peg has link in direction dir: set 1.0 on plane 1..4 / 8..11
-        view[{offset + 1 + dir, tensorPosition.x, tensorPosition.y}] = 1.0;
-      }
-    }
-  } else {
-    // peg has no links: set 1.0 on plane 0 / 6
-    view[{offset + 0, tensorPosition.x, tensorPosition.y}] = 1.0;
+void TwixTState::CloneInto(TwixTState* target) const {
+  SPIEL_CHECK_TRUE(target->game_ == game_);
+  if (target == this) {
+    return;
   }
-
-  // peg has blocked neighbors: set 1.0 on plane 5 / 11
-  if (cell.HasBlockedNeighborsEast()) {
-    view[{offset + 5, tensorPosition.x, tensorPosition.y}] = 1.0;
+  target->board_ = board_;
+  target->trace_id_ = trace_id_;  // recorded as a clone into target
+  target->current_player_ = current_player_;
+  // a target is usually cloned into again and again, so its history gets
+  // room for the longest game once, instead of growing with longer games
+  const int max_game_length = game_->MaxGameLength();
+  if (target->history_.capacity() < max_game_length) {
+    target->history_.reserve(max_game_length);
   }
+  target->history_ = history_;
+  target->move_number_ = move_number_;
 }
 
-void TwixTState::ObservationTensor(open_spiel::Player player,
-                                   absl::Span<float> values) const {
-  SPIEL_CHECK_GE(player, 0);
-  SPIEL_CHECK_LT(player, kNumPlayers);
-
+template <typename Setter>
+void TwixTState::VisitObservationEntries(Setter set) const {
   const int kPlaneOffset[2] = {0, kNumPlanes/2};
   int size = board_.size();
 
@@ -112,29 +152,191 @@ void TwixTState::ObservationTensor(open_spiel::Player player,
   // plane 1..4 / 7..10 is for the links NNE, ENE, ESE, SSE, resp.
   // plane 5/11 is pegs that have blocked neighbors
 
-  TensorView<3> view(
-      values, {kNumPlanes, board_.size(), board_.size() - 2}, true);
-
   for (int c = 0; c < size; c++) {
-    for (int r = 0; r < size; r++) {
-      Position position = {c, r};
+    // only visit the cells that have a peg
+    for (uint64_t rows = board_.GetPegRows(c); rows != 0; rows &= rows - 1) {
+      Position position = {c, __builtin_ctzll(rows)};
       const Cell& cell = board_.GetConstCell(position);
       int color = cell.color();
-      if (color == kRedColor) {
-        // no turn
-        SetPegAndLinksOnTensor(values, cell, kPlaneOffset[0], false, position);
-      } else if (color == kBlueColor) {
-        // 90 degr turn
-        SetPegAndLinksOnTensor(values, cell, kPlaneOffset[1], true, position);
+      // red: no turn, blue: 90 degr turn
+      int offset = kPlaneOffset[color];
+      Position tensorPosition =
+          board_.GetTensorPosition(position, color == kBlueColor);
+
+      if (cell.HasLinks()) {
+        for (int dir = 0; dir < 4; dir++) {
+          if (cell.HasLink(dir)) {
+            // peg has link in direction dir: set 1.0 on plane 1..4 / 7..10
+            set(offset + 1 + dir, tensorPosition.x, tensorPosition.y);
+          }
+        }
+      } else {
+        // peg has no links: set 1.0 on plane 0 / 6
+        set(offset + 0, tensorPosition.x, tensorPosition.y);
       }
+
+      // peg has blocked neighbors: set 1.0 on plane 5 / 11
+      if (cell.HasBlockedNeighborsEast()) {
+        set(offset + 5, tensorPosition.x, tensorPosition.y);
+      }
+    }
+  }
+}
+
+void TwixTState::ObservationTensor(open_spiel::Player player,
+                                   absl::Span<float> values) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, kNumPlayers);
+  trace_id_.Record(kTraceObservationTensor, player);
+
+  TensorView<3> view(
+      values, {kNumPlanes, board_.size(), board_.size() - 2}, true);
+  VisitObservationEntries([&view](int plane, int x, int y) {
+    view[{plane, x, y}] = 1.0;
+  });
+}
+
+void TwixTState::InformationStateTensor(open_spiel::Player player,
+                                        absl::Span<float> values) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, kNumPlayers);
+  int size = board_.size();
+
+  // planes 0..11 are the planes of the observation tensor
+  // plane 12 is all 1.0 if player 1 has swapped
+  // plane 13 is all 1.0 if player 1 is to move
+  TensorView<3> view(
+      values, {kNumInformationStatePlanes, size, size - 2}, true);
+  VisitObservationEntries([&view](int plane, int x, int y) {
+    view[{plane, x, y}] = 1.0;
+  });
+
+  const int plane_size = size * (size - 2);
+  if (board_.swapped()) {
+    std::fill_n(&values[kNumPlanes * plane_size], plane_size, 1.0);
+  }
+  if (current_player_ == kBluePlayer) {
+    std::fill_n(&values[(kNumPlanes + 1) * plane_size], plane_size, 1.0);
+  }
+}
+
+void TwixTState::ObservationTensorBits(open_spiel::Player player,
+                                       absl::Span<uint64_t> words) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, kNumPlayers);
+  int size = board_.size();
+  SPIEL_CHECK_EQ(static_cast<int>(words.size()), ObservationBitsSize(size));
+
+  const int words_per_row = (size - 2 + 63) / 64;
+  std::fill(words.begin(), words.end(), 0);
+  VisitObservationEntries([&](int plane, int x, int y) {
+    words[(plane * size + x) * words_per_row + y / 64] |= 1ULL << (y % 64);
+  });
+}
+
+void TwixTState::ObservationTensorUint8(open_spiel::Player player,
+                                        absl::Span<uint8_t> values) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, kNumPlayers);
+  int size = board_.size();
+  SPIEL_CHECK_EQ(static_cast<int>(values.size()),
+                 kNumPlanes * size * (size - 2));
+
+  std::fill(values.begin(), values.end(), 0);
+  VisitObservationEntries([&](int plane, int x, int y) {
+    values[(plane * size + x) * (size - 2) + y] = 1;
+  });
+}
+
+void TwixTState::ObservationTensorHalf(open_spiel::Player player,
+                                       absl::Span<uint16_t> values) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, kNumPlayers);
+  int size = board_.size();
+  SPIEL_CHECK_EQ(static_cast<int>(values.size()),
+                 kNumPlanes * size * (size - 2));
+
+  std::fill(values.begin(), values.end(), kHalfZero);
+  VisitObservationEntries([&](int plane, int x, int y) {
+    values[(plane * size + x) * (size - 2) + y] = kHalfOne;
+  });
+}
+
+void TwixTState::SparseObservationTensor(open_spiel::Player player,
+                                         std::vector<int>* indices) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, kNumPlayers);
+  int size = board_.size();
+
+  VisitObservationEntries([&](int plane, int x, int y) {
+    indices->push_back((plane * size + x) * (size - 2) + y);
+  });
+}
+
+int ObservationBitsSize(int board_size) {
+  return kNumPlanes * board_size * ((board_size - 2 + 63) / 64);
+}
+
+void UnpackObservationBits(int board_size, absl::Span<const uint64_t> words,
+                           absl::Span<float> values) {
+  const int row_size = board_size - 2;
+  const int words_per_row = (row_size + 63) / 64;
+  SPIEL_CHECK_EQ(static_cast<int>(words.size()),
+                 ObservationBitsSize(board_size));
+  SPIEL_CHECK_EQ(static_cast<int>(values.size()),
+                 kNumPlanes * board_size * row_size);
+
+  float* out = values.data();
+  for (int row = 0; row < kNumPlanes * board_size; row++) {
+    const uint64_t* in = &words[row * words_per_row];
+    for (int y = 0; y < row_size; y++) {
+      *out++ = (in[y / 64] >> (y % 64)) & 1;
     }
   }
 }
 
+void DensifyObservations(int board_size, absl::Span<const int> indices,
+                         absl::Span<const int> offsets,
+                         absl::Span<float> values) {
+  const int tensor_size = kNumPlanes * board_size * (board_size - 2);
+  const int batch_size = static_cast<int>(offsets.size()) - 1;
+  SPIEL_CHECK_GE(batch_size, 0);
+  SPIEL_CHECK_EQ(static_cast<int>(values.size()), batch_size * tensor_size);
+  SPIEL_CHECK_EQ(offsets[batch_size], static_cast<int>(indices.size()));
+
+  std::fill(values.begin(), values.end(), 0.0);
+  for (int b = 0; b < batch_size; b++) {
+    float* tensor = &values[b * tensor_size];
+    for (int i = offsets[b]; i < offsets[b + 1]; i++) {
+      SPIEL_CHECK_LT(indices[i], tensor_size);
+      tensor[indices[i]] = 1.0;
+    }
+  }
+}
+
+void UnpackObservationUint8(absl::Span<const uint8_t> bytes,
+                            absl::Span<float> values) {
+  SPIEL_CHECK_EQ(bytes.size(), values.size());
+  for (size_t i = 0; i < bytes.size(); i++) {
+    values[i] = bytes[i];
+  }
+}
+
+void UnpackObservationHalf(absl::Span<const uint16_t> halfs,
+                           absl::Span<float> values) {
+  SPIEL_CHECK_EQ(halfs.size(), values.size());
+  for (size_t i = 0; i < halfs.size(); i++) {
+    values[i] = HalfToFloat(halfs[i]);
+  }
+}
+
 TwixTGame::TwixTGame(const GameParameters &params)
     : Game(kGameType, params),
       ansi_color_output_(
           ParameterValue<bool>("ansi_color_output", kDefaultAnsiColorOutput)),
+      adjudicate_(ParameterValue<bool>("adjudicate", kDefaultAdjudicate)),
+      link_removal_(
+          ParameterValue<bool>("link_removal", kDefaultLinkRemoval)),
       board_size_(ParameterValue<int>("board_size", kDefaultBoardSize)) {
   if (board_size_ < kMinBoardSize || board_size_ > kMaxBoardSize) {
     SpielFatalError("board_size out of range [" +
@@ -142,6 +344,10 @@ TwixTGame::TwixTGame(const GameParameters &params)
                     std::to_string(kMaxBoardSize) +
                     "]: " + std::to_string(board_size_));
   }
+  // an unbreakable connection could be broken by removing links
+  if (adjudicate_ && link_removal_) {
+    SpielFatalError("adjudicate cannot be combined with link_removal");
+  }
 }
 
 }  // namespace twixt
@@ -15,6 +15,7 @@
 #ifndef OPEN_SPIEL_GAMES_TWIXT_TWIXT_H_
 #define OPEN_SPIEL_GAMES_TWIXT_TWIXT_H_
 
+#include <cstdint>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -22,6 +23,7 @@
 
 #include "open_spiel/games/twixt/twixtboard.h"
 #include "open_spiel/games/twixt/twixtcell.h"
+#include "open_spiel/games/twixt/twixttrace.h"
 
 // https://en.wikipedia.org/wiki/TwixT
 
@@ -40,7 +42,11 @@ class TwixTState : public State {
   std::string ActionToString(open_spiel::Player player,
                              Action action) const override;
 
-  std::string ToString() const override { return board_.ToString(); };
+  std::string ToString() const override {
+    std::string s = board_.ToString();
+    trace_id_.Record(kTraceToString, s.size());
+    return s;
+  };
 
   bool IsTerminal() const override {
     int result = board_.result();
@@ -77,38 +83,98 @@ class TwixTState : public State {
   void ObservationTensor(open_spiel::Player player,
                          absl::Span<float> values) const override;
 
+  void InformationStateTensor(open_spiel::Player player,
+                              absl::Span<float> values) const override;
+
+  // the observation tensor in compact formats, with the same entries:
+  // * bits: one bit per entry, each row (last dimension) of each plane
+  //   starts a new 64-bit word, see ObservationBitsSize
+  // * uint8: one byte per entry, 0 or 1
+  // * half: one IEEE fp16 per entry, 0.0 or 1.0
+  void ObservationTensorBits(open_spiel::Player player,
+                             absl::Span<uint64_t> words) const;
+  void ObservationTensorUint8(open_spiel::Player player,
+                              absl::Span<uint8_t> values) const;
+  void ObservationTensorHalf(open_spiel::Player player,
+                             absl::Span<uint16_t> values) const;
+
+  // appends to indices the flat index (plane * size + x) * (size - 2) + y
+  // of each entry (plane, x, y) of the observation tensor that is 1.0;
+  // the work is proportional to the number of pegs on the board
+  void SparseObservationTensor(open_spiel::Player player,
+                               std::vector<int>* indices) const;
+
   std::unique_ptr<State> Clone() const override {
     return std::unique_ptr<State>(new TwixTState(*this));
   };
 
+  // copies this state into target (a state of the same game), reusing the
+  // buffers target already has instead of allocating new ones
+  //
+  // After a warmup, i.e. once target and the buffers have seen a few
+  // games, CloneInto, ApplyAction, LegalActions(actions) and
+  // ObservationTensor do not allocate (twixt_test checks this); the first
+  // CloneInto gives target the history of the longest game. The
+  // exceptions are the adjudicate parameter and the string methods.
+  void CloneInto(TwixTState* target) const;
+
   void UndoAction(open_spiel::Player, Action) override{};
 
   std::vector<Action> LegalActions() const override {
-    if (IsTerminal())
+    if (IsTerminal()) {
+      trace_id_.Record(kTraceLegalActions, 0);
       return {};
-    return board_.GetLegalActions(current_player_);
+    }
+    std::vector<Action> actions = board_.GetLegalActions(current_player_);
+    trace_id_.Record(kTraceLegalActions, actions.size());
+    return actions;
   };
 
+  // the same into actions, which keeps its capacity
+  void LegalActions(std::vector<Action>* actions) const {
+    if (IsTerminal()) {
+      actions->clear();
+    } else {
+      board_.GetLegalActions(current_player_, actions);
+    }
+    trace_id_.Record(kTraceLegalActions, actions->size());
+  }
+
+  // LegalActions without the useless moves, see Board::GetLiveLegalActions
+  std::vector<Action> LiveLegalActions() const {
+    if (IsTerminal()) {
+      return {};
+    }
+    return board_.GetLiveLegalActions(current_player_);
+  }
+
+  const Board& board() const { return board_; }
+
  protected:
   void DoApplyAction(Action action) override {
-    const std::vector<Action>& v = LegalActions();
-    if (std::find(v.begin(), v.end(), action) == v.end()) {
+    if (IsTerminal() || !board_.IsLegalAction(current_player_, action)) {
       SpielFatalError("Not a legal action: " + std::to_string(action));
     }
+    trace_id_.Record(kTraceApplyAction, action);
     board_.ApplyAction(CurrentPlayer(), action);
-    if (board_.result() == kOpen) {
-      set_current_player(1 - CurrentPlayer());
-    } else {
+    if (board_.result() != kOpen) {
       set_current_player(kTerminalPlayerId);
+    } else if (!board_.IsLinkRemoval(action)) {
+      // the turn ends with a peg, not with the removal of a link
+      set_current_player(1 - CurrentPlayer());
     }
   };
 
  private:
   Player current_player_ = kRedPlayer;
   Board board_;
+  // identity in the active trace, see twixttrace.h
+  TraceId trace_id_;
   void set_current_player(Player player) { current_player_ = player; }
-  void SetPegAndLinksOnTensor(absl::Span<float>, const Cell&, int, bool,
-                              Position) const;
+  // calls set(plane, x, y) for every entry of the observation tensor
+  // that is 1.0; all other entries are 0.0
+  template <typename Setter>
+  void VisitObservationEntries(Setter set) const;
 };
 
 class TwixTGame : public Game {
@@ -120,7 +186,9 @@ class TwixTGame : public Game {
   };
 
   int NumDistinctActions() const override {
-    return board_size_ * board_size_;
+    // the pegs, then the link removals
+    return board_size_ * board_size_ *
+           (link_removal_ ? kLinkSlotsPerCell + 1 : 1);
   };
 
   int NumPlayers() const override { return kNumPlayers; };
@@ -128,23 +196,50 @@ class TwixTGame : public Game {
   absl::optional<double> UtilitySum() const override { return 0.0; };
   double MaxUtility() const override { return 1.0; };
 
+  std::vector<int> InformationStateTensorShape() const override {
+    return {kNumInformationStatePlanes, board_size_, board_size_ - 2};
+  }
+
   std::vector<int> ObservationTensorShape() const override {
-    static std::vector<int> shape{kNumPlanes, board_size_, board_size_ - 2};
-    return shape;
+    return {kNumPlanes, board_size_, board_size_ - 2};
   }
 
   int MaxGameLength() const {
-    // square - 4 corners + swap move
-    return board_size_ * board_size_ - 4 + 1;
+    // square - 4 corners + swap move; a link slot is linked at most once,
+    // so each can be removed at most once
+    return board_size_ * board_size_ - 4 + 1 +
+           (link_removal_ ? kLinkSlotsPerCell * board_size_ * board_size_
+                          : 0);
   }
   bool ansi_color_output() const { return ansi_color_output_; }
+  bool adjudicate() const { return adjudicate_; }
+  bool link_removal() const { return link_removal_; }
   int board_size() const { return board_size_; }
 
  private:
   bool ansi_color_output_;
+  bool adjudicate_;
+  bool link_removal_;
   int board_size_;
 };
 
+// number of 64-bit words of ObservationTensorBits
+int ObservationBitsSize(int board_size);
+
+// expand the compact observation formats to the float tensor
+void UnpackObservationBits(int board_size, absl::Span<const uint64_t> words,
+                           absl::Span<float> values);
+// writes the dense tensors of a batch of sparse observations: the indices
+// of position b are indices[offsets[b]..offsets[b+1]), values holds
+// offsets.size() - 1 tensors
+void DensifyObservations(int board_size, absl::Span<const int> indices,
+                         absl::Span<const int> offsets,
+                         absl::Span<float> values);
+void UnpackObservationUint8(absl::Span<const uint8_t> bytes,
+                            absl::Span<float> values);
+void UnpackObservationHalf(absl::Span<const uint16_t> halfs,
+                           absl::Span<float> values);
+
 }  // namespace twixt
 }  // namespace open_spiel
 
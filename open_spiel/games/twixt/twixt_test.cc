@@ -12,9 +12,76 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <random>
+#include <set>
+#include <thread>  // NOLINT
+#include <tuple>
+
+#include "open_spiel/abseil-cpp/absl/base/attributes.h"
+#include "open_spiel/abseil-cpp/absl/strings/numbers.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_split.h"
+#include "open_spiel/abseil-cpp/absl/strings/strip.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/tests/basic_tests.h"
 #include "open_spiel/games/twixt/twixt.h"
+#include "open_spiel/games/twixt/twixtagent.h"
+#include "open_spiel/games/twixt/twixtbatch.h"
+#include "open_spiel/games/twixt/twixtbook.h"
+#include "open_spiel/games/twixt/twixtcompact.h"
+#include "open_spiel/games/twixt/twixtconnectivity.h"
+#include "open_spiel/games/twixt/twixtdaemon.h"
+#include "open_spiel/games/twixt/twixtparallel.h"
+#include "open_spiel/games/twixt/twixtperft.h"
+#include "open_spiel/games/twixt/twixtpool.h"
+#include "open_spiel/games/twixt/twixtrecord.h"
+#include "open_spiel/games/twixt/twixtrollout.h"
+#include "open_spiel/games/twixt/twixtselfplay.h"
+#include "open_spiel/games/twixt/twixttournament.h"
+#include "open_spiel/games/twixt/twixttrace.h"
+#include "open_spiel/games/twixt/twixtvecenv.h"
+
+// the global operator new is replaced to count the heap allocations, see
+// TwixtAllocationFreeTest; the other forms go through the unsized ones,
+// which are not inlined so that gcc does not pair an inlined malloc with
+// an operator delete (-Wmismatched-new-delete)
+namespace {
+std::atomic<int64_t> num_allocations(0);
+}  // namespace
+
+ABSL_ATTRIBUTE_NOINLINE void* operator new(std::size_t size) {
+  num_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+
+ABSL_ATTRIBUTE_NOINLINE void operator delete(void* pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+  operator delete(pointer);
+}
+
+void operator delete[](void* pointer) noexcept { operator delete(pointer); }
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+  operator delete(pointer);
+}
 
 namespace open_spiel {
 namespace twixt {
@@ -61,12 +128,12 @@ void TwixtParameterTest() {
   game = open_spiel::LoadGame(game_name, params);
   params.clear();
 
-  // too big: board_size=30
-  params.insert({"board_size", open_spiel::GameParameter(30, false)});
+  // too big: board_size=50
+  params.insert({"board_size", open_spiel::GameParameter(50, false)});
   try {
     game = open_spiel::LoadGame(game_name, params);
   } catch (TwixtTestException e) {
-    std::string expected = "board_size out of range [5..24]: 30";
+    std::string expected = "board_size out of range [5..48]: 50";
     SPIEL_CHECK_EQ(expected, std::string(e.what()));
   }
   params.clear();
@@ -76,7 +143,7 @@ void TwixtParameterTest() {
   try {
     game = open_spiel::LoadGame(game_name, params);
   } catch (TwixtTestException e) {
-    std::string expected = "board_size out of range [5..24]: 3";
+    std::string expected = "board_size out of range [5..48]: 3";
     SPIEL_CHECK_EQ(expected, std::string(e.what()));
   }
 
@@ -86,7 +153,8 @@ void TwixtParameterTest() {
     game = open_spiel::LoadGame(game_name, params);
   } catch (TwixtTestException e) {
     std::string expected = "Unknown parameter 'bad_param'. " \
-      "Available parameters are: ansi_color_output, board_size";
+      "Available parameters are: adjudicate, ansi_color_output, board_size, "
+      "link_removal";
     SPIEL_CHECK_EQ(expected, std::string(e.what()));
   }
 }
@@ -105,6 +173,25 @@ void PrintLegalActions(const std::vector<open_spiel::Action> v,
   std::cout << std::endl;
 }
 
+void TwixtLargeBoardTest() {
+  // columns beyond z get two letters
+  SPIEL_CHECK_EQ(ColumnLabel(0), "a");
+  SPIEL_CHECK_EQ(ColumnLabel(25), "z");
+  SPIEL_CHECK_EQ(ColumnLabel(26), "aa");
+  SPIEL_CHECK_EQ(ColumnLabel(47), "av");
+
+  std::shared_ptr<const open_spiel::Game> game =
+      open_spiel::LoadGame("twixt(board_size=48,ansi_color_output=False)");
+  testing::RandomSimTest(*game, 3);
+  auto state = game->NewInitialState();
+  // [30,10] = ae38
+  SPIEL_CHECK_EQ(state->ActionToString(kRedPlayer, 30 * 48 + 10), "xae38");
+  state->ApplyAction(30 * 48 + 10);
+  std::string board = state->ToString();
+  SPIEL_CHECK_NE(board.find("z  aa ab "), std::string::npos);
+  SPIEL_CHECK_NE(board.find("av \n"), std::string::npos);
+}
+
 void TwixtSwapTest() {
   std::shared_ptr<const open_spiel::Game> game = open_spiel::LoadGame("twixt");
   auto state = game->NewInitialState();
@@ -198,13 +285,1740 @@ void TwixtDrawTest() {
   SPIEL_CHECK_EQ(0.0, state->PlayerReturn(1));
 }
 
+// value of board for player to move: 1 win, 0 draw, -1 loss
+int SolveBoard(const Board& board, Player player) {
+  // winning moves first, which keeps the search small
+  std::vector<Action> legal = board.GetLegalActions(player);
+  for (Action action : legal) {
+    Board child = board;
+    child.ApplyAction(player, action);
+    if (child.result() == kRedWin || child.result() == kBlueWin) {
+      return 1;
+    }
+  }
+  int best = -1;
+  for (Action action : legal) {
+    Board child = board;
+    child.ApplyAction(player, action);
+    int value = child.result() == kDraw   ? 0
+                : child.result() != kOpen ? 1
+                                          : -SolveBoard(child, 1 - player);
+    best = std::max(best, value);
+    if (best == 1) {
+      break;
+    }
+  }
+  return best;
+}
+
+void TwixtAdjudicationTest() {
+  // x has linked d6-e4-d2; d6 and d2 can each reach their border line in
+  // two ways that o cannot both spoil
+  for (bool adjudicate : {false, true}) {
+    open_spiel::GameParameters params;
+    params.insert({"adjudicate", open_spiel::GameParameter(adjudicate)});
+    std::shared_ptr<const open_spiel::Game> game =
+      open_spiel::LoadGame("twixt", params);
+    auto state = game->NewInitialState();
+    for (Action action : {26, 51, 36, 12}) {
+      state->ApplyAction(action);
+      SPIEL_CHECK_FALSE(state->IsTerminal());
+    }
+    state->ApplyAction(30);
+    SPIEL_CHECK_EQ(state->IsTerminal(), adjudicate);
+    if (adjudicate) {
+      SPIEL_CHECK_EQ(1.0, state->PlayerReturn(0));
+    }
+  }
+
+  // on 5x5 the adjudicated positions of random games can be solved: the
+  // winner must be the player who moved last
+  std::mt19937 rng(3);
+  int num_adjudicated = 0;
+  for (int i = 0; i < 300; i++) {
+    Board board(5, false, true);
+    Board plain(5, false);
+    while (board.result() == kOpen) {
+      Player player = board.move_counter() % 2;
+      std::vector<Action> legal = board.GetLegalActions(player);
+      Action action = legal[rng() % legal.size()];
+      board.ApplyAction(player, action);
+      plain.ApplyAction(player, action);
+      if (board.result() != kOpen && plain.result() == kOpen) {
+        num_adjudicated++;
+        SPIEL_CHECK_EQ(board.result(),
+                       player == kRedPlayer ? kRedWin : kBlueWin);
+        SPIEL_CHECK_EQ(SolveBoard(plain, 1 - player), -1);
+      }
+    }
+  }
+  SPIEL_CHECK_GT(num_adjudicated, 0);
+}
+
+void TwixtPerftTest() {
+  open_spiel::GameParameters params;
+  params.insert({"board_size", open_spiel::GameParameter(5, false)});
+  std::shared_ptr<const open_spiel::Game> game =
+    open_spiel::LoadGame("twixt", params);
+  auto state = game->NewInitialState();
+  const Board& board = static_cast<const TwixTState&>(*state).board();
+
+  // reference counts of the 5x5 tree; any change to Board must keep them
+  PerftCounts expected;
+  expected.nodes = 42144;
+  expected.leaves = 38880;
+  expected.swaps = 9;
+  SPIEL_CHECK_TRUE(Perft(board, kRedPlayer, 4) == expected);
+
+  expected.nodes = 504528;
+  expected.leaves = 462384;
+  expected.red_wins = 6168;
+  std::vector<std::pair<Action, PerftCounts>> divide;
+  SPIEL_CHECK_TRUE(ParallelPerft(board, kRedPlayer, 5, 3, &divide) ==
+                   expected);
+  SPIEL_CHECK_EQ(15, divide.size());
+  PerftCounts sum;
+  for (const auto& entry : divide) {
+    sum += entry.second;
+  }
+  SPIEL_CHECK_TRUE(sum == expected);
+}
+
+void TwixtVectorEnvTest() {
+  for (bool link_removal : {false, true}) {
+    open_spiel::GameParameters params;
+    params.insert({"board_size", open_spiel::GameParameter(5, false)});
+    params.insert({"link_removal", open_spiel::GameParameter(link_removal)});
+    std::shared_ptr<const open_spiel::Game> game =
+      open_spiel::LoadGame("twixt", params);
+    VectorEnv env(game, 3);
+    int obs_size = game->ObservationTensorSize();
+    int num_actions = game->NumDistinctActions();
+    const float* observations = env.observations();
+
+    int num_done = 0;
+    for (int step = 0; step < 40; step++) {
+      // game i plays its i-th legal action
+      std::vector<Action> actions;
+      for (int i = 0; i < env.num_envs(); i++) {
+        std::vector<Action> legal = env.state(i).LegalActions();
+        actions.push_back(legal[i % legal.size()]);
+      }
+      env.Step(absl::MakeConstSpan(actions));
+      SPIEL_CHECK_EQ(observations, env.observations());
+
+      for (int i = 0; i < env.num_envs(); i++) {
+        const TwixTState& state = env.state(i);
+        num_done += env.dones()[i];
+        const float* rewards = &env.rewards()[i * kNumPlayers];
+        SPIEL_CHECK_EQ(0.0, rewards[0] + rewards[1]);
+        if (env.dones()[i]) {
+          SPIEL_CHECK_EQ(0, state.MoveNumber());
+        } else {
+          SPIEL_CHECK_EQ(0.0, rewards[0]);
+        }
+        SPIEL_CHECK_EQ(state.CurrentPlayer(), env.current_players()[i]);
+        std::vector<float> obs =
+            static_cast<const State&>(state).ObservationTensor(
+                state.CurrentPlayer());
+        for (int j = 0; j < obs_size; j++) {
+          SPIEL_CHECK_EQ(obs[j], observations[i * obs_size + j]);
+        }
+        std::vector<Action> legal = state.LegalActions();
+        int num_legal = 0;
+        for (int a = 0; a < num_actions; a++) {
+          num_legal += env.legal_action_masks()[i * num_actions + a];
+        }
+        SPIEL_CHECK_EQ(legal.size(), num_legal);
+        for (Action a : legal) {
+          SPIEL_CHECK_EQ(1, env.legal_action_masks()[i * num_actions + a]);
+        }
+      }
+    }
+    SPIEL_CHECK_GT(num_done, 0);
+  }
+}
+
+void TwixtStatePoolTest() {
+  std::shared_ptr<const open_spiel::Game> game = open_spiel::LoadGame("twixt");
+  StatePool pool(game);
+  TwixTState* root = pool.NewInitialState();
+  root->ApplyAction(19);
+  root->ApplyAction(19);  // swap
+  root->ApplyAction(36);
+
+  TwixTState* child = pool.Clone(*root);
+  SPIEL_CHECK_EQ(2, pool.num_used());
+  SPIEL_CHECK_EQ(root->ToString(), child->ToString());
+  SPIEL_CHECK_EQ(root->History(), child->History());
+  SPIEL_CHECK_EQ(root->LegalActions(), child->LegalActions());
+  child->ApplyAction(21);
+  SPIEL_CHECK_NE(root->ToString(), child->ToString());
+
+  // after a reset, the pool hands out the same states again
+  pool.Reset();
+  SPIEL_CHECK_EQ(0, pool.num_used());
+  TwixTState* initial = pool.NewInitialState();
+  SPIEL_CHECK_EQ(root, initial);
+  SPIEL_CHECK_EQ(0, initial->MoveNumber());
+  SPIEL_CHECK_EQ(game->NewInitialState()->ToString(), initial->ToString());
+  SPIEL_CHECK_EQ(2, pool.capacity());
+
+  // CloneInto a state that went further than the source
+  child->CloneInto(initial);
+  SPIEL_CHECK_EQ(child->ToString(), initial->ToString());
+  SPIEL_CHECK_EQ(child->CurrentPlayer(), initial->CurrentPlayer());
+  SPIEL_CHECK_EQ(child->LegalActions(), initial->LegalActions());
+}
+
+void TwixtCopyOnWriteTest() {
+  open_spiel::GameParameters params;
+  params.insert({"board_size", open_spiel::GameParameter(12, false)});
+  std::shared_ptr<const open_spiel::Game> game =
+    open_spiel::LoadGame("twixt", params);
+  auto parent = game->NewInitialState();
+  for (Action action : {41, 66, 65, 78, 54, 90}) {
+    parent->ApplyAction(action);
+  }
+  std::string parent_string = parent->ToString();
+  std::vector<float> parent_tensor = parent->ObservationTensor(0);
+  std::vector<Action> parent_legal = parent->LegalActions();
+
+  // the children share the board columns with the parent until they write
+  auto child = parent->Clone();
+  auto sibling = parent->Clone();
+  child->ApplyAction(29);   // x links to 54
+  sibling->ApplyAction(102);
+  child->ApplyAction(113);
+
+  SPIEL_CHECK_EQ(parent_string, parent->ToString());
+  SPIEL_CHECK_EQ(parent_tensor, parent->ObservationTensor(0));
+  SPIEL_CHECK_EQ(parent_legal, parent->LegalActions());
+  SPIEL_CHECK_NE(child->ToString(), sibling->ToString());
+  SPIEL_CHECK_FALSE(IsLegalAction(child->LegalActions(), 29));
+  SPIEL_CHECK_TRUE(IsLegalAction(sibling->LegalActions(), 29));
+}
+
+void TwixtCompactObservationTest() {
+  for (int board_size : {5, 8, 24}) {
+    open_spiel::GameParameters params;
+    params.insert({"board_size", open_spiel::GameParameter(board_size, false)});
+    std::shared_ptr<const open_spiel::Game> game =
+      open_spiel::LoadGame("twixt", params);
+    int tensor_size = game->ObservationTensorSize();
+    std::vector<uint64_t> words(ObservationBitsSize(board_size));
+    std::vector<uint8_t> bytes(tensor_size);
+    std::vector<uint16_t> halfs(tensor_size);
+    std::vector<float> unpacked(tensor_size);
+
+    std::mt19937 rng(board_size);
+    auto state = game->NewInitialState();
+    while (!state->IsTerminal()) {
+      const TwixTState& twixt_state = static_cast<const TwixTState&>(*state);
+      for (Player player = 0; player < kNumPlayers; player++) {
+        std::vector<float> tensor = state->ObservationTensor(player);
+
+        twixt_state.ObservationTensorBits(player, absl::MakeSpan(words));
+        UnpackObservationBits(board_size, words, absl::MakeSpan(unpacked));
+        SPIEL_CHECK_TRUE(tensor == unpacked);
+
+        twixt_state.ObservationTensorUint8(player, absl::MakeSpan(bytes));
+        UnpackObservationUint8(bytes, absl::MakeSpan(unpacked));
+        SPIEL_CHECK_TRUE(tensor == unpacked);
+
+        twixt_state.ObservationTensorHalf(player, absl::MakeSpan(halfs));
+        UnpackObservationHalf(halfs, absl::MakeSpan(unpacked));
+        SPIEL_CHECK_TRUE(tensor == unpacked);
+      }
+      std::vector<Action> legal = state->LegalActions();
+      state->ApplyAction(legal[rng() % legal.size()]);
+    }
+  }
+  // one row of a 24x24 plane fits into one word
+  SPIEL_CHECK_EQ(kNumPlanes * 24, ObservationBitsSize(24));
+}
+
+void TwixtSparseObservationTest() {
+  open_spiel::GameParameters params;
+  params.insert({"board_size", open_spiel::GameParameter(12, false)});
+  std::shared_ptr<const open_spiel::Game> game =
+    open_spiel::LoadGame("twixt", params);
+  int tensor_size = game->ObservationTensorSize();
+
+  // the sparse observations of all positions of a game as one batch
+  std::vector<int> indices;
+  std::vector<int> offsets = {0};
+  std::vector<float> dense;
+  std::mt19937 rng(12);
+  auto state = game->NewInitialState();
+  while (!state->IsTerminal()) {
+    const TwixTState& twixt_state = static_cast<const TwixTState&>(*state);
+    Player player = state->CurrentPlayer();
+    twixt_state.SparseObservationTensor(player, &indices);
+    offsets.push_back(indices.size());
+    std::vector<float> tensor = state->ObservationTensor(player);
+    dense.insert(dense.end(), tensor.begin(), tensor.end());
+    std::vector<Action> legal = state->LegalActions();
+    state->ApplyAction(legal[rng() % legal.size()]);
+  }
+
+  std::vector<float> densified(dense.size());
+  DensifyObservations(12, indices, offsets, absl::MakeSpan(densified));
+  SPIEL_CHECK_TRUE(dense == densified);
+  // the initial position has no pegs
+  SPIEL_CHECK_EQ(0, offsets[1]);
+  SPIEL_CHECK_EQ(offsets.size() - 1, dense.size() / tensor_size);
+}
+
+void TwixtInformationStateTensorTest() {
+  std::shared_ptr<const open_spiel::Game> game = open_spiel::LoadGame("twixt");
+  SPIEL_CHECK_EQ(game->InformationStateTensorShape(),
+                 std::vector<int>({kNumInformationStatePlanes, 8, 6}));
+  const int plane_size = 8 * 6;
+  const int board_entries = kNumPlanes * plane_size;
+
+  auto state = game->NewInitialState();
+  for (Action action : {19, 19, 36}) {
+    Player to_move = state->CurrentPlayer();
+    state->ApplyAction(action);
+    for (Player player = 0; player < kNumPlayers; player++) {
+      std::vector<float> info = state->InformationStateTensor(player);
+      std::vector<float> obs = state->ObservationTensor(player);
+      SPIEL_CHECK_TRUE(std::equal(obs.begin(), obs.end(), info.begin()));
+      // after 19, 19 player 1 has swapped
+      float swapped = state->MoveNumber() >= 2 ? 1.0 : 0.0;
+      float blue_to_move = to_move == kRedPlayer ? 1.0 : 0.0;
+      for (int i = 0; i < plane_size; i++) {
+        SPIEL_CHECK_EQ(swapped, info[board_entries + i]);
+        SPIEL_CHECK_EQ(blue_to_move, info[board_entries + plane_size + i]);
+      }
+    }
+  }
+}
+
+void TwixtImportTest() {
+  const char kArchive[] =
+      "# size 12, multi-digit rows, swap, mixed case and separators\n"
+      "[Size \"12\"]\n"
+      "[Result \"*\"]\n"
+      "1. xc5 2. swap\n"
+      "3. xd10, 4. oE11; 5. xb12\n"
+      "\n"
+      "xc5 of5 xd3\n"
+      "\n"
+      "xc5 xd3\n"          // wrong player
+      "\n"
+      "xa1\n"              // corner
+      "\n"
+      "xc5 of5 xd3 swap\n"  // late swap
+      "\n"
+      "xc5 of5 xzz\n"      // not a move
+      "\n"
+      "[Size \"5\"]\n"
+      "[Result \"1-0\"]\n"
+      "xb5 oa2 xc3 oa3 xd1 1-0\n"
+      "\n"
+      "[Size \"5\"]\n"
+      "xb5 oa2 xc3 oa3 xd1 oa4\n"  // move after the end
+      "\n"
+      "[Size \"5\"]\n"
+      "[Result \"0-1\"]\n"
+      "xb5 oa2 xc3 oa3 xd1\n";  // wrong result
+
+  std::vector<std::vector<Action>> games;
+  std::vector<int> results;
+  ImportStats stats = ImportRecords(
+      kArchive, "archive", ImportOptions(), [&](const GameRecord& record) {
+        games.push_back(record.actions);
+        results.push_back(record.board.result());
+      });
+  SPIEL_CHECK_EQ(stats.num_records, 9);
+  SPIEL_CHECK_EQ(stats.num_games, 3);
+  SPIEL_CHECK_EQ(stats.num_moves, 13);
+  SPIEL_CHECK_EQ(stats.num_errors, 6);
+  SPIEL_CHECK_EQ(stats.errors.size(), 6);
+  SPIEL_CHECK_EQ(stats.errors[0], "archive:9: move by the wrong player: xd3");
+  SPIEL_CHECK_EQ(games[0], std::vector<Action>({31, 31, 38, 49, 12}));
+  SPIEL_CHECK_EQ(games[1], std::vector<Action>({19, 43, 29}));
+  SPIEL_CHECK_EQ(results[2], kRedWin);
+
+  // the imported actions replay on TwixTState and print the same moves
+  open_spiel::GameParameters params;
+  params["board_size"] = open_spiel::GameParameter(12);
+  std::shared_ptr<const open_spiel::Game> game =
+      open_spiel::LoadGame("twixt", params);
+  std::unique_ptr<open_spiel::State> state = game->NewInitialState();
+  for (Action action : games[0]) {
+    state->ApplyAction(action);
+  }
+  SPIEL_CHECK_EQ(state->ActionToString(kBluePlayer, 49), "oe11");
+  SPIEL_CHECK_EQ(state->ActionToString(kRedPlayer, 12), "xb12");
+
+  ImportOptions options;
+  options.rows_from_bottom = true;
+  games.clear();
+  ImportRecords("xc4 of4 xd6", "", options,
+                [&](const GameRecord& record) {
+                  games.push_back(record.actions);
+                });
+  SPIEL_CHECK_EQ(games, std::vector<std::vector<Action>>({{19, 43, 29}}));
+
+  stats = ImportFiles({"/nonexistent/archive.txt"}, options, 2, nullptr);
+  SPIEL_CHECK_EQ(stats.num_errors, 1);
+}
+
+void TwixtOpeningBookTest() {
+  // b is a left/right mirror image of a, c swaps
+  OpeningBookBuilder builder(8, 2);
+  builder.AddGame({19, 43, 29}, kRedWin);
+  builder.AddGame({43, 19, 37}, kRedWin);
+  builder.AddGame({19, 19, 20}, kBlueWin);
+  SPIEL_CHECK_EQ(builder.num_positions(), 2);
+  const std::string path = "/tmp/twixt_test_book.bin";
+  builder.Write(path, 1);
+
+  OpeningBook book(path);
+  SPIEL_CHECK_EQ(book.num_entries(), 3);
+  std::shared_ptr<const open_spiel::Game> game = open_spiel::LoadGame("twixt");
+  std::unique_ptr<open_spiel::State> state = game->NewInitialState();
+  const TwixTState& twixt_state = static_cast<const TwixTState&>(*state);
+
+  // all four first moves are equivalent
+  std::vector<BookMove> moves = book.Lookup(twixt_state);
+  SPIEL_CHECK_EQ(moves.size(), 4);
+  for (int i = 0; i < 4; i++) {
+    SPIEL_CHECK_EQ(moves[i].action, std::vector<Action>({19, 20, 43, 44})[i]);
+    SPIEL_CHECK_EQ(moves[i].visits, 3);
+    SPIEL_CHECK_EQ(moves[i].wins, 2);
+  }
+
+  // the book moves follow the first move into its mirror images
+  for (auto expected : std::vector<std::vector<Action>>(
+           {{19, 43, 19}, {43, 19, 43}, {20, 44, 20}, {44, 20, 44}})) {
+    state = game->NewInitialState();
+    state->ApplyAction(expected[0]);
+    moves = book.Lookup(static_cast<const TwixTState&>(*state));
+    SPIEL_CHECK_EQ(moves.size(), 2);
+    SPIEL_CHECK_EQ(moves[0].action, expected[1]);
+    SPIEL_CHECK_EQ(moves[0].visits, 2);
+    SPIEL_CHECK_EQ(moves[0].wins, 0);
+    // the swap
+    SPIEL_CHECK_EQ(moves[1].action, expected[2]);
+    SPIEL_CHECK_EQ(moves[1].visits, 1);
+    SPIEL_CHECK_EQ(moves[1].wins, 1);
+    state->ApplyAction(expected[1]);
+    SPIEL_CHECK_TRUE(
+        book.Lookup(static_cast<const TwixTState&>(*state)).empty());
+  }
+  std::remove(path.c_str());
+}
+
+std::vector<TraceRecord> ReadTrace(const std::string& path) {
+  MappedFile file(path);
+  TraceReader reader(file.contents());
+  SPIEL_CHECK_TRUE(reader.ok());
+  std::vector<TraceRecord> records;
+  TraceRecord record;
+  while (reader.Next(&record)) {
+    records.push_back(record);
+  }
+  return records;
+}
+
+void CheckTraceRecords(
+    const std::vector<TraceRecord>& records,
+    const std::vector<std::tuple<int, uint64_t, uint64_t>>& expected) {
+  SPIEL_CHECK_EQ(records.size(), expected.size());
+  for (int i = 0; i < records.size(); i++) {
+    SPIEL_CHECK_EQ(records[i].op, std::get<0>(expected[i]));
+    SPIEL_CHECK_EQ(records[i].state_id, std::get<1>(expected[i]));
+    SPIEL_CHECK_EQ(records[i].arg, std::get<2>(expected[i]));
+  }
+}
+
+void TwixtTraceTest() {
+  std::shared_ptr<const open_spiel::Game> game = open_spiel::LoadGame(
+      "twixt", {{"ansi_color_output", open_spiel::GameParameter(false)}});
+  std::unique_ptr<open_spiel::State> untraced = game->NewInitialState();
+  const std::string path = "/tmp/twixt_test.trace";
+  uint64_t string_size;
+  std::unique_ptr<open_spiel::State> state;
+  {
+    TraceRecorder recorder(path);
+    TraceRecorder::SetActive(&recorder);
+    state = game->NewInitialState();
+    state->ApplyAction(19);
+    std::unique_ptr<open_spiel::State> clone = state->Clone();
+    clone->LegalActions();
+    std::vector<float> observation = clone->ObservationTensor(1);
+    string_size = clone->ToString().size();
+    untraced->LegalActions();
+    clone.reset();
+    TraceRecorder::SetActive(nullptr);
+    SPIEL_CHECK_EQ(recorder.num_records(), 7);
+  }
+
+  std::vector<TraceRecord> records = ReadTrace(path);
+  SPIEL_CHECK_EQ(records.size(), 7);
+  uint64_t id = records[0].state_id;
+  uint64_t clone_id = records[2].arg;
+  SPIEL_CHECK_NE(id, clone_id);
+  CheckTraceRecords(records,
+                    {{kTraceNew, id, 8},
+                     {kTraceApplyAction, id, 19},
+                     {kTraceClone, id, clone_id},
+                     {kTraceLegalActions, clone_id, 8 * 6},  // with swap
+                     {kTraceObservationTensor, clone_id, 1},
+                     {kTraceToString, clone_id, string_size},
+                     {kTraceDelete, clone_id, 0}});
+
+  // the states of the first recorder are not traced by a second one, and
+  // CloneInto records a clone from a traced state (the target gets an id)
+  // and a delete from an untraced one (the target loses its id)
+  {
+    TraceRecorder recorder(path);
+    TraceRecorder::SetActive(&recorder);
+    state->ApplyAction(20);
+    std::unique_ptr<open_spiel::State> clone = state->Clone();
+    std::unique_ptr<open_spiel::State> traced = game->NewInitialState();
+    const auto& traced_state = static_cast<const TwixTState&>(*traced);
+    traced_state.CloneInto(static_cast<TwixTState*>(untraced.get()));
+    untraced->ApplyAction(21);
+    static_cast<const TwixTState&>(*state).CloneInto(
+        static_cast<TwixTState*>(untraced.get()));
+    untraced->ApplyAction(22);
+    TraceRecorder::SetActive(nullptr);
+  }
+  records = ReadTrace(path);
+  SPIEL_CHECK_EQ(records.size(), 4);
+  id = records[0].state_id;
+  clone_id = records[1].arg;
+  CheckTraceRecords(records, {{kTraceNew, id, 8},
+                              {kTraceClone, id, clone_id},
+                              {kTraceApplyAction, clone_id, 21},
+                              {kTraceDelete, clone_id, 0}});
+  std::remove(path.c_str());
+}
+
+void TwixtTraceThreadsTest() {
+  std::shared_ptr<const Game> game =
+      LoadGame("twixt", {{"ansi_color_output", GameParameter(false)}});
+  const std::string path = "/tmp/twixt_test.threads.trace";
+
+  // a state made in one thread and cloned in another: the blocks of the
+  // two threads are read back in the order of the calls
+  {
+    TraceRecorder recorder(path);
+    TraceRecorder::SetActive(&recorder);
+    std::unique_ptr<State> state;
+    std::thread([&]() { state = game->NewInitialState(); }).join();
+    std::unique_ptr<State> clone = state->Clone();
+    std::thread([&]() { state->ApplyAction(19); }).join();
+    clone->ApplyAction(20);
+    TraceRecorder::SetActive(nullptr);
+  }
+  std::vector<TraceRecord> records = ReadTrace(path);
+  SPIEL_CHECK_EQ(records.size(), 4);
+  const uint64_t id = records[0].state_id;
+  const uint64_t clone_id = records[1].arg;
+  CheckTraceRecords(records, {{kTraceNew, id, 8},
+                              {kTraceClone, id, clone_id},
+                              {kTraceApplyAction, id, 19},
+                              {kTraceApplyAction, clone_id, 20}});
+
+  // threads keep playing while the recorder is made inactive and deleted;
+  // every record is of a state the trace has made before
+  std::atomic<bool> stop(false);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&, t]() {
+      std::mt19937 rng(t);
+      std::unique_ptr<State> target = game->NewInitialState();
+      while (!stop.load()) {
+        std::unique_ptr<State> state = game->NewInitialState();
+        while (!state->IsTerminal() && !stop.load()) {
+          std::vector<Action> legal = state->LegalActions();
+          state->ApplyAction(legal[rng() % legal.size()]);
+          if (rng() % 2 == 0) {
+            state = state->Clone();
+          } else {
+            static_cast<const TwixTState&>(*state).CloneInto(
+                static_cast<TwixTState*>(target.get()));
+            target->LegalActions();
+          }
+        }
+      }
+    });
+  }
+  int64_t num_records;
+  {
+    std::unique_ptr<TraceRecorder> recorder(new TraceRecorder(path));
+    TraceRecorder::SetActive(recorder.get());
+    while (recorder->num_records() < 20000) {
+      std::this_thread::yield();
+    }
+    TraceRecorder::SetActive(nullptr);
+    num_records = recorder->num_records();
+    recorder.reset();
+  }
+  stop = true;
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  records = ReadTrace(path);
+  SPIEL_CHECK_EQ(records.size(), num_records);
+  std::set<uint64_t> ids;
+  for (const TraceRecord& record : records) {
+    if (record.op == kTraceNew) {
+      SPIEL_CHECK_TRUE(ids.insert(record.state_id).second);
+      continue;
+    }
+    SPIEL_CHECK_EQ(ids.count(record.state_id), 1);
+    if (record.op == kTraceClone) {
+      ids.insert(record.arg);
+    } else if (record.op == kTraceDelete) {
+      ids.erase(record.state_id);
+    }
+  }
+  std::remove(path.c_str());
+}
+
+void TwixtBatchBoardTest() {
+  // random games in lockstep on a BatchBoard and on Boards must agree in
+  // every cell after every move; every third game swaps
+  std::mt19937 rng(11);
+  for (int board_size : {5, 8, 13}) {
+    const int num_games = 37;
+    BatchBoard batch(board_size, num_games);
+    std::vector<Board> boards(num_games, Board(board_size, false));
+    std::vector<Action> actions(num_games);
+    int num_swaps = 0;
+    int num_wins = 0;
+    for (int step = 0; step < 3 * board_size * board_size; step++) {
+      for (int g = 0; g < num_games; g++) {
+        std::vector<Action> legal = boards[g].result() == kOpen
+            ? boards[g].GetLegalActions(boards[g].move_counter() % 2)
+            : std::vector<Action>();
+        SPIEL_CHECK_EQ(batch.LegalActions(g), legal);
+        actions[g] = legal.empty() ? -1 : legal[rng() % legal.size()];
+        if (boards[g].move_counter() == 1 && g % 3 == 0) {
+          // swap if blue may
+          for (Action a : legal) {
+            if (boards[g].GetConstCell(boards[g].ActionToPosition(a))
+                    .color() == kRedPlayer) {
+              actions[g] = a;
+            }
+          }
+        }
+        if (actions[g] >= 0) {
+          boards[g].ApplyAction(boards[g].move_counter() % 2, actions[g]);
+        }
+      }
+      batch.ApplyActions(actions);
+
+      for (int g = 0; g < num_games; g++) {
+        const Board& board = boards[g];
+        SPIEL_CHECK_EQ(batch.result(g), board.result());
+        SPIEL_CHECK_EQ(batch.move_counter(g), board.move_counter());
+        SPIEL_CHECK_EQ(batch.swapped(g), board.swapped());
+        for (Action cell = 0; cell < board_size * board_size; cell++) {
+          const Cell& expected =
+              board.GetConstCell(board.ActionToPosition(cell));
+          SPIEL_CHECK_EQ(batch.color(g, cell), expected.color());
+          SPIEL_CHECK_EQ(batch.links(g, cell), expected.links());
+          SPIEL_CHECK_EQ(batch.blocked_neighbors(g, cell) != 0,
+                         expected.HasBlockedNeighbors());
+          SPIEL_CHECK_EQ(batch.blocked_neighbors(g, cell) % 16 != 0,
+                         expected.HasBlockedNeighborsEast());
+          if (expected.color() < kNumPlayers) {
+            for (Border border : {kStart, kEnd}) {
+              SPIEL_CHECK_EQ(batch.IsLinkedToBorder(g, cell, border),
+                             expected.IsLinkedToBorder(expected.color(),
+                                                       border));
+            }
+          }
+        }
+        num_swaps += board.move_counter() == 2 && board.swapped();
+      }
+    }
+    for (int g = 0; g < num_games; g++) {
+      num_wins += batch.result(g) == kRedWin || batch.result(g) == kBlueWin;
+    }
+    SPIEL_CHECK_GT(num_swaps, 0);
+    SPIEL_CHECK_GT(num_wins, 0);
+  }
+}
+
+void TwixtRolloutTest() {
+  // a peg of x at d4 favors the steep e6 over the flat f3 over the
+  // unrelated b2; taken cells have no weight
+  const Action d4 = 28, f7 = 41, e6 = 34, f3 = 45, b2 = 14;
+  Board board(8, false);
+  board.ApplyAction(kRedPlayer, d4);
+  board.ApplyAction(kBluePlayer, f7);
+  RolloutPolicy policy(8);
+  SPIEL_CHECK_EQ(policy.Weight(board, kRedPlayer, d4), 0);
+  SPIEL_CHECK_EQ(policy.Weight(board, kRedPlayer, b2), 1);
+  SPIEL_CHECK_GT(policy.Weight(board, kRedPlayer, e6),
+                 policy.Weight(board, kRedPlayer, f3));
+  SPIEL_CHECK_GT(policy.Weight(board, kRedPlayer, f3), 1);
+
+  // rollouts from the start and from random positions must be legal games
+  // with the result the game itself reaches, and repeatable with a seed
+  std::mt19937 rng(5);
+  for (int board_size : {5, 8, 13}) {
+    std::shared_ptr<const open_spiel::Game> game = open_spiel::LoadGame(
+        "twixt", {{"board_size", open_spiel::GameParameter(board_size)}});
+    RolloutPolicy policy(board_size);
+    for (int i = 0; i < 50; i++) {
+      Board start(board_size, false);
+      std::vector<Action> actions;
+      int num_random = i % 2 == 0 ? 0 : rng() % (board_size * 2);
+      for (int j = 0; j < num_random && start.result() == kOpen; j++) {
+        Player player = start.move_counter() % 2;
+        std::vector<Action> legal = start.GetLegalActions(player);
+        actions.push_back(legal[rng() % legal.size()]);
+        start.ApplyAction(player, actions.back());
+      }
+      const int seed = rng();
+      std::mt19937 rollout_rng(seed);
+      Board board = start;
+      int result = policy.Rollout(&board, &rollout_rng, &actions);
+      SPIEL_CHECK_NE(result, kOpen);
+      SPIEL_CHECK_EQ(result, board.result());
+
+      std::unique_ptr<State> state = game->NewInitialState();
+      for (Action action : actions) {
+        SPIEL_CHECK_FALSE(state->IsTerminal());
+        state->ApplyAction(action);
+      }
+      SPIEL_CHECK_TRUE(state->IsTerminal());
+      SPIEL_CHECK_EQ(state->PlayerReturn(kRedPlayer),
+                     result == kRedWin ? 1.0 : result == kBlueWin ? -1.0 : 0);
+
+      rollout_rng.seed(seed);
+      Board again = start;
+      SPIEL_CHECK_EQ(policy.Rollout(&again, &rollout_rng), result);
+      SPIEL_CHECK_EQ(again.move_counter(), board.move_counter());
+    }
+  }
+}
+
+void TwixtSelfPlayTest() {
+  // the games must be legal, and the same with any number of threads and
+  // any batch size
+  std::shared_ptr<const open_spiel::Game> game = open_spiel::LoadGame(
+      "twixt", {{"board_size", open_spiel::GameParameter(6)}});
+  StubEvaluator evaluator(*game, 8, 1);
+  SelfPlayOptions options;
+  options.num_games = 12;
+  options.games_in_flight = 5;
+  options.num_simulations = 16;
+  std::vector<SelfPlayStats> stats;
+  std::vector<std::vector<Action>> expected;
+  for (int num_threads : {1, 3}) {
+    for (int batch_size : {1, 4}) {
+      options.num_threads = num_threads;
+      options.batch_size = batch_size;
+      std::vector<std::vector<Action>> played;
+      stats.push_back(PlaySelfPlayGames(
+          game, &evaluator, options,
+          [&](const std::vector<Action>& actions,
+              const std::vector<double>& returns) {
+            std::unique_ptr<State> state = game->NewInitialState();
+            for (Action action : actions) {
+              state->ApplyAction(action);
+            }
+            SPIEL_CHECK_TRUE(state->IsTerminal());
+            SPIEL_CHECK_EQ(state->Returns(), returns);
+            played.push_back(actions);
+          }));
+      std::sort(played.begin(), played.end());
+      if (expected.empty()) {
+        expected = played;
+      }
+      SPIEL_CHECK_EQ(played, expected);
+    }
+  }
+  for (const SelfPlayStats& s : stats) {
+    SPIEL_CHECK_EQ(s.num_games, 12);
+    SPIEL_CHECK_EQ(s.num_results[0] + s.num_results[1] + s.num_results[2],
+                   12);
+    SPIEL_CHECK_EQ(s.num_moves, stats[0].num_moves);
+    SPIEL_CHECK_EQ(s.num_evaluations, stats[0].num_evaluations);
+    SPIEL_CHECK_LE(s.num_evaluations, s.num_rounds * 5);
+  }
+  SPIEL_CHECK_EQ(stats[0].FillRate(1), 1.0);
+
+  // priors by compact index
+  StubEvaluator compact_evaluator(*game, 8, 1, true);
+  options.compact_actions = true;
+  int num_games = 0;
+  PlaySelfPlayGames(game, &compact_evaluator, options,
+                    [&](const std::vector<Action>& actions,
+                        const std::vector<double>& returns) {
+                      std::unique_ptr<State> state = game->NewInitialState();
+                      for (Action action : actions) {
+                        state->ApplyAction(action);
+                      }
+                      SPIEL_CHECK_TRUE(state->IsTerminal());
+                      num_games++;
+                    });
+  SPIEL_CHECK_EQ(num_games, 12);
+  SPIEL_CHECK_GT(stats[1].FillRate(4), 0.5);
+  SPIEL_CHECK_LE(stats[1].FillRate(4), 1.0);
+}
+
+void TwixtBoardCountersTest() {
+  // every link set is counted; the counts belong to the thread
+  std::mt19937 rng(13);
+  GetBoardCounters() = BoardCounters();
+  int64_t num_links = 0;
+  for (int i = 0; i < 200; i++) {
+    Board board(8, false);
+    while (board.result() == kOpen) {
+      Player player = board.move_counter() % 2;
+      std::vector<Action> legal = board.GetLegalActions(player);
+      board.ApplyAction(player, legal[rng() % legal.size()]);
+    }
+    for (Action cell = 0; cell < 64; cell++) {
+      num_links += __builtin_popcount(
+          board.GetConstCell(board.ActionToPosition(cell)).links());
+    }
+  }
+  BoardCounters counters = GetBoardCounters();
+  SPIEL_CHECK_EQ(counters.links, num_links / 2);
+  SPIEL_CHECK_GT(counters.blocked_links, 0);
+  SPIEL_CHECK_GT(counters.explorations, 0);
+  SPIEL_CHECK_GE(counters.explored_cells, counters.explorations);
+
+  std::thread([]() {
+    SPIEL_CHECK_EQ(GetBoardCounters().links, 0);
+    Board board(8, false);
+    board.ApplyAction(kRedPlayer, 26);
+    board.ApplyAction(kBluePlayer, 51);
+    board.ApplyAction(kRedPlayer, 36);
+    SPIEL_CHECK_EQ(GetBoardCounters().links, 1);
+  }).join();
+  SPIEL_CHECK_EQ(GetBoardCounters().links, counters.links);
+}
+
+void TwixtCompactActionsTest() {
+  // the legal compact indices are the legal actions, one to one, and the
+  // swap has its own index
+  std::mt19937 rng(17);
+  for (int board_size : {5, 8, 13}) {
+    CompactActions compact(board_size);
+    SPIEL_CHECK_EQ(compact.size(), board_size * (board_size - 2) + 1);
+    std::shared_ptr<const open_spiel::Game> game = open_spiel::LoadGame(
+        "twixt", {{"board_size", open_spiel::GameParameter(board_size)}});
+    const int plane_size = board_size * (board_size - 2);
+    std::vector<float> observation(game->ObservationTensorSize());
+    int num_swaps = 0;
+    for (int i = 0; i < 30; i++) {
+      std::unique_ptr<State> state = game->NewInitialState();
+      const Board& board = static_cast<TwixTState&>(*state).board();
+      std::vector<int> indices;
+      while (!state->IsTerminal()) {
+        Player player = state->CurrentPlayer();
+        std::vector<Action> legal = state->LegalActions();
+        compact.LegalIndices(board, player, &indices);
+        SPIEL_CHECK_EQ(indices.size(), legal.size());
+        std::vector<Action> actions;
+        for (int index : indices) {
+          if (index == compact.swap_index()) {
+            SPIEL_CHECK_EQ(player, kBluePlayer);
+            SPIEL_CHECK_EQ(board.move_counter(), 1);
+          }
+          Action action = compact.FromCompact(board, player, index);
+          SPIEL_CHECK_EQ(compact.ToCompact(board, player, action), index);
+          actions.push_back(action);
+        }
+        std::sort(actions.begin(), actions.end());
+        SPIEL_CHECK_EQ(actions, legal);
+
+        // swap half of the games that may
+        int index = indices[rng() % indices.size()];
+        if (i % 2 == 0 && indices.back() == compact.swap_index()) {
+          index = compact.swap_index();
+          num_swaps++;
+        }
+        Action action = compact.FromCompact(board, player, index);
+        state->ApplyAction(action);
+
+        // a peg without links is at its compact index on its first plane
+        if (index != compact.swap_index() && !state->IsTerminal() &&
+            board.GetConstCell(board.ActionToPosition(action)).links() ==
+                0) {
+          std::fill(observation.begin(), observation.end(), 0);
+          state->ObservationTensor(player, absl::MakeSpan(observation));
+          int plane = player == kRedPlayer ? 0 : kNumPlanes / 2;
+          SPIEL_CHECK_EQ(observation[plane * plane_size + index], 1.0);
+        }
+      }
+    }
+    SPIEL_CHECK_GT(num_swaps, 0);
+  }
+}
+
+void TwixtCrossingsTest() {
+  // the crossing counter of each link slot is the number of links that
+  // cross it
+  std::mt19937 rng(19);
+  for (int board_size : {8, 13}) {
+    for (int i = 0; i < 50; i++) {
+      Board board(board_size, false);
+      while (board.result() == kOpen) {
+        Player player = board.move_counter() % 2;
+        std::vector<Action> legal = board.GetLegalActions(player);
+        board.ApplyAction(player, legal[rng() % legal.size()]);
+      }
+      for (int x = 0; x < board_size; x++) {
+        for (int y = 0; y < board_size; y++) {
+          for (int dir = kNNE; dir <= kSSE; dir++) {
+            int crossings = 0;
+            for (const Link& blocker : GetLinkDescriptor(dir).blocking_links) {
+              Position start = Position{x, y} + blocker.position;
+              if (start.x >= 0 && start.x < board_size && start.y >= 0 &&
+                  start.y < board_size &&
+                  board.GetConstCell(start).HasLink(blocker.direction)) {
+                crossings++;
+              }
+            }
+            SPIEL_CHECK_EQ(board.GetConstCell({x, y}).crossings(dir),
+                           crossings);
+          }
+        }
+      }
+    }
+  }
+}
+
+void TwixtDeadCellsTest() {
+  // dead cells stay dead, a peg on a cell dead for its player gets no
+  // links, and the live moves are the legal moves that are not useless
+  std::mt19937 rng(23);
+  for (int board_size : {8, 13}) {
+    const int num_cells = board_size * board_size;
+    for (int i = 0; i < 30; i++) {
+      Board board(board_size, false);
+      std::vector<bool> dead[kNumPlayers];
+      dead[0].assign(num_cells, false);
+      dead[1].assign(num_cells, false);
+      while (board.result() == kOpen) {
+        for (Player player = 0; player < kNumPlayers; player++) {
+          for (Action action = 0; action < num_cells; action++) {
+            bool is_dead = board.IsDeadCell(player, action);
+            SPIEL_CHECK_TRUE(is_dead || !dead[player][action]);
+            dead[player][action] = is_dead;
+          }
+        }
+        Player player = board.move_counter() % 2;
+        std::vector<Action> legal = board.GetLegalActions(player);
+        std::vector<Action> live = board.GetLiveLegalActions(player);
+        SPIEL_CHECK_FALSE(live.empty());
+        int num_useless = 0;
+        for (Action action : legal) {
+          num_useless += board.IsUselessMove(player, action);
+        }
+        if (board.move_counter() >= 2 && num_useless < legal.size()) {
+          SPIEL_CHECK_EQ(live.size() + num_useless, legal.size());
+        } else {
+          SPIEL_CHECK_EQ(live.size(), legal.size());
+        }
+        for (Action action : live) {
+          SPIEL_CHECK_TRUE(board.IsLegalAction(player, action));
+        }
+        Action action = legal[rng() % legal.size()];
+        // (a swap moves the peg to another cell)
+        bool was_dead =
+            board.move_counter() >= 2 && board.IsDeadCell(player, action);
+        board.ApplyAction(player, action);
+        if (was_dead) {
+          SPIEL_CHECK_FALSE(
+              board.GetConstCell(board.ActionToPosition(action)).HasLinks());
+        }
+      }
+    }
+  }
+}
+
+void TwixtAllocationFreeTest() {
+  // once warmed up, CloneInto, ApplyAction, LegalActions into a buffer
+  // and ObservationTensor do not allocate, with link_removal too (the
+  // connectivity is copied into the spare of the target)
+  const std::vector<std::pair<int, bool>> configurations = {
+      {8, false}, {24, false}, {24, true}};
+  for (const auto& configuration : configurations) {
+    const int board_size = configuration.first;
+    const bool link_removal = configuration.second;
+    std::shared_ptr<const Game> game =
+        LoadGame("twixt", {{"board_size", GameParameter(board_size)},
+                           {"link_removal", GameParameter(link_removal)}});
+    std::unique_ptr<State> root = game->NewInitialState();
+    for (Action action : {2 * board_size + 3, 5 * board_size + 4}) {
+      root->ApplyAction(action);
+    }
+    std::unique_ptr<State> target = game->NewInitialState();
+    std::vector<Action> actions;
+    std::vector<float> tensor(game->ObservationTensorSize());
+    std::mt19937 rng(31);
+    auto play = [&]() {
+      auto& state = static_cast<TwixTState&>(*target);
+      static_cast<const TwixTState&>(*root).CloneInto(&state);
+      while (!state.IsTerminal()) {
+        state.LegalActions(&actions);
+        state.ObservationTensor(state.CurrentPlayer(),
+                                absl::MakeSpan(tensor));
+        state.ApplyAction(actions[rng() % actions.size()]);
+      }
+    };
+    for (int i = 0; i < 10; i++) {
+      play();
+    }
+    int64_t before = num_allocations.load();
+    for (int i = 0; i < 20; i++) {
+      play();
+    }
+    SPIEL_CHECK_EQ(num_allocations.load() - before, 0);
+  }
+
+  // nor does cloning a game longer than any the target has had, here a
+  // draw that fills a 5x5 board
+  std::shared_ptr<const Game> game =
+      LoadGame("twixt", {{"board_size", GameParameter(5)}});
+  std::unique_ptr<State> long_game = game->NewInitialState();
+  std::unique_ptr<State> target_state = game->NewInitialState();
+  auto& target = static_cast<TwixTState&>(*target_state);
+  static_cast<const TwixTState&>(*long_game).CloneInto(&target);
+  while (!long_game->IsTerminal()) {
+    // the pattern of TwixtDrawTest
+    long_game->ApplyAction(long_game->LegalActions().at(0));
+    long_game->ApplyAction(long_game->LegalActions().at(1));
+  }
+  SPIEL_CHECK_GE(static_cast<int>(long_game->History().size()),
+                 game->MaxGameLength() - 4);
+  int64_t before = num_allocations.load();
+  static_cast<const TwixTState&>(*long_game).CloneInto(&target);
+  SPIEL_CHECK_EQ(num_allocations.load() - before, 0);
+  SPIEL_CHECK_TRUE(target.History() == long_game->History());
+}
+
+void TwixtTournamentTest() {
+  std::shared_ptr<const Game> game = LoadGame("twixt");
+  MctsOptions mcts_options;
+  mcts_options.num_simulations = 50;
+  std::vector<TournamentEntry> entries = {
+      {"random", []() { return std::unique_ptr<Agent>(new RandomAgent()); }},
+      {"mcts", [&]() {
+         return std::unique_ptr<Agent>(new MctsAgent(*game, mcts_options));
+       }}};
+  TournamentOptions options;
+  options.games_per_pairing = 10;
+  int num_callbacks = 0;
+  std::vector<TournamentGame> games = PlayTournament(
+      game, entries, options,
+      [&](const TournamentGame& played) { num_callbacks++; });
+  SPIEL_CHECK_EQ(games.size(), 10);
+  SPIEL_CHECK_EQ(num_callbacks, 10);
+  for (const TournamentGame& played : games) {
+    // colors alternate
+    SPIEL_CHECK_EQ(played.red, played.game % 2);
+    SPIEL_CHECK_EQ(played.blue, 1 - played.game % 2);
+    SPIEL_CHECK_NE(played.result, kOpen);
+    // the games are valid
+    std::unique_ptr<State> state = game->NewInitialState();
+    for (Action action : played.actions) {
+      state->ApplyAction(action);
+    }
+    SPIEL_CHECK_TRUE(state->IsTerminal());
+  }
+
+  // the games do not depend on the number of threads
+  options.num_threads = 3;
+  std::vector<TournamentGame> threaded_games =
+      PlayTournament(game, entries, options);
+  for (int g = 0; g < games.size(); g++) {
+    SPIEL_CHECK_TRUE(games[g].actions == threaded_games[g].actions);
+  }
+
+  std::vector<Rating> ratings = ComputeRatings(entries.size(), games);
+  SPIEL_CHECK_EQ(ratings[0].elo, 0);
+  SPIEL_CHECK_EQ(ratings[0].games + ratings[1].games, 20);
+  SPIEL_CHECK_EQ(ratings[0].score + ratings[1].score, 10);
+  SPIEL_CHECK_GE(ratings[1].score, 8);
+  SPIEL_CHECK_GT(ratings[1].elo, 0);
+
+  // 75% against one entry is 400 * log10(3) Elo, with a margin of
+  // 1.96 / sqrt(games * p * (1 - p)) natural units; an entry without
+  // games has no margin
+  std::vector<TournamentGame> synthetic;
+  for (int g = 0; g < 100; g++) {
+    TournamentGame played;
+    played.red = g % 2;
+    played.blue = 1 - g % 2;
+    bool first_wins = g % 4 != 0;
+    played.result = (played.red == 0) == first_wins ? kRedWin : kBlueWin;
+    synthetic.push_back(played);
+  }
+  ratings = ComputeRatings(3, synthetic, 1e-9);
+  SPIEL_CHECK_FLOAT_NEAR(ratings[1].elo, -400 * std::log10(3.0), 1e-3);
+  SPIEL_CHECK_FLOAT_NEAR(ratings[1].margin,
+                         1.96 * 400 / std::log(10.0) /
+                             std::sqrt(100 * 0.75 * 0.25),
+                         0.1);
+  SPIEL_CHECK_TRUE(std::isinf(ratings[2].margin));
+  // the prior pulls the ratings together
+  SPIEL_CHECK_GT(ComputeRatings(2, synthetic)[1].elo, ratings[1].elo);
+}
+
+void TwixtAnytimeTest() {
+  std::shared_ptr<const Game> game = LoadGame("twixt");
+  MctsOptions options;
+  options.prune_useless_moves = true;
+  MctsAgent agent(*game, options);
+
+  // legal moves with a deadline, also when the time is up already
+  std::mt19937 rng(37);
+  std::unique_ptr<State> state = game->NewInitialState();
+  int num_moves = 0;
+  while (!state->IsTerminal()) {
+    const auto& twixt_state = static_cast<const TwixTState&>(*state);
+    auto deadline = MctsAgent::Clock::now() + std::chrono::milliseconds(5);
+    if (num_moves == 3) {
+      deadline = MctsAgent::Clock::now() - std::chrono::milliseconds(1);
+    }
+    Action action = agent.StepUntil(twixt_state, &rng, deadline);
+    SPIEL_CHECK_TRUE(twixt_state.board().IsLegalAction(
+        state->CurrentPlayer(), action));
+    state->ApplyAction(action);
+    num_moves++;
+  }
+  const SearchStats& stats = agent.stats();
+  SPIEL_CHECK_EQ(stats.num_moves, num_moves);
+  SPIEL_CHECK_GE(stats.num_overruns, 1);
+  SPIEL_CHECK_GE(stats.num_simulations, num_moves);
+  SPIEL_CHECK_GT(stats.num_nodes, 0);
+  SPIEL_CHECK_LE(stats.LatencyPercentile(0.5), stats.LatencyPercentile(1));
+
+  // the second time a game is searched, the search does not allocate
+  options.num_simulations = 200;
+  MctsAgent fixed_agent(*game, options);
+  int64_t num_step_allocations = 0;
+  for (int i = 0; i < 2; i++) {
+    std::mt19937 game_rng(41);
+    state = game->NewInitialState();
+    num_step_allocations = 0;
+    while (!state->IsTerminal()) {
+      int64_t before = num_allocations.load();
+      Action action = fixed_agent.Step(static_cast<const TwixTState&>(*state),
+                                       &game_rng);
+      num_step_allocations += num_allocations.load() - before;
+      state->ApplyAction(action);
+    }
+  }
+  SPIEL_CHECK_EQ(num_step_allocations, 0);
+}
+
+void TwixtParallelMctsTest() {
+  std::shared_ptr<const Game> game = LoadGame("twixt");
+  ParallelMctsOptions options;
+  options.num_simulations = 300;
+  options.max_nodes = 20000;
+
+  // one thread: the moves depend on the generator only
+  std::vector<Action> moves[2];
+  for (int i = 0; i < 2; i++) {
+    ParallelMctsAgent agent(*game, options);
+    std::mt19937 rng(43);
+    std::unique_ptr<State> state = game->NewInitialState();
+    for (int move = 0; move < 6; move++) {
+      moves[i].push_back(
+          agent.Step(static_cast<const TwixTState&>(*state), &rng));
+      state->ApplyAction(moves[i].back());
+    }
+    SPIEL_CHECK_EQ(agent.stats().num_collisions, 0);
+  }
+  SPIEL_CHECK_TRUE(moves[0] == moves[1]);
+
+  // four threads on one tree, with rollouts and with evaluators; the last
+  // agent gets a tree too small for more than the root and its children
+  std::vector<std::unique_ptr<StubEvaluator>> stubs;
+  std::vector<LeafEvaluator*> evaluators;
+  for (int t = 0; t < 4; t++) {
+    stubs.emplace_back(new StubEvaluator(*game, 16, 0));
+    evaluators.push_back(stubs.back().get());
+  }
+  options.num_threads = 4;
+  options.virtual_loss = 3;
+  options.prune_useless_moves = true;
+  for (int kind = 0; kind < 3; kind++) {
+    ParallelMctsOptions agent_options = options;
+    if (kind == 2) {
+      agent_options.max_nodes = 100;
+    }
+    ParallelMctsAgent agent(
+        *game, agent_options,
+        kind == 1 ? evaluators : std::vector<LeafEvaluator*>());
+    std::mt19937 rng(47);
+    std::unique_ptr<State> state = game->NewInitialState();
+    int num_moves = 0;
+    while (!state->IsTerminal()) {
+      const auto& twixt_state = static_cast<const TwixTState&>(*state);
+      Action action = agent.Step(twixt_state, &rng);
+      SPIEL_CHECK_TRUE(twixt_state.board().IsLegalAction(
+          state->CurrentPlayer(), action));
+      state->ApplyAction(action);
+      num_moves++;
+    }
+    const ParallelSearchStats& stats = agent.stats();
+    SPIEL_CHECK_EQ(stats.num_moves, num_moves);
+    SPIEL_CHECK_EQ(stats.num_simulations, num_moves * 300);
+    SPIEL_CHECK_LE(stats.num_nodes, num_moves * agent_options.max_nodes);
+    SPIEL_CHECK_GT(stats.num_nodes, 0);
+  }
+
+  // the shared tree still finds a winning move: the first position of a
+  // random game in which the player to move can win at once
+  std::mt19937 rng(53);
+  std::unique_ptr<State> state = game->NewInitialState();
+  std::vector<Action> winning;
+  while (winning.empty()) {
+    SPIEL_CHECK_FALSE(state->IsTerminal());
+    std::vector<Action> legal = state->LegalActions();
+    for (Action action : legal) {
+      std::unique_ptr<State> child = state->Clone();
+      child->ApplyAction(action);
+      if (child->IsTerminal() &&
+          child->PlayerReturn(state->CurrentPlayer()) > 0) {
+        winning.push_back(action);
+      }
+    }
+    if (winning.empty()) {
+      state->ApplyAction(legal[rng() % legal.size()]);
+    }
+  }
+  options.num_simulations = 2000;
+  options.max_nodes = 100000;
+  ParallelMctsAgent agent(*game, options);
+  Action action = agent.Step(static_cast<const TwixTState&>(*state), &rng);
+  SPIEL_CHECK_TRUE(std::find(winning.begin(), winning.end(), action) !=
+                   winning.end());
+}
+
+void TwixtDynamicConnectivityTest() {
+  // random additions and removals against a union-find of the edges left
+  const int num_vertices = 40;
+  const int num_edges = 120;
+  std::mt19937 rng(59);
+  DynamicConnectivity connectivity;
+  connectivity.Reset(num_vertices, num_edges);
+  std::vector<std::pair<int, int>> ends(num_edges, {-1, -1});
+  std::vector<int> parent(num_vertices);
+  std::function<int(int)> find = [&](int v) {
+    return parent[v] == v ? v : parent[v] = find(parent[v]);
+  };
+  for (int step = 0; step < 5000; step++) {
+    const int edge = rng() % num_edges;
+    if (connectivity.HasEdge(edge)) {
+      connectivity.RemoveEdge(edge);
+      ends[edge] = {-1, -1};
+    } else {
+      const int u = rng() % num_vertices;
+      const int v = (u + 1 + rng() % (num_vertices - 1)) % num_vertices;
+      connectivity.AddEdge(edge, u, v);
+      ends[edge] = {u, v};
+    }
+    for (int v = 0; v < num_vertices; v++) {
+      parent[v] = v;
+    }
+    for (const auto& edge_ends : ends) {
+      if (edge_ends.first >= 0) {
+        parent[find(edge_ends.first)] = find(edge_ends.second);
+      }
+    }
+    for (int i = 0; i < 10; i++) {
+      const int u = rng() % num_vertices;
+      const int v = rng() % num_vertices;
+      SPIEL_CHECK_EQ(connectivity.Connected(u, v), find(u) == find(v));
+      SPIEL_CHECK_EQ(connectivity.ComponentSize(u),
+                     std::count_if(parent.begin(), parent.end(),
+                                   [&](int w) { return find(w) == find(u); }));
+    }
+  }
+  SPIEL_CHECK_GT(connectivity.num_levels(), 1);
+}
+
+// whether the pegs of player connect its border lines by links, searched
+// on the cells
+bool LinkedBorders(const Board& board, Player player) {
+  const int size = board.size();
+  std::vector<bool> seen(size * size, false);
+  std::vector<Position> stack;
+  for (int i = 1; i < size - 1; i++) {
+    Position start = player == kRedPlayer ? Position{i, 0} : Position{0, i};
+    if (board.GetConstCell(start).color() == player) {
+      seen[board.PositionToAction(start)] = true;
+      stack.push_back(start);
+    }
+  }
+  while (!stack.empty()) {
+    Position position = stack.back();
+    stack.pop_back();
+    if ((player == kRedPlayer ? position.y : position.x) == size - 1) {
+      return true;
+    }
+    const Cell& cell = board.GetConstCell(position);
+    for (int dir = 0; dir < kMaxCompass; dir++) {
+      Position next = position + GetLinkDescriptor(dir).offsets;
+      if (cell.HasLink(dir) && !seen[board.PositionToAction(next)]) {
+        seen[board.PositionToAction(next)] = true;
+        stack.push_back(next);
+      }
+    }
+  }
+  return false;
+}
+
+// true if the links of board are the ones its pegs make: a slot between
+// two pegs of one color is linked unless a link crosses it or its link has
+// been removed, and the pegs are flagged as blocked neighbors otherwise
+bool LinksComplete(const Board& board) {
+  const int size = board.size();
+  auto on_board = [size](Position p) {
+    return p.x >= 0 && p.x < size && p.y >= 0 && p.y < size;
+  };
+  for (int x = 0; x < size; x++) {
+    for (int y = 0; y < size; y++) {
+      const Position from = {x, y};
+      const Cell& cell = board.GetConstCell(from);
+      for (int dir = 0; dir < kLinkSlotsPerCell; dir++) {
+        const Position to = from + GetLinkDescriptor(dir).offsets;
+        if ((cell.color() != kRedColor && cell.color() != kBlueColor) ||
+            !on_board(to) || board.GetConstCell(to).color() != cell.color()) {
+          continue;
+        }
+        bool crossed = false;
+        for (const Link& blocker : GetLinkDescriptor(dir).blocking_links) {
+          const Position position = from + blocker.position;
+          crossed = crossed || (on_board(position) &&
+                                board.GetConstCell(position).HasLink(
+                                    blocker.direction));
+        }
+        if (cell.HasLink(dir) != (!crossed && !cell.HasRemovedLink(dir)) ||
+            cell.HasBlockedNeighbor(dir) == cell.HasLink(dir)) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// the number of links of both players
+int NumLinks(const Board& board) {
+  int num_links = 0;
+  for (int x = 0; x < board.size(); x++) {
+    for (int y = 0; y < board.size(); y++) {
+      for (int dir = 0; dir < kLinkSlotsPerCell; dir++) {
+        num_links += board.GetConstCell({x, y}).HasLink(dir);
+      }
+    }
+  }
+  return num_links;
+}
+
+void TwixtLinkRemovalTest() {
+  std::shared_ptr<const Game> game = LoadGame(
+      "twixt", {{"board_size", GameParameter(8)},
+                {"link_removal", GameParameter(true)}});
+  SPIEL_CHECK_EQ(game->NumDistinctActions(), 5 * 8 * 8);
+  bool raised = false;
+  try {
+    LoadGame("twixt", {{"adjudicate", GameParameter(true)},
+                       {"link_removal", GameParameter(true)}});
+  } catch (TwixtTestException e) {
+    SPIEL_CHECK_EQ(std::string(e.what()),
+                   "adjudicate cannot be combined with link_removal");
+    raised = true;
+  }
+  SPIEL_CHECK_TRUE(raised);
+
+  // red links c5 and d3, removes the link and blue links c3 and d5 across
+  // where it was
+  std::unique_ptr<State> state = game->NewInitialState();
+  const auto& twixt_state = static_cast<const TwixTState&>(*state);
+  const Board& board = twixt_state.board();
+  for (Position position : {Position{2, 3}, Position{0, 6}, Position{3, 5},
+                            Position{0, 1}}) {
+    state->ApplyAction(board.PositionToAction(position));
+  }
+  Action removal = board.LinkToAction({{2, 3}, kNNE});
+  SPIEL_CHECK_TRUE(board.IsLinkRemoval(removal));
+  SPIEL_CHECK_EQ(state->ActionToString(kRedPlayer, removal), "xc5-d3");
+  std::vector<Action> legal = state->LegalActions();
+  SPIEL_CHECK_EQ(legal.back(), removal);
+  SPIEL_CHECK_EQ(legal.size(), board.num_legal_actions(kRedPlayer) + 1);
+  state->ApplyAction(removal);
+  SPIEL_CHECK_EQ(state->CurrentPlayer(), kRedPlayer);
+  SPIEL_CHECK_FALSE(board.GetConstCell({2, 3}).HasLink(kNNE));
+  SPIEL_CHECK_FALSE(board.GetConstCell({3, 5}).HasLink(kSSW));
+  SPIEL_CHECK_FALSE(board.IsLegalAction(kRedPlayer, removal));
+  for (Position position : {Position{6, 0}, Position{2, 5}, Position{6, 7},
+                            Position{3, 3}}) {
+    state->ApplyAction(board.PositionToAction(position));
+  }
+  SPIEL_CHECK_TRUE(board.GetConstCell({2, 5}).HasLink(kSSE));
+
+  // the same with the blue pegs placed first: their link is blocked until
+  // red removes its link, then they are linked at once; when blue removes
+  // that link, the red pegs stay unlinked
+  state = game->NewInitialState();
+  const Board& relink_board =
+      static_cast<const TwixTState&>(*state).board();
+  for (Position position : {Position{2, 3}, Position{2, 5}, Position{3, 5},
+                            Position{3, 3}}) {
+    state->ApplyAction(relink_board.PositionToAction(position));
+  }
+  SPIEL_CHECK_FALSE(relink_board.GetConstCell({2, 5}).HasLink(kSSE));
+  SPIEL_CHECK_TRUE(relink_board.GetConstCell({2, 5}).HasBlockedNeighbor(kSSE));
+  state->ApplyAction(relink_board.LinkToAction({{2, 3}, kNNE}));
+  SPIEL_CHECK_EQ(state->CurrentPlayer(), kRedPlayer);
+  SPIEL_CHECK_TRUE(relink_board.GetConstCell({2, 5}).HasLink(kSSE));
+  SPIEL_CHECK_TRUE(relink_board.GetConstCell({3, 3}).HasLink(kNNW));
+  for (Position position : {Position{2, 5}, Position{3, 3}}) {
+    SPIEL_CHECK_FALSE(
+        relink_board.GetConstCell(position).HasBlockedNeighbors());
+  }
+  SPIEL_CHECK_TRUE(relink_board.GetConstCell({2, 3}).HasBlockedNeighbor(kNNE));
+  const Action blue_removal = relink_board.LinkToAction({{2, 5}, kSSE});
+  SPIEL_CHECK_FALSE(relink_board.IsLegalAction(kRedPlayer, blue_removal));
+  state->ApplyAction(relink_board.PositionToAction({6, 0}));
+  SPIEL_CHECK_TRUE(relink_board.IsLegalAction(kBluePlayer, blue_removal));
+  state->ApplyAction(blue_removal);
+  SPIEL_CHECK_FALSE(relink_board.GetConstCell({2, 5}).HasLink(kSSE));
+  SPIEL_CHECK_FALSE(relink_board.GetConstCell({2, 3}).HasLink(kNNE));
+  // random games with removals: the same player moves after a removal,
+  // the links are the ones the pegs make and the result agrees with a
+  // search of the links; without removals a game goes as in the standard
+  // game
+  std::shared_ptr<const Game> standard =
+      LoadGame("twixt", {{"board_size", GameParameter(8)}});
+  std::mt19937 rng(61);
+  int num_removals = 0;
+  int num_relinks = 0;  // removals that link other pegs
+  std::unique_ptr<State> previous;
+  for (int game_index = 0; game_index < 40; game_index++) {
+    const bool remove = game_index % 4 != 0;
+    state = game->NewInitialState();
+    std::unique_ptr<State> standard_state = standard->NewInitialState();
+    const Board& game_board =
+        static_cast<const TwixTState&>(*state).board();
+    while (!state->IsTerminal()) {
+      const Player player = state->CurrentPlayer();
+      legal = state->LegalActions();
+      SPIEL_CHECK_TRUE(std::is_sorted(legal.begin(), legal.end()));
+      auto first_removal =
+          std::find_if(legal.begin(), legal.end(), [&](Action action) {
+            return game_board.IsLinkRemoval(action);
+          });
+      const int num_pegs = first_removal - legal.begin();
+      Action action;
+      if (remove && first_removal != legal.end() && rng() % 3 == 0) {
+        action = first_removal[rng() % (legal.end() - first_removal)];
+        Link link = game_board.ActionToLink(action);
+        SPIEL_CHECK_EQ(game_board.GetConstCell(link.position).color(),
+                       player);
+        const int num_links = NumLinks(game_board);
+        state->ApplyAction(action);
+        SPIEL_CHECK_EQ(state->CurrentPlayer(),
+                       state->IsTerminal() ? kTerminalPlayerId : player);
+        SPIEL_CHECK_FALSE(
+            game_board.GetConstCell(link.position).HasLink(link.direction));
+        num_removals++;
+        num_relinks += NumLinks(game_board) >= num_links;
+      } else {
+        action = legal[rng() % num_pegs];
+        // shares the connectivity of state until the move
+        previous = state->Clone();
+        state->ApplyAction(action);
+      }
+      SPIEL_CHECK_TRUE(LinksComplete(game_board));
+      const int result = game_board.result();
+      SPIEL_CHECK_EQ(result == kRedWin,
+                     LinkedBorders(game_board, kRedPlayer));
+      SPIEL_CHECK_EQ(result == kBlueWin,
+                     LinkedBorders(game_board, kBluePlayer));
+      if (!remove) {
+        SPIEL_CHECK_EQ(num_pegs, standard_state->LegalActions().size());
+        standard_state->ApplyAction(action);
+        SPIEL_CHECK_EQ(standard_state->IsTerminal(), state->IsTerminal());
+      }
+    }
+    if (!remove) {
+      SPIEL_CHECK_TRUE(standard_state->Returns() == state->Returns());
+    }
+    const Board& previous_board =
+        static_cast<const TwixTState&>(*previous).board();
+    for (Player player : {kRedPlayer, kBluePlayer}) {
+      SPIEL_CHECK_FALSE(previous_board.BordersConnected(player));
+    }
+  }
+  SPIEL_CHECK_GT(num_removals, 100);
+  SPIEL_CHECK_GT(num_relinks, 0);
+
+  // the searches play link removals legally
+  MctsOptions mcts_options;
+  mcts_options.num_simulations = 100;
+  MctsAgent mcts(*game, mcts_options);
+  ParallelMctsOptions parallel_options;
+  parallel_options.num_simulations = 100;
+  parallel_options.num_threads = 2;
+  parallel_options.max_nodes = 20000;
+  ParallelMctsAgent parallel(*game, parallel_options);
+  state = game->NewInitialState();
+  while (!state->IsTerminal()) {
+    const auto& search_state = static_cast<const TwixTState&>(*state);
+    Action action = state->CurrentPlayer() == kRedPlayer
+                        ? mcts.Step(search_state, &rng)
+                        : parallel.Step(search_state, &rng);
+    SPIEL_CHECK_TRUE(search_state.board().IsLegalAction(
+        state->CurrentPlayer(), action));
+    state->ApplyAction(action);
+  }
+}
+
+void TwixtDaemonTest() {
+  std::shared_ptr<const Game> game =
+      LoadGame("twixt", {{"board_size", GameParameter(8)}});
+  DaemonOptions options;
+  options.num_simulations = 200;
+  options.num_rollouts = 16;
+
+  // a position as actions and as its compact encoding, with the swap
+  std::mt19937 rng(67);
+  std::unique_ptr<State> state = game->NewInitialState();
+  std::vector<Action> actions = {10, 10};
+  std::string position = "10,10";
+  state->ApplyAction(10);
+  state->ApplyAction(10);
+  for (int move = 0; move < 6; move++) {
+    std::vector<Action> legal = state->LegalActions();
+    actions.push_back(legal[rng() % legal.size()]);
+    state->ApplyAction(actions.back());
+    position += "," + std::to_string(actions.back());
+  }
+  const std::string compact = CompactEncoding(*game, actions);
+  std::string legal = "ok " + std::to_string(state->LegalActions().size());
+  for (Action action : state->LegalActions()) {
+    legal += " " + std::to_string(action);
+  }
+
+  // the answers do not depend on the threads, the batch or the cache
+  std::vector<std::string> requests = {
+      "legal " + position, "legal " + compact, "best " + position,
+      "eval " + position,  "best " + compact,  "best -",
+      "eval -",            "bogus -",          "best",
+      "legal 10,10,0",     "legal c:!!",       "eval 0"};
+  std::vector<std::string> responses[3];
+  for (int run = 0; run < 3; run++) {
+    DaemonOptions run_options = options;
+    run_options.num_threads = run == 0 ? 1 : 2;
+    AnalysisDaemon daemon(game, run_options);
+    daemon.AnswerBatch(requests, &responses[run]);
+    if (run == 2) {
+      daemon.AnswerBatch(requests, &responses[run]);
+      // the second batch computes nothing
+      SPIEL_CHECK_EQ(daemon.stats().num_searches, 2);
+      SPIEL_CHECK_EQ(daemon.stats().num_evaluations, 2);
+      SPIEL_CHECK_EQ(daemon.stats().num_cache_hits, 5);
+      SPIEL_CHECK_EQ(daemon.stats().num_errors, 10);
+    }
+  }
+  SPIEL_CHECK_TRUE(responses[0] == responses[1]);
+  SPIEL_CHECK_TRUE(responses[0] == responses[2]);
+  const std::vector<std::string>& answers = responses[0];
+  SPIEL_CHECK_EQ(answers[0], legal);
+  SPIEL_CHECK_EQ(answers[1], legal);
+  SPIEL_CHECK_EQ(answers[2], answers[4]);
+  for (int i = 7; i < requests.size(); i++) {
+    SPIEL_CHECK_EQ(answers[i].compare(0, 6, "error "), 0);
+  }
+  std::vector<std::string> words = absl::StrSplit(answers[2], ' ');
+  SPIEL_CHECK_EQ(words.size(), 5);
+  Action best;
+  SPIEL_CHECK_TRUE(absl::SimpleAtoi(words[1], &best));
+  SPIEL_CHECK_TRUE(static_cast<const TwixTState&>(*state).board()
+                       .IsLegalAction(state->CurrentPlayer(), best));
+  SPIEL_CHECK_EQ(words[2], state->ActionToString(state->CurrentPlayer(), best));
+
+  // eval requests with an evaluator get its values, for red
+  StubEvaluator stub(*game, 16, 0);
+  StubEvaluator daemon_stub(*game, 16, 0);
+  AnalysisDaemon stub_daemon(game, options, {&daemon_stub});
+  std::vector<std::string> stub_responses;
+  stub_daemon.AnswerBatch({"eval " + position}, &stub_responses);
+  std::vector<float> observation(game->ObservationTensorSize());
+  std::vector<float> priors(game->NumDistinctActions());
+  float value;
+  state->ObservationTensor(state->CurrentPlayer(),
+                           absl::MakeSpan(observation));
+  stub.Evaluate(1, observation.data(), priors.data(), &value);
+  if (state->CurrentPlayer() == kBluePlayer) {
+    value = -value;
+  }
+  SPIEL_CHECK_EQ(stub_responses[0], absl::StrCat("ok ", value));
+
+  // clients on the socket send several requests before they read
+  const std::string path =
+      "/tmp/twixt_test." + std::to_string(getpid()) + ".sock";
+  AnalysisDaemon daemon(game, options);
+  daemon.Listen(path);
+  std::thread server(&AnalysisDaemon::Serve, &daemon);
+  std::vector<std::thread> clients;
+  for (int c = 0; c < 3; c++) {
+    clients.emplace_back([&]() {
+      AnalysisClient client(path);
+      for (const std::string& request : requests) {
+        client.Send(request);
+      }
+      for (const std::string& answer : answers) {
+        SPIEL_CHECK_EQ(client.Receive(), answer);
+      }
+    });
+  }
+  for (std::thread& client : clients) {
+    client.join();
+  }
+  daemon.Stop();
+  server.join();
+  SPIEL_CHECK_EQ(daemon.stats().num_connections, 3);
+  SPIEL_CHECK_EQ(daemon.stats().num_requests, 3 * requests.size());
+}
+
+void TwixtDaemonBackpressureTest() {
+  std::shared_ptr<const Game> game =
+      LoadGame("twixt", {{"board_size", GameParameter(24)}});
+  std::unique_ptr<State> state = game->NewInitialState();
+  std::string legal = "ok " + std::to_string(state->LegalActions().size());
+  for (Action action : state->LegalActions()) {
+    legal += " " + std::to_string(action);
+  }
+  DaemonOptions options;
+  options.max_line_bytes = 1000;
+  const std::string path =
+      "/tmp/twixt_test." + std::to_string(getpid()) + ".sock";
+  AnalysisDaemon daemon(game, options);
+  daemon.Listen(path);
+  std::thread server(&AnalysisDaemon::Serve, &daemon);
+
+  // a client sends all its requests before it reads: their responses
+  // (~50 MB) are far more than the socket buffers take, and the daemon
+  // keeps answering other clients meanwhile
+  const int num_requests = 20000;
+  AnalysisClient client(path);
+  std::thread sender([&]() {
+    for (int i = 0; i < num_requests; i++) {
+      client.Send("legal -");
+    }
+  });
+  AnalysisClient other(path);
+  int num_stats = 0;
+  // the requests of client answered so far
+  auto answered = [&]() {
+    std::vector<std::string> words =
+        absl::StrSplit(other.Request("stats"), ' ');
+    num_stats++;
+    int64_t requests;
+    SPIEL_CHECK_TRUE(absl::SimpleAtoi(
+        absl::StripPrefix(words[1], "requests="), &requests));
+    return requests - num_stats;
+  };
+  // half of max_buffered_bytes is more than a socket buffer takes
+  while (answered() * legal.size() < options.max_buffered_bytes / 2) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  // the daemon stops reading the requests of client once about
+  // max_buffered_bytes of its responses wait
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  SPIEL_CHECK_LT(answered(), num_requests / 4);
+  for (int i = 0; i < num_requests; i++) {
+    SPIEL_CHECK_EQ(client.Receive(), legal);
+  }
+  sender.join();
+
+  auto closed_by_daemon = [](AnalysisClient* closed_client) {
+    try {
+      closed_client->Receive();
+    } catch (TwixtTestException e) {
+      SPIEL_CHECK_EQ(std::string(e.what()),
+                     "Connection closed by the daemon");
+      return true;
+    }
+    return false;
+  };
+
+  // a client that shuts down its side right after its requests still
+  // gets all their responses, then the daemon closes the connection; the
+  // responses (~500 KB) are more than the socket buffers take, so the
+  // daemon sees the shutdown while some of them wait
+  const int num_half_closed_requests = 200;
+  AnalysisClient half_closed(path);
+  for (int i = 0; i < num_half_closed_requests; i++) {
+    half_closed.Send("legal -");
+  }
+  half_closed.Shutdown();
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  for (int i = 0; i < num_half_closed_requests; i++) {
+    SPIEL_CHECK_EQ(half_closed.Receive(), legal);
+  }
+  SPIEL_CHECK_TRUE(closed_by_daemon(&half_closed));
+
+  // a line longer than max_line_bytes closes its connection
+  AnalysisClient long_line(path);
+  long_line.Send(std::string(options.max_line_bytes + 1, 'x'));
+  SPIEL_CHECK_TRUE(closed_by_daemon(&long_line));
+  SPIEL_CHECK_EQ(other.Request("legal -"), legal);
+
+  daemon.Stop();
+  server.join();
+}
+
 int main(int argc, char **argv) {
   open_spiel::twixt::BasicTwixTTests();
   open_spiel::SetErrorHandler(TwixtTestErrorHandler);
   TwixtParameterTest();
+  TwixtLargeBoardTest();
   TwixtSwapTest();
   TwixtLegalActionsTest();
   TwixtDrawTest();
+  TwixtAdjudicationTest();
+  TwixtPerftTest();
+  TwixtVectorEnvTest();
+  TwixtStatePoolTest();
+  TwixtCopyOnWriteTest();
+  TwixtCompactObservationTest();
+  TwixtSparseObservationTest();
+  TwixtInformationStateTensorTest();
+  TwixtImportTest();
+  TwixtOpeningBookTest();
+  TwixtTraceTest();
+  TwixtTraceThreadsTest();
+  TwixtBatchBoardTest();
+  TwixtRolloutTest();
+  TwixtSelfPlayTest();
+  TwixtBoardCountersTest();
+  TwixtCompactActionsTest();
+  TwixtCrossingsTest();
+  TwixtDeadCellsTest();
+  TwixtAllocationFreeTest();
+  TwixtTournamentTest();
+  TwixtAnytimeTest();
+  TwixtParallelMctsTest();
+  TwixtDynamicConnectivityTest();
+  TwixtLinkRemovalTest();
+  TwixtDaemonTest();
+  TwixtDaemonBackpressureTest();
 }
 
 }  // namespace
@@ -0,0 +1,397 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/games/twixt/twixtadjudicate.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "open_spiel/games/twixt/twixtcell.h"
+
+namespace open_spiel {
+namespace twixt {
+namespace {
+
+// the search for a chain of gaps gives up (and plays on) after this many
+// steps
+const int kMaxSearchSteps = 4096;
+
+// a set of cells, indexed by action
+struct CellSet {
+  uint64_t words[kLegalActionWords] = {};
+
+  void Insert(int cell) { words[cell / 64] |= 1ULL << (cell % 64); }
+  void Insert(const CellSet& other) {
+    for (int i = 0; i < kLegalActionWords; i++) {
+      words[i] |= other.words[i];
+    }
+  }
+  bool Intersects(const CellSet& other) const {
+    for (int i = 0; i < kLegalActionWords; i++) {
+      if (words[i] & other.words[i]) {
+        return true;
+      }
+    }
+    return false;
+  }
+  int Count() const {
+    int count = 0;
+    for (int i = 0; i < kLegalActionWords; i++) {
+      count += __builtin_popcountll(words[i]);
+    }
+    return count;
+  }
+};
+
+// one way to close a gap: a peg in the hole and its links
+struct Way {
+  Position hole;
+  Link links[2];
+  int num_links;
+};
+
+// a gap between two nodes (groups or borders) and its ways, or a border a
+// group is already linked to (no ways)
+struct Gap {
+  int from;
+  int to;
+  bool is_gap;
+  int first_way;  // in ways_
+  int num_ways;
+  // set by ResolveGap: whether two of the ways make the gap safe, and the
+  // cells that matter to them
+  bool resolved = false;
+  bool safe = false;
+  CellSet carrier;
+};
+
+class Adjudicator {
+ public:
+  Adjudicator(const Board& board, Player player)
+      : board_(board),
+        player_(player),
+        opponent_(1 - player),
+        size_(board.size()),
+        groups_(size_ * size_, -1) {}
+
+  bool Run();
+
+ private:
+  bool OnBoard(Position p) const {
+    return p.x >= 0 && p.x < size_ && p.y >= 0 && p.y < size_;
+  }
+  int Index(Position p) const { return p.x * size_ + p.y; }
+  int Color(Position p) const { return board_.GetConstCell(p).color(); }
+  bool IsOnBorder(Position p, Border border) const {
+    int coordinate = player_ == kRedPlayer ? p.y : p.x;
+    return coordinate == (border == kStart ? 0 : size_ - 1);
+  }
+
+  bool IsBlocked(Link link) const;
+  void FindGroups();
+  void AddWayCells(const Way& way, CellSet* carrier,
+                   CellSet* spoilers) const;
+  void AddGap(int from, int to, const std::vector<Way>& ways, int first,
+              int last);
+  void FindGaps();
+  void ResolveGap(Gap* gap) const;
+  bool Search(int node, const CellSet& used, int num_gaps);
+
+  const Board& board_;
+  Player player_;
+  Player opponent_;
+  int size_;
+  std::vector<int> groups_;  // group of each peg of player, or -1
+  // the pegs of group g are pegs_[group_starts_[g]..group_starts_[g + 1])
+  std::vector<Position> pegs_;
+  std::vector<int> group_starts_;
+  std::vector<Gap> gaps_;
+  std::vector<Way> ways_;
+  std::vector<std::vector<int>> node_gaps_;
+  std::vector<bool> on_path_;
+  int steps_ = 0;
+};
+
+bool Adjudicator::IsBlocked(Link link) const {
+  for (const Link& blocker : GetLinkDescriptor(link.direction).blocking_links) {
+    Position from = link.position + blocker.position;
+    if (OnBoard(from) && board_.GetConstCell(from).HasLink(blocker.direction)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void Adjudicator::FindGroups() {
+  for (int x = 0; x < size_; x++) {
+    for (uint64_t rows = board_.GetPegRows(x); rows != 0; rows &= rows - 1) {
+      Position start = {x, __builtin_ctzll(rows)};
+      if (Color(start) != player_ || groups_[Index(start)] >= 0) {
+        continue;
+      }
+      int group = group_starts_.size();
+      group_starts_.push_back(pegs_.size());
+      pegs_.push_back(start);
+      groups_[Index(start)] = group;
+      // the pegs of the group grow while they are walked
+      for (int i = group_starts_[group]; i < static_cast<int>(pegs_.size());
+           i++) {
+        Position position = pegs_[i];
+        const Cell& cell = board_.GetConstCell(position);
+        for (int dir = 0; dir < kMaxCompass; dir++) {
+          if (cell.HasLink(dir)) {
+            Position target = position + GetLinkDescriptor(dir).offsets;
+            if (groups_[Index(target)] < 0) {
+              groups_[Index(target)] = group;
+              pegs_.push_back(target);
+            }
+          }
+        }
+      }
+    }
+  }
+  group_starts_.push_back(pegs_.size());
+}
+
+// the carrier of a way holds the empty cells that matter to it: the hole
+// and the ends of all links that would cross it; the spoilers are the cells
+// where one opponent peg spoils the way
+void Adjudicator::AddWayCells(const Way& way, CellSet* carrier,
+                              CellSet* spoilers) const {
+  carrier->Insert(Index(way.hole));
+  if (board_.IsLegalAction(opponent_, Index(way.hole))) {
+    spoilers->Insert(Index(way.hole));
+  }
+  for (int i = 0; i < way.num_links; i++) {
+    const Link& link = way.links[i];
+    for (const Link& blocker :
+         GetLinkDescriptor(link.direction).blocking_links) {
+      Position ends[2];
+      ends[0] = link.position + blocker.position;
+      ends[1] = ends[0] + GetLinkDescriptor(blocker.direction).offsets;
+      if (!OnBoard(ends[0]) || !OnBoard(ends[1])) {
+        continue;
+      }
+      for (int e = 0; e < 2; e++) {
+        if (Color(ends[e]) != kEmpty) {
+          continue;
+        }
+        // any new peg here may be linked across the way, if only by the
+        // player's own pegs
+        carrier->Insert(Index(ends[e]));
+        if (Color(ends[1 - e]) == opponent_ &&
+            board_.IsLegalAction(opponent_, Index(ends[e]))) {
+          spoilers->Insert(Index(ends[e]));
+        }
+      }
+    }
+  }
+}
+
+void Adjudicator::AddGap(int from, int to, const std::vector<Way>& ways,
+                         int first, int last) {
+  // a gap needs two ways with different holes
+  for (int i = first; i < last; i++) {
+    if (!(ways[i].hole == ways[first].hole)) {
+      gaps_.push_back({from, to, true, static_cast<int>(ways_.size()),
+                       last - first});
+      ways_.insert(ways_.end(), ways.begin() + first, ways.begin() + last);
+      return;
+    }
+  }
+}
+
+void Adjudicator::ResolveGap(Gap* gap) const {
+  // of the pairs of ways that no peg spoils both, the one with the
+  // smallest carrier, to leave most room for other gaps
+  const Way* ways = &ways_[gap->first_way];
+  const int num_ways = gap->num_ways;
+  std::vector<CellSet> carriers(num_ways);
+  std::vector<CellSet> spoilers(num_ways);
+  for (int i = 0; i < num_ways; i++) {
+    AddWayCells(ways[i], &carriers[i], &spoilers[i]);
+  }
+  int best_count = -1;
+  for (int i = 0; i < num_ways; i++) {
+    for (int j = i + 1; j < num_ways; j++) {
+      if (ways[i].hole == ways[j].hole ||
+          spoilers[i].Intersects(spoilers[j])) {
+        continue;
+      }
+      CellSet carrier = carriers[i];
+      carrier.Insert(carriers[j]);
+      int count = carrier.Count();
+      if (best_count < 0 || count < best_count) {
+        best_count = count;
+        gap->carrier = carrier;
+      }
+    }
+  }
+  gap->resolved = true;
+  gap->safe = best_count >= 0;
+}
+
+void Adjudicator::FindGaps() {
+  const int num_groups = group_starts_.size() - 1;
+  const int border_nodes[kMaxBorder] = {num_groups, num_groups + 1};
+  const Border borders[kMaxBorder] = {kStart, kEnd};
+  std::vector<Way> border_ways[kMaxBorder];
+  // bridges to groups of higher index, with the other group in the
+  // link of the way at index 1
+  std::vector<Way> bridges;
+
+  for (int group = 0; group < num_groups; group++) {
+    const Position* begin = &pegs_[group_starts_[group]];
+    const Position* end = &pegs_[0] + group_starts_[group + 1];
+    bool linked[kMaxBorder] = {false, false};
+    for (const Position* peg = begin; peg != end; peg++) {
+      for (Border border : borders) {
+        linked[border] |=
+            board_.GetConstCell(*peg).IsLinkedToBorder(player_, border);
+      }
+    }
+    for (Border border : borders) {
+      border_ways[border].clear();
+    }
+    bridges.clear();
+
+    for (const Position* peg = begin; peg != end; peg++) {
+      for (int dir = 0; dir < kMaxCompass; dir++) {
+        Position hole = *peg + GetLinkDescriptor(dir).offsets;
+        if (!OnBoard(hole) || !board_.IsLegalAction(player_, Index(hole)) ||
+            IsBlocked({*peg, dir})) {
+          continue;
+        }
+        for (Border border : borders) {
+          if (!linked[border] && IsOnBorder(hole, border)) {
+            border_ways[border].push_back({hole, {{*peg, dir}}, 1});
+          }
+        }
+        for (int dir2 = 0; dir2 < kMaxCompass; dir2++) {
+          Position other = hole + GetLinkDescriptor(dir2).offsets;
+          // each bridge is found from the group with the lower index
+          if (!OnBoard(other) || Color(other) != player_ ||
+              groups_[Index(other)] <= group || IsBlocked({hole, dir2})) {
+            continue;
+          }
+          bridges.push_back({hole, {{*peg, dir}, {hole, dir2}}, 2});
+        }
+      }
+    }
+
+    for (Border border : borders) {
+      if (linked[border]) {
+        gaps_.push_back({group, border_nodes[border], false, 0, 0});
+      } else {
+        AddGap(group, border_nodes[border], border_ways[border], 0,
+               border_ways[border].size());
+      }
+    }
+
+    auto other_group = [this](const Way& way) {
+      const Link& link = way.links[1];
+      return groups_[Index(link.position +
+                           GetLinkDescriptor(link.direction).offsets)];
+    };
+    std::stable_sort(bridges.begin(), bridges.end(),
+                     [&other_group](const Way& a, const Way& b) {
+                       return other_group(a) < other_group(b);
+                     });
+    const int num_bridges = bridges.size();
+    for (int first = 0, last = 0; first < num_bridges; first = last) {
+      while (last < num_bridges &&
+             other_group(bridges[last]) == other_group(bridges[first])) {
+        last++;
+      }
+      AddGap(group, other_group(bridges[first]), bridges, first, last);
+    }
+  }
+}
+
+bool Adjudicator::Search(int node, const CellSet& used, int num_gaps) {
+  const int end_node = group_starts_.size();
+  if (node == end_node) {
+    // every round of the player closing a gap and the opponent answering
+    // takes at most two of the opponent's legal actions
+    return board_.num_legal_actions(opponent_) > 2 * num_gaps;
+  }
+  for (int index : node_gaps_[node]) {
+    Gap& gap = gaps_[index];
+    int next = gap.from == node ? gap.to : gap.from;
+    if (on_path_[next]) {
+      continue;
+    }
+    if (gap.is_gap && !gap.resolved) {
+      ResolveGap(&gap);
+    }
+    if (gap.is_gap && (!gap.safe || used.Intersects(gap.carrier))) {
+      continue;
+    }
+    if (++steps_ > kMaxSearchSteps) {
+      return false;
+    }
+    CellSet next_used = used;
+    next_used.Insert(gap.carrier);
+    on_path_[next] = true;
+    if (Search(next, next_used, num_gaps + gap.is_gap)) {
+      return true;
+    }
+    on_path_[next] = false;
+  }
+  return false;
+}
+
+bool Adjudicator::Run() {
+  FindGroups();
+  FindGaps();
+  const int num_nodes = group_starts_.size() + 1;
+  const int start_node = num_nodes - 2;
+  node_gaps_.resize(num_nodes);
+  for (int i = 0; i < static_cast<int>(gaps_.size()); i++) {
+    node_gaps_[gaps_[i].from].push_back(i);
+    node_gaps_[gaps_[i].to].push_back(i);
+  }
+
+  // most positions fail already without regard to the carriers, which are
+  // only worked out for the gaps the search gets to
+  std::vector<bool> reached(num_nodes, false);
+  std::vector<int> queue = {start_node};
+  reached[start_node] = true;
+  for (int i = 0; i < static_cast<int>(queue.size()); i++) {
+    for (int index : node_gaps_[queue[i]]) {
+      int next = gaps_[index].from == queue[i] ? gaps_[index].to
+                                               : gaps_[index].from;
+      if (!reached[next]) {
+        reached[next] = true;
+        queue.push_back(next);
+      }
+    }
+  }
+  if (!reached[num_nodes - 1]) {
+    return false;
+  }
+
+  on_path_.assign(num_nodes, false);
+  on_path_[start_node] = true;
+  return Search(start_node, CellSet(), 0);
+}
+
+}  // namespace
+
+bool HasUnbreakableConnection(const Board& board, Player player) {
+  return Adjudicator(board, player).Run();
+}
+
+}  // namespace twixt
+}  // namespace open_spiel
@@ -0,0 +1,47 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_GAMES_TWIXT_TWIXTADJUDICATE_H_
+#define OPEN_SPIEL_GAMES_TWIXT_TWIXTADJUDICATE_H_
+
+#include "open_spiel/games/twixt/twixtboard.h"
+#include "open_spiel/spiel.h"
+
+// Early adjudication, see the adjudicate game parameter.
+//
+// A player's connection is unbreakable if the linked groups of the player
+// can be joined to each other and to both borders of the player through
+// gaps, each of which can be closed in two ways (a peg in a hole and its
+// links), such that
+// * no single opponent peg spoils both ways of a gap; a peg spoils a way
+//   by taking its hole or by a link to an opponent peg that crosses one of
+//   the links of the way,
+// * the cells that matter to different gaps are disjoint, so that no move
+//   of either player affects two gaps,
+// * the opponent has legal moves left until all gaps are closed.
+// The player then wins by answering every move into a gap with the other
+// way of the same gap. Other formations are not recognized, so the test
+// errs on the side of playing on.
+
+namespace open_spiel {
+namespace twixt {
+
+// true if player has an unbreakable connection on board; the opponent is
+// to move, and the swap must no longer be possible
+bool HasUnbreakableConnection(const Board& board, Player player);
+
+}  // namespace twixt
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_GAMES_TWIXT_TWIXTADJUDICATE_H_
@@ -0,0 +1,219 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/games/twixt/twixtagent.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace open_spiel {
+namespace twixt {
+
+float ResultValue(int result, Player player) {
+  if (result == kDraw) {
+    return 0;
+  }
+  return (result == kRedWin) == (player == kRedPlayer) ? 1 : -1;
+}
+
+Action RandomAgent::Step(const TwixTState& state, std::mt19937* rng) {
+  state.LegalActions(&actions_);
+  SPIEL_CHECK_FALSE(actions_.empty());
+  return actions_[(*rng)() % actions_.size()];
+}
+
+double SearchStats::LatencyPercentile(double fraction) const {
+  int64_t count = 0;
+  for (int bucket = 0; bucket < kNumLatencyBuckets; bucket++) {
+    count += latency_counts[bucket];
+    if (count > 0 && count >= fraction * num_moves) {
+      return (bucket + 1) * kLatencyBucketSeconds;
+    }
+  }
+  return kNumLatencyBuckets * kLatencyBucketSeconds;
+}
+
+MctsAgent::MctsAgent(const Game& game, const MctsOptions& options,
+                     LeafEvaluator* evaluator)
+    : options_(options),
+      evaluator_(evaluator),
+      rollout_policy_(static_cast<const TwixTGame&>(game).board_size()),
+      empty_board_(static_cast<const TwixTGame&>(game).board_size(), false),
+      scratch_(static_cast<TwixTState*>(game.NewInitialState().release())) {
+  SPIEL_CHECK_EQ(game.GetType().short_name, "twixt");
+  SPIEL_CHECK_GT(options.num_simulations, 0);
+  SPIEL_CHECK_GT(options.max_nodes, 0);
+  path_.reserve(game.MaxGameLength() + 1);
+  movers_.reserve(game.MaxGameLength() + 1);
+  if (evaluator_ != nullptr) {
+    observation_.resize(game.ObservationTensorSize());
+    priors_.resize(game.NumDistinctActions());
+  }
+}
+
+Action MctsAgent::Step(const TwixTState& state, std::mt19937* rng) {
+  if (options_.move_seconds > 0) {
+    return StepUntil(
+        state, rng,
+        Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                           std::chrono::duration<double>(
+                               options_.move_seconds)));
+  }
+  const Clock::time_point start = Clock::now();
+  SPIEL_CHECK_FALSE(state.IsTerminal());
+  nodes_.assign(1, {-1, 0, 0, 1, -1, 0});
+  for (int simulation = 0; simulation < options_.num_simulations;
+       simulation++) {
+    Simulate(state, rng);
+  }
+  best_ = BestChild(rng);
+  AddLatency(start, Clock::time_point::max());
+  return nodes_[best_].action;
+}
+
+Action MctsAgent::StepUntil(const TwixTState& state, std::mt19937* rng,
+                            Clock::time_point deadline) {
+  const Clock::time_point start = Clock::now();
+  SPIEL_CHECK_FALSE(state.IsTerminal());
+  nodes_.assign(1, {-1, 0, 0, 1, -1, 0});
+  Clock::duration longest(0);
+  Clock::time_point now = start;
+  do {
+    Simulate(state, rng);
+    Clock::time_point end = Clock::now();
+    longest = std::max(longest, end - now);
+    now = end;
+  } while (now + longest < deadline);
+  best_ = BestChild(rng);
+  AddLatency(start, deadline);
+  return nodes_[best_].action;
+}
+
+void MctsAgent::Simulate(const TwixTState& state, std::mt19937* rng) {
+  state.CloneInto(scratch_.get());
+  path_.assign(1, 0);
+  movers_.assign(1, kInvalidPlayer);
+  int node = 0;
+  while (nodes_[node].first_child >= 0) {
+    node = SelectChild(node);
+    movers_.push_back(scratch_->CurrentPlayer());
+    scratch_->ApplyAction(nodes_[node].action);
+    path_.push_back(node);
+  }
+  const Player player = scratch_->CurrentPlayer();
+  if (scratch_->IsTerminal()) {
+    Backup(ResultValue(scratch_->board().result(), kRedPlayer));
+  } else {
+    float value = Expand(node, rng);
+    Backup(player == kRedPlayer ? value : -value);
+  }
+  stats_.num_simulations++;
+}
+
+int MctsAgent::BestChild(std::mt19937* rng) const {
+  const Node& root = nodes_[0];
+  int best = root.first_child;
+  for (int i = root.first_child; i < root.first_child + root.num_children;
+       i++) {
+    if (nodes_[i].visits > nodes_[best].visits) {
+      best = i;
+    }
+  }
+  if (nodes_[best].visits == 0) {
+    best = root.first_child + (*rng)() % root.num_children;
+  }
+  return best;
+}
+
+void MctsAgent::AddLatency(Clock::time_point start,
+                           Clock::time_point deadline) {
+  const Clock::time_point end = Clock::now();
+  const double latency = std::chrono::duration<double>(end - start).count();
+  stats_.num_moves++;
+  stats_.num_overruns += end > deadline;
+  stats_.total_latency += latency;
+  stats_.max_latency = std::max(stats_.max_latency, latency);
+  stats_.latency_counts[std::min<int64_t>(latency / kLatencyBucketSeconds,
+                                          kNumLatencyBuckets - 1)]++;
+}
+
+int MctsAgent::SelectChild(int node) const {
+  const Node& parent = nodes_[node];
+  const float scale = options_.uct_c * std::sqrt(parent.visits);
+  int best = parent.first_child;
+  float best_score = -1e30;
+  for (int i = parent.first_child;
+       i < parent.first_child + parent.num_children; i++) {
+    const Node& child = nodes_[i];
+    float q = child.visits > 0 ? child.value_sum / child.visits : 0;
+    float score = q + scale * child.prior / (1 + child.visits);
+    if (score > best_score) {
+      best_score = score;
+      best = i;
+    }
+  }
+  return best;
+}
+
+float MctsAgent::Expand(int node, std::mt19937* rng) {
+  const Player player = scratch_->CurrentPlayer();
+  if (options_.prune_useless_moves) {
+    scratch_->board().GetLiveLegalActions(player, &legal_);
+  } else {
+    scratch_->LegalActions(&legal_);
+  }
+  SPIEL_CHECK_FALSE(legal_.empty());
+
+  float value;
+  float sum = 0;
+  if (evaluator_ != nullptr) {
+    scratch_->ObservationTensor(player, absl::MakeSpan(observation_));
+    evaluator_->Evaluate(1, observation_.data(), priors_.data(), &value);
+    for (Action action : legal_) {
+      sum += priors_[action];
+    }
+  } else {
+    rollout_board_ = scratch_->board();
+    value = ResultValue(rollout_policy_.Rollout(&rollout_board_, rng),
+                        player);
+    // give up the columns shared with scratch_, so that CloneInto can
+    // reuse them
+    rollout_board_ = empty_board_;
+  }
+
+  if (node != 0 &&
+      static_cast<int>(nodes_.size() + legal_.size()) > options_.max_nodes) {
+    return value;
+  }
+  nodes_[node].first_child = nodes_.size();
+  nodes_[node].num_children = legal_.size();
+  stats_.num_nodes += legal_.size();
+  for (Action action : legal_) {
+    float prior =
+        sum > 0 ? priors_[action] / sum : 1.0f / legal_.size();
+    nodes_.push_back({-1, 0, 0, prior, static_cast<int16_t>(action), 0});
+  }
+  return value;
+}
+
+void MctsAgent::Backup(float red_value) {
+  for (int i = path_.size() - 1; i >= 0; i--) {
+    nodes_[path_[i]].visits++;
+    nodes_[path_[i]].value_sum +=
+        movers_[i] == kBluePlayer ? -red_value : red_value;
+  }
+}
+
+}  // namespace twixt
+}  // namespace open_spiel
@@ -0,0 +1,175 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_GAMES_TWIXT_TWIXTAGENT_H_
+#define OPEN_SPIEL_GAMES_TWIXT_TWIXTAGENT_H_
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "open_spiel/games/twixt/twixt.h"
+#include "open_spiel/games/twixt/twixtrollout.h"
+#include "open_spiel/games/twixt/twixtselfplay.h"
+#include "open_spiel/spiel.h"
+
+// Players of whole TwixT games, e.g. for tournaments (twixttournament.h).
+//
+// An agent chooses the move of the player to move from the state alone;
+// all randomness comes from the generator it is given. An agent is used
+// by one thread at a time.
+
+namespace open_spiel {
+namespace twixt {
+
+// the value of a finished game (kRedWin, kBlueWin or kDraw) for player,
+// 1, -1 or 0; unlike State::Returns, it does not allocate
+float ResultValue(int result, Player player);
+
+class Agent {
+ public:
+  virtual ~Agent() = default;
+  // the move of the player to move; state is not terminal
+  virtual Action Step(const TwixTState& state, std::mt19937* rng) = 0;
+};
+
+// uniform over the legal moves, the swap included
+class RandomAgent : public Agent {
+ public:
+  Action Step(const TwixTState& state, std::mt19937* rng) override;
+
+ private:
+  std::vector<Action> actions_;
+};
+
+struct MctsOptions {
+  int num_simulations = 1000;  // per move, unless move_seconds is set
+  // if > 0, Step searches until this time is up (see StepUntil) instead
+  double move_seconds = 0;
+  double uct_c = 1.5;
+  // no children for useless moves, see Board::GetLiveLegalActions
+  bool prune_useless_moves = false;
+  // bound of the tree (the root is always expanded); leaves beyond it are
+  // valued but not expanded
+  int max_nodes = 1 << 20;
+};
+
+// move latencies are counted in buckets of kLatencyBucketSeconds, the
+// last bucket also counts all longer ones
+const double kLatencyBucketSeconds = 50e-6;
+const int kNumLatencyBuckets = 20000;
+
+struct SearchStats {
+  SearchStats() : latency_counts(kNumLatencyBuckets) {}
+
+  int64_t num_moves = 0;
+  int64_t num_simulations = 0;
+  int64_t num_nodes = 0;     // tree nodes created
+  int64_t num_overruns = 0;  // moves returned after their deadline
+  double total_latency = 0;  // seconds
+  double max_latency = 0;
+  std::vector<int64_t> latency_counts;
+
+  // the upper end of the bucket of the latency that at least fraction of
+  // the moves do not exceed, in seconds
+  double LatencyPercentile(double fraction) const;
+};
+
+// PUCT search of num_simulations simulations per move, or of as many as
+// fit into a time, which plays the most visited move. With an evaluator,
+// the leaves get their priors (by action) and values from it, one
+// observation at a time; without, the priors are uniform and a leaf is
+// valued by one rollout of RolloutPolicy. The agent does not own the
+// evaluator, which must not be shared with another thread.
+//
+// The tree keeps its memory from move to move; once it has been as large
+// as the trees of the coming moves (at most max_nodes), Step does not
+// allocate: the simulations copy the state with CloneInto and use buffers
+// of the agent (the state has no undo).
+class MctsAgent : public Agent {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  MctsAgent(const Game& game, const MctsOptions& options,
+            LeafEvaluator* evaluator = nullptr);
+
+  Action Step(const TwixTState& state, std::mt19937* rng) override;
+
+  // Anytime search: runs simulations while the longest one of this move
+  // would still end before deadline and returns the most visited move so
+  // far. The first simulation, which expands the root, always runs, so
+  // the move is legal even if deadline has passed; it is late only if
+  // that simulation is longer than the time left.
+  Action StepUntil(const TwixTState& state, std::mt19937* rng,
+                   Clock::time_point deadline);
+
+  // of all moves since the agent was made or the stats were reset
+  const SearchStats& stats() const { return stats_; }
+  void ResetStats() { stats_ = SearchStats(); }
+
+  // of the last search: the simulations, and the visits and mean value
+  // (for the player to move, 0 if unvisited) of the move it returned
+  int root_visits() const { return nodes_[0].visits; }
+  int move_visits() const { return nodes_[best_].visits; }
+  float move_value() const {
+    const Node& node = nodes_[best_];
+    return node.visits > 0 ? node.value_sum / node.visits : 0;
+  }
+
+ private:
+  struct Node {
+    int32_t first_child;  // -1 if not expanded
+    int32_t visits;
+    float value_sum;  // for the player who moved into the node
+    float prior;
+    int16_t action;
+    int16_t num_children;
+  };
+
+  // runs one simulation from state
+  void Simulate(const TwixTState& state, std::mt19937* rng);
+  // the most visited child of the root, a random one if none is visited
+  int BestChild(std::mt19937* rng) const;
+  void AddLatency(Clock::time_point start, Clock::time_point deadline);
+  int SelectChild(int node) const;
+  // expands the leaf, the state of scratch_, and returns its value for
+  // the player to move there
+  float Expand(int node, std::mt19937* rng);
+  // red_value is the value for red; a player may move twice in a row
+  // (link removals), so each node gets it for the player who moved into
+  // it instead of alternating signs
+  void Backup(float red_value);
+
+  MctsOptions options_;
+  LeafEvaluator* evaluator_;  // null: uniform priors and rollouts
+  RolloutPolicy rollout_policy_;
+  Board empty_board_;
+  Board rollout_board_;
+  std::unique_ptr<TwixTState> scratch_;  // the state of a simulation
+  std::vector<Node> nodes_;              // the tree, nodes_[0] is the root
+  std::vector<int> path_;                // from the root to the leaf
+  std::vector<Player> movers_;           // who moved into each of them
+  std::vector<Action> legal_;
+  std::vector<float> observation_;
+  std::vector<float> priors_;
+  int best_ = 0;  // the child played by the last search
+  SearchStats stats_;
+};
+
+}  // namespace twixt
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_GAMES_TWIXT_TWIXTAGENT_H_
@@ -0,0 +1,333 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/games/twixt/twixtbatch.h"
+
+#include <algorithm>
+
+namespace open_spiel {
+namespace twixt {
+
+BatchBoard::BatchBoard(int board_size, int num_games)
+    : size_(board_size),
+      num_games_(num_games),
+      num_cells_(board_size * board_size) {
+  SPIEL_CHECK_GE(size_, kMinBoardSize);
+  SPIEL_CHECK_LE(size_, kMaxBoardSize);
+  SPIEL_CHECK_GT(num_games_, 0);
+  const int padding = num_cells_;
+
+  // same as Board::PositionIsOffBoard and Board::PositionIsOnBorder
+  auto off_board = [this](Position p) {
+    return p.x < 0 || p.x >= size_ || p.y < 0 || p.y >= size_ ||
+           ((p.x == 0 || p.x == size_ - 1) && (p.y == 0 || p.y == size_ - 1));
+  };
+  auto on_border = [this](Player player, Position p) {
+    if (player == kRedPlayer) {
+      return (p.y == 0 || p.y == size_ - 1) && p.x > 0 && p.x < size_ - 1;
+    }
+    return (p.x == 0 || p.x == size_ - 1) && p.y > 0 && p.y < size_ - 1;
+  };
+  auto cell_of = [this](Position p) { return p.x * size_ + p.y; };
+
+  initial_words_.assign(num_cells_ + 1, kOffBoard << kColorShift);
+  for (Player p = 0; p < kNumPlayers; p++) {
+    static_legal_[p].assign(num_cells_ + 1, 0);
+    num_static_legal_[p] = 0;
+  }
+  for (int dir = 0; dir < kMaxCompass; dir++) {
+    const LinkDescriptor& ld = GetLinkDescriptor(dir);
+    SPIEL_CHECK_EQ(static_cast<int>(ld.blocking_links.size()), kNumBlockers);
+    neighbors_[dir].assign(num_cells_ + 1, padding);
+    for (int j = 0; j < kNumBlockers; j++) {
+      blockers_[dir][j].assign(num_cells_ + 1, padding);
+      blocker_dirs_[dir][j] = ld.blocking_links[j].direction;
+    }
+  }
+
+  for (int x = 0; x < size_; x++) {
+    for (int y = 0; y < size_; y++) {
+      Position position = {x, y};
+      const int cell = cell_of(position);
+      if (off_board(position)) {
+        continue;
+      }
+      initial_words_[cell] = kEmpty << kColorShift;
+      // the border flags of Board::InitializeCells
+      if (x == 0 || y == 0) {
+        initial_words_[cell] |= 1 << (kFlagsShift + kStart);
+      } else if (x == size_ - 1 || y == size_ - 1) {
+        initial_words_[cell] |= 1 << (kFlagsShift + kEnd);
+      }
+      for (Player p = 0; p < kNumPlayers; p++) {
+        if (!on_border(1 - p, position)) {
+          static_legal_[p][cell] = 1;
+          num_static_legal_[p]++;
+        }
+      }
+
+      for (int dir = 0; dir < kMaxCompass; dir++) {
+        const LinkDescriptor& ld = GetLinkDescriptor(dir);
+        Position target = position + ld.offsets;
+        if (off_board(target)) {
+          continue;
+        }
+        neighbors_[dir][cell] = cell_of(target);
+        for (int j = 0; j < kNumBlockers; j++) {
+          const Link& blocker = ld.blocking_links[j];
+          Position from = position + blocker.position;
+          Position to = from + GetLinkDescriptor(blocker.direction).offsets;
+          if (!off_board(from) && !off_board(to)) {
+            blockers_[dir][j][cell] = cell_of(from);
+          }
+        }
+      }
+    }
+  }
+
+  words_.resize(static_cast<size_t>(num_cells_ + 1) * num_games_);
+  results_.resize(num_games_);
+  move_counters_.resize(num_games_);
+  move_one_.resize(num_games_);
+  for (Player p = 0; p < kNumPlayers; p++) {
+    num_legal_[p].resize(num_games_);
+  }
+  swapped_.resize(num_games_);
+  move_cells_.resize(num_games_);
+  players_.resize(num_games_);
+  gains_.resize(num_games_);
+  neutral_.resize(num_games_);
+  Reset();
+}
+
+void BatchBoard::Reset() {
+  const int k = num_games_;
+  for (int cell = 0; cell <= num_cells_; cell++) {
+    std::fill_n(&words_[cell * k], k, initial_words_[cell]);
+  }
+  std::fill(results_.begin(), results_.end(), kOpen);
+  std::fill(move_counters_.begin(), move_counters_.end(), 0);
+  std::fill(move_one_.begin(), move_one_.end(), 0);
+  for (Player p = 0; p < kNumPlayers; p++) {
+    std::fill(num_legal_[p].begin(), num_legal_[p].end(),
+              num_static_legal_[p]);
+  }
+  std::fill(swapped_.begin(), swapped_.end(), 0);
+}
+
+void BatchBoard::ResetGame(int game) {
+  const int k = num_games_;
+  for (int cell = 0; cell <= num_cells_; cell++) {
+    words_[cell * k + game] = initial_words_[cell];
+  }
+  results_[game] = kOpen;
+  move_counters_[game] = 0;
+  move_one_[game] = 0;
+  for (Player p = 0; p < kNumPlayers; p++) {
+    num_legal_[p][game] = num_static_legal_[p];
+  }
+  swapped_[game] = 0;
+}
+
+Player BatchBoard::current_player(int game) const {
+  return results_[game] == kOpen ? move_counters_[game] % 2
+                                 : kTerminalPlayerId;
+}
+
+bool BatchBoard::IsLegalAction(int game, Action action) const {
+  if (action < 0 || action >= num_cells_ || results_[game] != kOpen) {
+    return false;
+  }
+  // the first move stays legal for the swap
+  return static_legal_[current_player(game)][action] &&
+         (color(game, action) == kEmpty ||
+          (move_counters_[game] == 1 && action == move_one_[game]));
+}
+
+std::vector<Action> BatchBoard::LegalActions(int game) const {
+  std::vector<Action> actions;
+  for (Action action = 0; action < num_cells_; action++) {
+    if (IsLegalAction(game, action)) {
+      actions.push_back(action);
+    }
+  }
+  return actions;
+}
+
+void BatchBoard::PrepareMove(int game, Action action) {
+  if (!IsLegalAction(game, action)) {
+    SpielFatalError("Not a legal action: " + std::to_string(action));
+  }
+  const Player player = move_counters_[game] % 2;
+  int cell = action;
+  if (move_counters_[game] == 1) {
+    const int one = move_one_[game];
+    if (action == one) {
+      // swap: remove the first peg (it has no links yet), make all
+      // cells legal again and turn the position by 90 degrees
+      swapped_[game] = 1;
+      uint32_t& word = words_[one * num_games_ + game];
+      word = (word & ~(0xffu << kColorShift)) | (kEmpty << kColorShift);
+      for (Player p = 0; p < kNumPlayers; p++) {
+        num_legal_[p][game] = num_static_legal_[p];
+      }
+      cell = (one % size_) * size_ + (size_ - one / size_ - 1);
+    } else {
+      for (Player p = 0; p < kNumPlayers; p++) {
+        num_legal_[p][game] -= static_legal_[p][one];
+      }
+    }
+  }
+  move_cells_[game] = cell;
+  players_[game] = player;
+}
+
+void BatchBoard::ApplyActions(absl::Span<const Action> actions) {
+  SPIEL_CHECK_EQ(static_cast<int>(actions.size()), num_games_);
+  const int k = num_games_;
+  const int padding = num_cells_;
+  for (int g = 0; g < k; g++) {
+    if (actions[g] < 0 || results_[g] != kOpen) {
+      move_cells_[g] = padding;
+      players_[g] = kRedPlayer;
+    } else {
+      PrepareMove(g, actions[g]);
+    }
+  }
+
+  // the loops over g below run the same instructions for every game
+  uint32_t* words = words_.data();
+  const int32_t* cells = move_cells_.data();
+  const int32_t* players = players_.data();
+  int32_t* gains = gains_.data();
+  int32_t* neutral = neutral_.data();
+
+  for (int g = 0; g < k; g++) {
+    const int c = cells[g];
+    // the padding cell keeps its off-board color
+    const uint32_t color = c == padding ? kOffBoard : players[g];
+    words[c * k + g] =
+        (words[c * k + g] & ~(0xffu << kColorShift)) | (color << kColorShift);
+    gains[g] = 0;
+    neutral[g] = 0;
+  }
+
+  // the games are processed in tiles, so that the cells a tile touches
+  // stay in cache for all eight directions
+  for (int tile = 0; tile < k; tile += kTileGames) {
+    const int tile_end = std::min(k, tile + kTileGames);
+    for (int dir = 0; dir < kMaxCompass; dir++) {
+      const int32_t* neighbor = neighbors_[dir].data();
+      const int32_t* blocker[kNumBlockers];
+      int blocker_shift[kNumBlockers];
+      for (int j = 0; j < kNumBlockers; j++) {
+        blocker[j] = blockers_[dir][j].data();
+        blocker_shift[j] = kLinksShift + blocker_dirs_[dir][j];
+      }
+      const int opp_dir = (dir + kMaxCompass / 2) % kMaxCompass;
+
+      for (int g = tile; g < tile_end; g++) {
+        const int c = cells[g];
+        const int t = neighbor[c];
+        const uint32_t target = words[t * k + g];
+        const uint32_t same =
+            ((target >> kColorShift) & 0xff) ==
+            static_cast<uint32_t>(players[g]);
+        uint32_t is_blocked = 0;
+        for (int j = 0; j < kNumBlockers; j++) {
+          is_blocked |= words[blocker[j][c] * k + g] >> blocker_shift[j];
+        }
+        is_blocked &= 1;
+        const uint32_t link = same & (is_blocked ^ 1);
+        const uint32_t block = same & is_blocked;
+        words[c * k + g] |= (link << (kLinksShift + dir)) |
+                            (block << (kBlockedShift + dir));
+        words[t * k + g] |= (link << (kLinksShift + opp_dir)) |
+                            (block << (kBlockedShift + opp_dir));
+        // as in Board: a target linked to START passes on START, otherwise
+        // one linked to END passes on END
+        const int target_flags = link ? target >> kFlagsShift : 0;
+        gains[g] |= (target_flags & (1 << kStart))
+                        ? (1 << kStart)
+                        : (target_flags & (1 << kEnd));
+        neutral[g] |= link & (target_flags == 0);
+      }
+    }
+  }
+
+  for (int g = 0; g < k; g++) {
+    const int c = cells[g];
+    words[c * k + g] |= gains[g] << kFlagsShift;
+  }
+
+  // a border connected peg linked to a neutral group passes the border on
+  for (int g = 0; g < k; g++) {
+    if (neutral[g]) {
+      const int c = cells[g];
+      for (Border border : {kStart, kEnd}) {
+        if (IsLinkedToBorder(g, c, border)) {
+          ExploreLocalGraph(g, c, border);
+        }
+      }
+    }
+  }
+
+  int32_t* num_legal_red = num_legal_[kRedPlayer].data();
+  int32_t* num_legal_blue = num_legal_[kBluePlayer].data();
+  const uint8_t* legal_red = static_legal_[kRedPlayer].data();
+  const uint8_t* legal_blue = static_legal_[kBluePlayer].data();
+  int32_t* results = results_.data();
+  int32_t* move_counters = move_counters_.data();
+  int32_t* move_one = move_one_.data();
+  for (int g = 0; g < k; g++) {
+    const int c = cells[g];
+    const int active = c != padding;
+    const int first_move = move_counters[g] == 0;
+    // the first move is only removed from the legal actions at the second,
+    // since it stays legal for the swap
+    const int remove = active & (first_move ^ 1);
+    num_legal_red[g] -= remove & legal_red[c];
+    num_legal_blue[g] -= remove & legal_blue[c];
+    const int red = players[g] == kRedPlayer;
+    const int win = active & ((words[c * k + g] >> kFlagsShift) == 3);
+    const int draw =
+        active & (red ? num_legal_blue[g] == 0 : num_legal_red[g] == 0);
+    results[g] = win ? (red ? kRedWin : kBlueWin) : draw ? kDraw : results[g];
+    move_one[g] = active & first_move ? c : move_one[g];
+    move_counters[g] += active;
+  }
+}
+
+void BatchBoard::ExploreLocalGraph(int game, int cell, Border border) {
+  // same cells as Board::ExploreLocalGraph, with a stack instead of
+  // recursion; cells are flagged when they are pushed
+  const int k = num_games_;
+  std::vector<int> stack = {cell};
+  while (!stack.empty()) {
+    int c = stack.back();
+    stack.pop_back();
+    for (int dir = 0; dir < kMaxCompass; dir++) {
+      if ((links(game, c) >> dir) & 1) {
+        int t = neighbors_[dir][c];
+        if (!IsLinkedToBorder(game, t, border)) {
+          words_[t * k + game] |= 1 << (kFlagsShift + border);
+          stack.push_back(t);
+        }
+      }
+    }
+  }
+}
+
+}  // namespace twixt
+}  // namespace open_spiel
@@ -0,0 +1,133 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_GAMES_TWIXT_TWIXTBATCH_H_
+#define OPEN_SPIEL_GAMES_TWIXT_TWIXTBATCH_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "open_spiel/games/twixt/twixtboard.h"
+#include "open_spiel/spiel.h"
+
+// K TwixT games stepped in lockstep, stored as structure of arrays.
+//
+// Each cell of each game is one 32-bit word holding its peg color, links,
+// blocked links and border flags, indexed [cell * K + game]: the game index
+// is innermost, so the work of one move is a loop over the games with the
+// same instructions for each. Cells are indexed by action (x * size + y).
+// Off-board targets and blockers are mapped to an extra padding cell whose
+// word makes every test fail, which keeps the loops free of branches;
+// compiled with vectorization for the target (e.g. -O3 -march=native) the
+// blocker tests and link updates run on SIMD lanes of games, with gathers
+// for the per-game cells. Only the propagation of border flags through a
+// linked group, which is irregular, runs game by game, and only for the
+// moves that link a border-connected peg to a neutral group.
+//
+// The game of each index plays exactly like Board::ApplyAction called with
+// the alternating players of TwixTState, including the swap move.
+
+namespace open_spiel {
+namespace twixt {
+
+class BatchBoard {
+ public:
+  BatchBoard(int board_size, int num_games);
+
+  int size() const { return size_; }
+  int num_games() const { return num_games_; }
+
+  void Reset();
+  void ResetGame(int game);
+
+  // applies actions[game] in each game; negative actions and games that are
+  // over are skipped; other illegal actions are a fatal error
+  void ApplyActions(absl::Span<const Action> actions);
+
+  // kOpen, kRedWin, kBlueWin or kDraw of each game
+  absl::Span<const int32_t> results() const { return results_; }
+  int result(int game) const { return results_[game]; }
+  int move_counter(int game) const { return move_counters_[game]; }
+  Player current_player(int game) const;
+  bool swapped(int game) const { return swapped_[game]; }
+  bool IsLegalAction(int game, Action action) const;
+  std::vector<Action> LegalActions(int game) const;
+
+  // the cells of a game, as Cell in Board
+  int color(int game, Action cell) const {
+    return (Word(game, cell) >> kColorShift) & 0xff;
+  }
+  int links(int game, Action cell) const {
+    return (Word(game, cell) >> kLinksShift) & 0xff;
+  }
+  int blocked_neighbors(int game, Action cell) const {
+    return (Word(game, cell) >> kBlockedShift) & 0xff;
+  }
+  // of the player whose peg or border the cell is
+  bool IsLinkedToBorder(int game, Action cell, Border border) const {
+    return (Word(game, cell) >> (kFlagsShift + border)) & 1;
+  }
+
+ private:
+  static const int kNumBlockers = 9;
+  // games per tile of ApplyActions
+  static const int kTileGames = 128;
+
+  // bytes of a cell word
+  static const int kColorShift = 0;
+  static const int kLinksShift = 8;    // bit per direction
+  static const int kBlockedShift = 16;  // bit per direction
+  static const int kFlagsShift = 24;   // bit kStart, bit kEnd
+
+  uint32_t Word(int game, Action cell) const {
+    return words_[cell * num_games_ + game];
+  }
+  void PrepareMove(int game, Action action);
+  void ExploreLocalGraph(int game, int cell, Border border);
+
+  int size_;
+  int num_games_;
+  int num_cells_;  // size * size, the padding cell has index num_cells_
+
+  // cell words, [cell * num_games + game]
+  std::vector<uint32_t> words_;
+
+  // per game
+  std::vector<int32_t> results_;
+  std::vector<int32_t> move_counters_;
+  std::vector<int32_t> move_one_;
+  std::vector<int32_t> num_legal_[kNumPlayers];
+  std::vector<uint8_t> swapped_;
+
+  // the move being applied, per game: its cell (padding if none), player
+  std::vector<int32_t> move_cells_;
+  std::vector<int32_t> players_;
+  std::vector<int32_t> gains_;  // border flags gained from linked pegs
+  std::vector<int32_t> neutral_;  // linked to a peg without border flags
+
+  // tables of the board size, per cell
+  std::vector<int32_t> neighbors_[kMaxCompass];  // target cell or padding
+  // origin of the links that would block a link in each direction, or
+  // padding; the direction of the blocking link is blocker_dirs_
+  std::vector<int32_t> blockers_[kMaxCompass][kNumBlockers];
+  int blocker_dirs_[kMaxCompass][kNumBlockers];
+  std::vector<uint32_t> initial_words_;
+  std::vector<uint8_t> static_legal_[kNumPlayers];
+  int num_static_legal_[kNumPlayers];
+};
+
+}  // namespace twixt
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_GAMES_TWIXT_TWIXTBATCH_H_
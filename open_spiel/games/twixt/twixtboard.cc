@@ -14,6 +14,8 @@
 // limitations under the License.
 
 #include "open_spiel/games/twixt/twixtboard.h"
+
+#include "open_spiel/games/twixt/twixtadjudicate.h"
 #include "open_spiel/games/twixt/twixtcell.h"
 
 namespace open_spiel {
@@ -143,62 +145,59 @@ static const std::vector<LinkDescriptor> kLinkDescriptorTable{
       {{-1, 1}, kESE}}}
 };
 
-
-// helper class: blockerMap stores set of blocking links for each link
-std::unordered_map<Link, std::set<Link>, LinkHashFunction>
-  BlockerMap::map_ = {};
-
-const std::set<Link>& BlockerMap::GetBlockers(Link link) {
-  return BlockerMap::map_[link];
-}
-
-void BlockerMap::PushBlocker(Link link, Link blocked_link) {
-  BlockerMap::map_[link].insert(blocked_link);
+const LinkDescriptor& GetLinkDescriptor(int dir) {
+  return kLinkDescriptorTable[dir];
 }
 
-void BlockerMap::DeleteBlocker(Link link, Link blocked_link) {
-  BlockerMap::map_[link].erase(blocked_link);
+std::string ColumnLabel(int x) {
+  // bijective base 26, as in the column labels of game records
+  std::string label;
+  for (int n = x + 1; n > 0; n = (n - 1) / 26) {
+    label.insert(label.begin(), 'a' + (n - 1) % 26);
+  }
+  return label;
 }
 
-void BlockerMap::ClearBlocker() {
-  BlockerMap::map_.clear();
-}
+thread_local BoardCounters board_counters;
 
+BoardCounters& GetBoardCounters() { return board_counters; }
 
-Board::Board(int size, bool ansi_color_output) {
+Board::Board(int size, bool ansi_color_output, bool adjudicate,
+             bool link_removal) {
   set_size(size);
   set_ansi_color_output(ansi_color_output);
+  adjudicate_ = adjudicate;
+  link_removal_ = link_removal;
+  SPIEL_CHECK_FALSE(adjudicate && link_removal);
 
-  InitializeCells(true);
+  InitializeCells();
   InitializeLegalActions();
-}
-
-void Board::InitializeBlockerMap(Position position, int dir,
-    const LinkDescriptor& ld) {
-  Link link = {position, dir};
-  for (auto &&entry : ld.blocking_links) {
-    Position fromPosition = position + entry.position;
-    if (!PositionIsOffBoard(fromPosition)) {
-      const LinkDescriptor& oppLd = kLinkDescriptorTable[entry.direction];
-      Position toPosition = position + entry.position + oppLd.offsets;
-      if (!PositionIsOffBoard(toPosition)) {
-        BlockerMap::PushBlocker(link, {fromPosition, entry.direction});
-        BlockerMap::PushBlocker(link, {toPosition, OppDir(entry.direction)});
-      }
-    }
+  if (link_removal_) {
+    connectivity_.Reset(size * size + 2 * kNumPlayers,
+                        (kLinkSlotsPerCell + 1) * size * size);
   }
 }
 
 void Board::UpdateResult(Player player, Position position) {
   // check for WIN
-  bool connected_to_start = GetCell(position).IsLinkedToBorder(player, kStart);
-  bool connected_to_end = GetCell(position).IsLinkedToBorder(player, kEnd);
-  if (connected_to_start && connected_to_end) {
+  const Cell& cell = GetConstCell(position);
+  bool connected_to_start = cell.IsLinkedToBorder(player, kStart);
+  bool connected_to_end = cell.IsLinkedToBorder(player, kEnd);
+  if (link_removal_ ? BordersConnected(player)
+                    : connected_to_start && connected_to_end) {
     // peg is linked to both boarder lines
     set_result(player == kRedPlayer ? kRedWin : kBlueWin);
     return;
   }
 
+  // adjudicate once the swap is over: the opponent cannot prevent the
+  // connection any more
+  if (adjudicate_ && move_counter() >= 2 &&
+      HasUnbreakableConnection(*this, player)) {
+    set_result(player == kRedPlayer ? kRedWin : kBlueWin);
+    return;
+  }
+
   // check if opponent (player to turn next) has any legal moves left
   if (!HasLegalActions(1 - player)) {
     set_result(kDraw);
@@ -206,9 +205,66 @@ void Board::UpdateResult(Player player, Position position) {
   }
 }
 
-void Board::InitializeCells(bool init_blocker_map) {
-  cell_.resize(size(), std::vector<Cell>(size()));
-  BlockerMap::ClearBlocker();
+Columns& Columns::operator=(const Columns& other) {
+  if (this != &other) {
+    spares_.reserve(columns_.size());
+    for (std::shared_ptr<std::vector<Cell>>& column : columns_) {
+      if (column.use_count() == 1 && spares_.size() < columns_.size()) {
+        spares_.push_back(std::move(column));
+      }
+    }
+    columns_ = other.columns_;
+  }
+  return *this;
+}
+
+void Columns::Reset(int size) {
+  columns_.clear();
+  for (int x = 0; x < size; x++) {
+    columns_.push_back(std::make_shared<std::vector<Cell>>(size));
+  }
+}
+
+void Columns::Unshare(int x) {
+  if (spares_.empty()) {
+    columns_[x] = std::make_shared<std::vector<Cell>>(*columns_[x]);
+  } else {
+    *spares_.back() = *columns_[x];
+    columns_[x] = std::move(spares_.back());
+    spares_.pop_back();
+  }
+}
+
+SharedConnectivity& SharedConnectivity::operator=(
+    const SharedConnectivity& other) {
+  if (this != &other && connectivity_ != other.connectivity_) {
+    if (connectivity_.use_count() == 1) {
+      spare_ = std::move(connectivity_);
+    }
+    connectivity_ = other.connectivity_;
+  }
+  return *this;
+}
+
+DynamicConnectivity* SharedConnectivity::Mutable() {
+  if (connectivity_.use_count() > 1) {
+    if (spare_ == nullptr) {
+      connectivity_ = std::make_shared<DynamicConnectivity>(*connectivity_);
+    } else {
+      *spare_ = *connectivity_;
+      connectivity_ = std::move(spare_);
+    }
+  }
+  return connectivity_.get();
+}
+
+void SharedConnectivity::Reset(int num_vertices, int num_edges) {
+  connectivity_ = std::make_shared<DynamicConnectivity>();
+  connectivity_->Reset(num_vertices, num_edges);
+}
+
+void Board::InitializeCells() {
+  columns_.Reset(size());
 
   for (int x = 0; x < size(); x++) {
     for (int y = 0; y < size(); y++) {
@@ -229,62 +285,194 @@ void Board::InitializeCells(bool init_blocker_map) {
         } else if (y == size() - 1) {
           cell.SetLinkedToBorder(kRedPlayer, kEnd);
         }
-        InitializeNeighbors(position, cell, init_blocker_map);
       }
     }
   }
 }
 
-void Board::InitializeNeighbors(Position position, Cell& cell,
-    bool init_blocker_map) {
-  for (int dir = 0; dir < kMaxCompass; dir++) {
-    const LinkDescriptor& ld = kLinkDescriptorTable[dir];
-    Position target_position = position + ld.offsets;
-    if (!PositionIsOffBoard(target_position)) {
-      if (init_blocker_map) {
-        InitializeBlockerMap(position, dir, ld);
+void Board::InitializeLegalActions() {
+  for (Player p = 0; p < kNumPlayers; p++) {
+    std::fill(legal_actions_[p], legal_actions_[p] + kLegalActionWords, 0);
+    num_legal_actions_[p] = 0;
+  }
+
+  for (int col = 0; col < size(); col++) {
+    for (int row = 0; row < size(); row++) {
+      Position pos = {col, row};
+      Action action = col * size() + row;
+      for (Player p = 0; p < kNumPlayers; p++) {
+        // a player can neither use the corners nor the opponent's endlines
+        if (!PositionIsOffBoard(pos) && !PositionIsOnBorder(1 - p, pos)) {
+          legal_actions_[p][action / 64] |= 1ULL << (action % 64);
+          num_legal_actions_[p]++;
+        }
       }
-      cell.SetNeighbor(dir, target_position);
     }
   }
 }
 
-void Board::InitializeLegalActions() {
-  int num_legal_actions_per_player = size() * (size() - 2);
+bool Board::IsLegalLinkRemoval(Player player, Action action) const {
+  if (action < size() * size() ||
+      action >= (kLinkSlotsPerCell + 1) * size() * size()) {
+    return false;
+  }
+  Link link = ActionToLink(action);
+  const Cell& cell = GetConstCell(link.position);
+  return cell.color() == player && cell.HasLink(link.direction);
+}
+
+Link Board::ActionToLink(Action action) const {
+  int slot = action - size() * size();
+  return {ActionToPosition(slot / kLinkSlotsPerCell),
+          slot % kLinkSlotsPerCell};
+}
 
-  for (Player p=0; p < kNumPlayers; p++) {
-    legal_actions_[p].resize(num_legal_actions_per_player);
-    legal_actions_[p].clear();
+Action Board::LinkToAction(Link link) const {
+  return size() * size() + LinkEdge(link.position, link.direction);
+}
+
+bool Board::BordersConnected(Player player) const {
+  SPIEL_CHECK_TRUE(link_removal_);
+  return connectivity_->Connected(BorderVertex(player, kStart),
+                                  BorderVertex(player, kEnd));
+}
+
+int Board::BorderVertex(Player player, int border) const {
+  return size() * size() + 2 * player + border;
+}
+
+int Board::LinkEdge(Position position, int dir) const {
+  if (dir >= kLinkSlotsPerCell) {
+    position = position + kLinkDescriptorTable[dir].offsets;
+    dir = OppDir(dir);
   }
+  return PositionToAction(position) * kLinkSlotsPerCell + dir;
+}
 
-  for (int col=0; col < size(); col++) {
-    for (int row=0; row < size(); row++) {
-      Position pos = {col, row};
-      Action action = col*size()+row;
-      if (PositionIsOffBoard(pos)) {
-        continue;
-      } else if (PositionIsOnBorder(kRedPlayer, pos)) {
-        legal_actions_[kRedPlayer].push_back(action);
-      } else if (PositionIsOnBorder(kBluePlayer, pos)) {
-        legal_actions_[kBluePlayer].push_back(action);
-      } else {
-        legal_actions_[kRedPlayer].push_back(action);
-        legal_actions_[kBluePlayer].push_back(action);
+int Board::BorderEdge(Position position) const {
+  return kLinkSlotsPerCell * size() * size() + PositionToAction(position);
+}
+
+std::vector<Action> Board::GetLegalActions(Player player) const {
+  std::vector<Action> actions;
+  actions.reserve(num_legal_actions_[player]);
+  GetLegalActions(player, &actions);
+  return actions;
+}
+
+void Board::GetLegalActions(Player player,
+                            std::vector<Action>* actions) const {
+  actions->clear();
+  int num_words = (size() * size() + 63) / 64;
+  for (int word = 0; word < num_words; word++) {
+    uint64_t bits = legal_actions_[player][word];
+    while (bits != 0) {
+      actions->push_back(word * 64 + __builtin_ctzll(bits));
+      bits &= bits - 1;
+    }
+  }
+  if (link_removal_) {
+    // the links of player, in the order of their actions
+    for (int x = 0; x < size(); x++) {
+      for (uint64_t rows = peg_rows_[x]; rows != 0; rows &= rows - 1) {
+        Position position = {x, __builtin_ctzll(rows)};
+        const Cell& cell = GetConstCell(position);
+        if (cell.color() != player) {
+          continue;
+        }
+        for (int dir = 0; dir < kLinkSlotsPerCell; dir++) {
+          if (cell.HasLink(dir)) {
+            actions->push_back(LinkToAction({position, dir}));
+          }
+        }
       }
     }
   }
 }
 
+void Board::GetLegalActionMask(Player player, uint8_t* mask) const {
+  const int num_cells = size() * size();
+  for (int action = 0; action < num_cells; action++) {
+    mask[action] = (legal_actions_[player][action / 64] >> (action % 64)) & 1;
+  }
+  if (link_removal_) {
+    std::fill(mask + num_cells, mask + num_cells * (kLinkSlotsPerCell + 1),
+              0);
+    for (int x = 0; x < size(); x++) {
+      for (uint64_t rows = peg_rows_[x]; rows != 0; rows &= rows - 1) {
+        Position position = {x, __builtin_ctzll(rows)};
+        const Cell& cell = GetConstCell(position);
+        if (cell.color() != player) {
+          continue;
+        }
+        for (int dir = 0; dir < kLinkSlotsPerCell; dir++) {
+          if (cell.HasLink(dir)) {
+            mask[LinkToAction({position, dir})] = 1;
+          }
+        }
+      }
+    }
+  }
+}
+
+bool Board::IsDeadCell(Player player, Action action) const {
+  if (link_removal_) {
+    return false;
+  }
+  Position position = ActionToPosition(action);
+  for (int dir = 0; dir < kMaxCompass; dir++) {
+    Position target_position = position + kLinkDescriptorTable[dir].offsets;
+    if (!PositionIsOffBoard(target_position) &&
+        !PositionIsOnBorder(1 - player, target_position) &&
+        GetConstCell(target_position).color() != 1 - player &&
+        !LinkIsBlocked(position, dir)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Board::IsUselessMove(Player player, Action action) const {
+  return IsDeadCell(player, action) &&
+         (!IsLegalAction(1 - player, action) ||
+          IsDeadCell(1 - player, action));
+}
+
+std::vector<Action> Board::GetLiveLegalActions(Player player) const {
+  std::vector<Action> actions;
+  actions.reserve(num_legal_actions_[player]);
+  GetLiveLegalActions(player, &actions);
+  return actions;
+}
+
+void Board::GetLiveLegalActions(Player player,
+                                std::vector<Action>* actions) const {
+  GetLegalActions(player, actions);
+  if (move_counter() < 2) {
+    return;
+  }
+  // the live actions are moved to the front; if there are none, the legal
+  // actions are left as they are
+  int num_live = 0;
+  for (Action action : *actions) {
+    if (!IsUselessMove(player, action)) {
+      (*actions)[num_live++] = action;
+    }
+  }
+  if (num_live > 0) {
+    actions->resize(num_live);
+  }
+}
+
 std::string Board::ToString() const {
   std::string s = "";
 
   // head line
   s.append("     ");
-  for (int y = 0; y < size(); y++) {
-    std::string letter = "";
-    letter += static_cast<int>('a') + y;
-    letter += "  ";
-    AppendColorString(s, kAnsiRed, letter);
+  for (int x = 0; x < size(); x++) {
+    std::string label = ColumnLabel(x);
+    label.resize(3, ' ');
+    AppendColorString(s, kAnsiRed, label);
   }
   s.append("\n");
 
@@ -450,11 +638,22 @@ void Board::AppendAfterRow(std::string& s, Position position) const {
 void Board::UndoFirstMove() {
   Cell& cell = GetCell(move_one());
   cell.set_color(kEmpty);
-  InitializeNeighbors(move_one(), cell, false);
+  peg_rows_[move_one().x] &= ~(1ULL << move_one().y);
   InitializeLegalActions();
 }
 
 void Board::ApplyAction(Player player, Action action) {
+  if (IsLinkRemoval(action)) {
+    RemoveLink(ActionToLink(action));
+    // the pegs linked again may connect the border lines of either player
+    for (Player p : {player, 1 - player}) {
+      if (BordersConnected(p)) {
+        set_result(p == kRedPlayer ? kRedWin : kBlueWin);
+        break;
+      }
+    }
+    return;
+  }
   Position position = ActionToPosition(action);
 
   if (move_counter() == 1) {
@@ -506,82 +705,165 @@ void Board::SetPegAndLinks(Player player, Position position) {
   // set peg
   Cell& cell = GetCell(position);
   cell.set_color(player);
+  peg_rows_[position.x] |= 1ULL << position.y;
+  if (link_removal_ && PositionIsOnBorder(player, position)) {
+    connectivity_.Mutable()->AddEdge(
+        BorderEdge(position), PositionToAction(position),
+        BorderVertex(player,
+                     cell.IsLinkedToBorder(player, kStart) ? kStart : kEnd));
+  }
 
   int dir = 0;
   bool newLinks = false;
   // check all neigbors that are empty or have same color)
   for (dir = 0; dir < kMaxCompass; dir++) {
     Position target_position = position + kLinkDescriptorTable[dir].offsets;
-    if (!PositionIsOffBoard(target_position)) {
+    if (!PositionIsOffBoard(target_position) &&
+        GetConstCell(target_position).color() == cell.color()) {
+      // only now the column of the target cell is written to
       Cell& target_cell = GetCell(target_position);
-      if (target_cell.color() == cell.color()) {
-        // check if there are blocking links before setting link
-        const std::set<Link>& blockers =
-          BlockerMap::GetBlockers((Link){position, dir});
-        bool blocked = false;
-        for (auto &bl : blockers) {
-          if (GetCell(bl.position).HasLink(bl.direction)) {
-            blocked = true;
-            break;
-          }
-        }
-
-        if (!blocked) {
-          // we set the link, and set the flag that there is at least one new
-          // link
-          cell.set_link(dir);
-          target_cell.set_link(OppDir(dir));
-
-          newLinks = true;
-
-          // check if cell we link to is linked to START border / END border
-          if (target_cell.IsLinkedToBorder(player, kStart)) {
-            cell.SetLinkedToBorder(player, kStart);
-            linked_to_start = true;
-          } else if (target_cell.IsLinkedToBorder(player, kEnd)) {
-            cell.SetLinkedToBorder(player, kEnd);
-            linked_to_end = true;
-          } else {
-            linked_to_neutral = true;
-          }
+      // check if there are blocking links before setting link
+      if (!LinkIsBlocked(position, dir)) {
+        // we set the link, and set the flag that there is at least one new
+        // link
+        AddLink(position, dir);
+        newLinks = true;
+
+        // check if cell we link to is linked to START border / END border
+        if (target_cell.IsLinkedToBorder(player, kStart)) {
+          cell.SetLinkedToBorder(player, kStart);
+          linked_to_start = true;
+        } else if (target_cell.IsLinkedToBorder(player, kEnd)) {
+          cell.SetLinkedToBorder(player, kEnd);
+          linked_to_end = true;
         } else {
-          // we store the fact that these two pegs of the same color cannot be
-          // linked this info is used for the ObservationTensor
-          cell.SetBlockedNeighbor(dir);
-          target_cell.SetBlockedNeighbor(OppDir(dir));
+          linked_to_neutral = true;
         }
-      }  // same color
-    }  // is on board
+      } else {
+        // we store the fact that these two pegs of the same color cannot be
+        // linked this info is used for the ObservationTensor
+        cell.SetBlockedNeighbor(dir);
+        target_cell.SetBlockedNeighbor(OppDir(dir));
+        board_counters.blocked_links++;
+      }
+    }  // is on board and same color
   }  // range of directions
 
-  // check if we need to explore further
-  if (newLinks) {
-    std::set<Cell*> visited = {};
+  // check if we need to explore further; with link_removal the flags
+  // could not be taken back, connectivity_ knows the borders instead
+  if (newLinks && !link_removal_) {
     if (cell.IsLinkedToBorder(player, kStart) && linked_to_neutral) {
       // case: new cell is linked to START and linked to neutral cells
       // => explore neutral graph and add all its cells to START
-      ExploreLocalGraph(player, cell, kStart, visited);
+      board_counters.explorations++;
+      ExploreLocalGraph(player, position, kStart);
     }
     if (cell.IsLinkedToBorder(player, kEnd) && linked_to_neutral) {
       // case: new cell is linked to END and linked to neutral cells
       // => explore neutral graph and add all its cells to END
-      ExploreLocalGraph(player, cell, kEnd, visited);
+      board_counters.explorations++;
+      ExploreLocalGraph(player, position, kEnd);
+    }
+  }
+}
+
+void Board::AddLink(Position position, int dir) {
+  Position target_position = position + kLinkDescriptorTable[dir].offsets;
+  GetCell(position).set_link(dir);
+  GetCell(target_position).set_link(OppDir(dir));
+  AddCrossings(position, dir);
+  board_counters.links++;
+  if (link_removal_) {
+    connectivity_.Mutable()->AddEdge(LinkEdge(position, dir),
+                                     PositionToAction(position),
+                                     PositionToAction(target_position));
+  }
+}
+
+bool Board::LinkIsBlocked(Position position, int dir) const {
+  // the counter of a slot is kept at its end with a direction kNNE..kSSE
+  if (dir >= kMaxCompass / 2) {
+    position = position + kLinkDescriptorTable[dir].offsets;
+    dir = OppDir(dir);
+  }
+  return GetConstCell(position).crossings(dir) > 0;
+}
+
+void Board::AddCrossings(Position position, int dir) {
+  // the slots that cross a link are its blocking links; they all have a
+  // direction kNNE..kSSE
+  for (const Link& blocker : kLinkDescriptorTable[dir].blocking_links) {
+    Position slot_position = position + blocker.position;
+    if (slot_position.x >= 0 && slot_position.x < size() &&
+        slot_position.y >= 0 && slot_position.y < size()) {
+      GetCell(slot_position).AddCrossing(blocker.direction);
+    }
+  }
+}
+
+void Board::RemoveCrossings(Position position, int dir) {
+  for (const Link& blocker : kLinkDescriptorTable[dir].blocking_links) {
+    Position slot_position = position + blocker.position;
+    if (slot_position.x >= 0 && slot_position.x < size() &&
+        slot_position.y >= 0 && slot_position.y < size()) {
+      GetCell(slot_position).RemoveCrossing(blocker.direction);
+    }
+  }
+}
+
+void Board::RemoveLink(Link link) {
+  Position target_position =
+      link.position + kLinkDescriptorTable[link.direction].offsets;
+  Cell& cell = GetCell(link.position);
+  Cell& target_cell = GetCell(target_position);
+  cell.clear_link(link.direction);
+  target_cell.clear_link(OppDir(link.direction));
+  // the two pegs stay unlinked for good, as if the link was blocked, so
+  // that each slot is linked at most once (see MaxGameLength)
+  cell.SetBlockedNeighbor(link.direction);
+  target_cell.SetBlockedNeighbor(OppDir(link.direction));
+  cell.SetRemovedLink(link.direction);
+  RemoveCrossings(link.position, link.direction);
+  connectivity_.Mutable()->RemoveEdge(
+      LinkEdge(link.position, link.direction));
+
+  // pegs are linked whenever they can be: the pegs of a color on both
+  // ends of a slot the removed link crossed are linked now, unless another
+  // link still crosses it (slots are taken in the order of blocking_links)
+  for (const Link& freed :
+       kLinkDescriptorTable[link.direction].blocking_links) {
+    Position from = link.position + freed.position;
+    Position to = from + kLinkDescriptorTable[freed.direction].offsets;
+    if (PositionIsOffBoard(from) || PositionIsOffBoard(to)) {
+      continue;
+    }
+    const Cell& from_cell = GetConstCell(from);
+    const int color = from_cell.color();
+    if ((color == kRedColor || color == kBlueColor) &&
+        GetConstCell(to).color() == color &&
+        !from_cell.HasRemovedLink(freed.direction) &&
+        !LinkIsBlocked(from, freed.direction)) {
+      AddLink(from, freed.direction);
+      GetCell(from).ClearBlockedNeighbor(freed.direction);
+      GetCell(to).ClearBlockedNeighbor(OppDir(freed.direction));
     }
   }
 }
 
-void Board::ExploreLocalGraph(Player player, Cell& cell,
-  enum Border border, std::set<Cell*> visited) {
-  visited.insert(&cell);
+void Board::ExploreLocalGraph(Player player, Position position,
+  enum Border border) {
+  // cells are flagged before they are explored, so the flag also marks
+  // the cells that have been visited
   for (int dir = 0; dir < kMaxCompass; dir++) {
+    const Cell& cell = GetConstCell(position);
     if (cell.HasLink(dir)) {
-      Cell& target_cell = GetCell(cell.GetNeighbor(dir));
-      if ((visited.find(&target_cell) == visited.end())
-        && !target_cell.IsLinkedToBorder(player, border)) {
+      Position target_position = position + kLinkDescriptorTable[dir].offsets;
+      if (!GetConstCell(target_position).IsLinkedToBorder(player, border)) {
         // linked neighbor has not been visited yet
         // => add it and explore
-        target_cell.SetLinkedToBorder(player, border);
-        ExploreLocalGraph(player, target_cell, border, visited);
+        GetCell(target_position).SetLinkedToBorder(player, border);
+        board_counters.explored_cells++;
+        ExploreLocalGraph(player, target_position, border);
       }
     }
   }
@@ -605,10 +887,14 @@ Action Board::PositionToAction(Position position) const {
 }
 
 Action Board::StringToAction(std::string s) const {
-  Player player = (s.at(0) == 'x') ? kRedPlayer : kBluePlayer;
-  Position position;
-  position.x = static_cast<int>(s.at(1)) - static_cast<int>('a');
-  position.y = size() - (static_cast<int>(s.at(2)) - static_cast<int>('0'));
+  // s is a move like xd4, of12 or xab30: player, column letters, row number
+  Position position = {0, 0};
+  size_t pos = 1;
+  for (; pos < s.size() && s[pos] >= 'a' && s[pos] <= 'z'; pos++) {
+    position.x = position.x * 26 + (s[pos] - 'a' + 1);
+  }
+  position.x--;
+  position.y = size() - std::stoi(s.substr(pos));
   return PositionToAction(position);
 }
 
@@ -632,11 +918,12 @@ bool Board::PositionIsOffBoard(Position position) const {
 
 void Board::RemoveLegalAction(Player player, Position position) {
   Action action = PositionToAction(position);
-  std::vector<Action>& la = legal_actions_[player];
-  std::vector<Action>::iterator it;
-  it = find(la.begin(), la.end(), action);
-  if (it != la.end())
-    la.erase(it);
+  uint64_t& word = legal_actions_[player][action / 64];
+  uint64_t bit = 1ULL << (action % 64);
+  if (word & bit) {
+    word &= ~bit;
+    num_legal_actions_[player]--;
+  }
 }
 
 }  // namespace twixt
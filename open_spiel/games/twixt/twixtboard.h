@@ -16,24 +16,37 @@
 #ifndef OPEN_SPIEL_GAMES_TWIXT_TWIXTBOARD_H_
 #define OPEN_SPIEL_GAMES_TWIXT_TWIXTBOARD_H_
 
+#include <cstdint>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 #include <utility>
-#include <set>
-#include <unordered_map>
 
 #include "open_spiel/games/twixt/twixtcell.h"
+#include "open_spiel/games/twixt/twixtconnectivity.h"
 #include "open_spiel/spiel.h"
 
 namespace open_spiel {
 namespace twixt {
 
 const int kMinBoardSize = 5;
-const int kMaxBoardSize = 24;
+const int kMaxBoardSize = 48;
 const int kDefaultBoardSize = 8;
 
 const bool kDefaultAnsiColorOutput = true;
+const bool kDefaultAdjudicate = false;
+const bool kDefaultLinkRemoval = false;
+
+// with link_removal, the actions board_size^2 + 4 * cell + dir remove the
+// link from cell in direction dir (kNNE..kSSE; a link is named by its end
+// with one of these directions)
+const int kLinkSlotsPerCell = kMaxCompass / 2;
+
+// legal actions are kept as bitmaps indexed by action
+const int kLegalActionWords = (kMaxBoardSize * kMaxBoardSize + 63) / 64;
+// the pegs of a column are kept as a bitmap of its rows
+static_assert(kMaxBoardSize <= 64, "a column must fit into 64 bits");
 
 // 8 link descriptors store the properties of a link direction
 struct {
@@ -41,45 +54,180 @@ struct {
   std::vector<Link> blocking_links;
 } typedef LinkDescriptor;
 
+// the descriptor of link direction dir, see enum Compass
+const LinkDescriptor& GetLinkDescriptor(int dir);
+
+// the label of column x: a to z, then aa, ab, ... as on larger boards
+std::string ColumnLabel(int x);
+
+// counts of board events for workload analysis; each thread counts its
+// own boards, reset the counts by assigning BoardCounters()
+struct BoardCounters {
+  int64_t links = 0;          // links set
+  int64_t blocked_links = 0;  // pegs of a player not linked by a crossing
+  int64_t explorations = 0;   // ExploreLocalGraph runs of a move
+  int64_t explored_cells = 0; // cells they linked to a border
+};
+
+// the counters of the calling thread
+BoardCounters& GetBoardCounters();
+
 // Tensor has 2 * 6 planes of size bordSize * (boardSize-2)
 // see ObservationTensor
 const int kNumPlanes = 12;
+// InformationStateTensor adds a swap plane and a player-to-move plane
+const int kNumInformationStatePlanes = kNumPlanes + 2;
 
 enum Result { kOpen, kRedWin, kBlueWin, kDraw };
 
 enum Color { kRedColor, kBlueColor, kEmpty, kOffBoard };
 
+// the columns of cells of a board, copy-on-write: a copy of a board shares
+// all columns with the original, and a column is only copied when a move
+// writes to it (see Board::GetCell). Assigning keeps the columns that no
+// other board uses as spares for the next copies, so a board that is
+// assigned to over and over (e.g. by TwixTState::CloneInto) stops
+// allocating once it has enough of them.
+class Columns {
+ public:
+  Columns() {}
+  // the spares are not copied
+  Columns(const Columns& other) : columns_(other.columns_) {}
+  Columns& operator=(const Columns& other);
+
+  std::shared_ptr<std::vector<Cell>>& operator[](int x) {
+    return columns_[x];
+  }
+  const std::shared_ptr<std::vector<Cell>>& operator[](int x) const {
+    return columns_[x];
+  }
+  // size new columns of size cells each
+  void Reset(int size);
+  // gives column x cells of its own, copied from the shared ones
+  void Unshare(int x);
+
+ private:
+  std::vector<std::shared_ptr<std::vector<Cell>>> columns_;
+  std::vector<std::shared_ptr<std::vector<Cell>>> spares_;
+};
+
+// the DynamicConnectivity of a board with link_removal, copy-on-write like
+// the columns: a copy of a board shares it with the original, and it is
+// only copied when the board adds or removes a link (see Mutable), i.e.
+// by most pegs. Assigning keeps one that no other board uses as the spare
+// for the next copy, which then reuses its memory.
+class SharedConnectivity {
+ public:
+  SharedConnectivity() {}
+  // the spare is not copied
+  SharedConnectivity(const SharedConnectivity& other)
+      : connectivity_(other.connectivity_) {}
+  SharedConnectivity& operator=(const SharedConnectivity& other);
+
+  const DynamicConnectivity* operator->() const {
+    return connectivity_.get();
+  }
+  // write access: copies it first if it is shared with another board
+  DynamicConnectivity* Mutable();
+  // a new one, see DynamicConnectivity::Reset
+  void Reset(int num_vertices, int num_edges);
+
+ private:
+  std::shared_ptr<DynamicConnectivity> connectivity_;
+  std::shared_ptr<DynamicConnectivity> spare_;
+};
+
 class Board {
  public:
   ~Board() {}
   Board() {}
-  Board(int, bool);
+  // with adjudicate, a game ends as soon as a player has a connection that
+  // the opponent cannot prevent any more, see twixtadjudicate.h; with
+  // link_removal, a player may remove links of their own before placing
+  // a peg (the two cannot be combined)
+  Board(int, bool, bool = false, bool = false);
 
   int size() const { return size_; }
   std::string ToString() const;
   int result() const { return result_; }
   int move_counter() const { return move_counter_; }
-  std::vector<Action> GetLegalActions(Player player) const {
-    return legal_actions_[player];
+  bool swapped() const { return swapped_; }
+  bool link_removal() const { return link_removal_; }
+  std::vector<Action> GetLegalActions(Player player) const;
+  // the same into actions, which keeps its capacity
+  void GetLegalActions(Player player, std::vector<Action>* actions) const;
+  // mask[action] is 1 for the legal actions of player and 0 for the
+  // others; mask has an entry for each of the game's distinct actions
+  void GetLegalActionMask(Player player, uint8_t* mask) const;
+  // a cell is dead for player if a peg of player there could never be
+  // linked: each link slot from it is crossed by a link, or leads off
+  // board, onto the opponent's border line or to a peg of the opponent;
+  // links are never removed, so a dead cell stays dead (with link_removal
+  // they are, and no cell is dead)
+  bool IsDeadCell(Player player, Action action) const;
+  // a move of player is useless if it helps neither player: its cell is
+  // dead for player and dead for (or not playable by) the opponent, so the
+  // move only passes the turn; a pass can only be better than all other
+  // moves if each of them hurts by the links it sets
+  bool IsUselessMove(Player player, Action action) const;
+  // the legal actions without the useless moves, or all legal actions if
+  // every one is useless; all of them during the first two moves (swap)
+  std::vector<Action> GetLiveLegalActions(Player player) const;
+  void GetLiveLegalActions(Player player, std::vector<Action>* actions) const;
+  // the legal pegs; the link removals are not counted
+  int num_legal_actions(Player player) const {
+    return num_legal_actions_[player];
   }
+  bool IsLegalAction(Player player, Action action) const {
+    if (action >= 0 && action < size_ * size_) {
+      return (legal_actions_[player][action / 64] >> (action % 64)) & 1;
+    }
+    return link_removal_ && IsLegalLinkRemoval(player, action);
+  }
+  // a peg is placed, or a link removed; after a removal the same player
+  // is still to move
   void ApplyAction(Player, Action);
-  Cell& GetCell(Position position) { return cell_[position.x][position.y]; }
+  bool IsLinkRemoval(Action action) const { return action >= size_ * size_; }
+  // the link of a removal action and the removal action of a link
+  Link ActionToLink(Action action) const;
+  Action LinkToAction(Link link) const;
+  // true if the border lines of player are linked to each other; this is
+  // how a game ends with link_removal, the cells do not keep their
+  // IsLinkedToBorder flags then
+  bool BordersConnected(Player player) const;
+  // GetCell gives write access: it copies the column of the cell first
+  // if the column is still shared with another board
+  Cell& GetCell(Position position) {
+    if (columns_[position.x].use_count() > 1) {
+      columns_.Unshare(position.x);
+    }
+    return (*columns_[position.x])[position.y];
+  }
   const Cell& GetConstCell(Position position) const {
-    return cell_[position.x][position.y];
+    return (*columns_[position.x])[position.y];
   }
   Position ActionToPosition(Action action) const;
   Action PositionToAction(Position position) const;
   Position GetTensorPosition(Position position, bool turn) const;
+  // bitmap of the rows of column x that have a peg
+  uint64_t GetPegRows(int x) const { return peg_rows_[x]; }
 
  private:
   int move_counter_ = 0;
   bool swapped_ = false;
   Position move_one_;
   int result_ = kOpen;
-  std::vector<std::vector<Cell>> cell_;
+  Columns columns_;
   int size_;  // length of a side of the board
   bool ansi_color_output_;
-  std::vector<Action> legal_actions_[kNumPlayers];
+  bool adjudicate_ = false;
+  bool link_removal_ = false;
+  // with link_removal: the links of both players and the border lines,
+  // see BordersConnected
+  SharedConnectivity connectivity_;
+  uint64_t legal_actions_[kNumPlayers][kLegalActionWords];
+  int num_legal_actions_[kNumPlayers];
+  uint64_t peg_rows_[kMaxBoardSize] = {};
 
   void set_size(int size) { size_ = size; }
 
@@ -90,7 +238,6 @@ class Board {
 
   void set_result(int result) { result_ = result; }
 
-  bool swapped() const { return swapped_; }
   void set_swapped(bool swapped) { swapped_ = swapped; }
 
   Position move_one() const { return move_one_; }
@@ -99,22 +246,36 @@ class Board {
   void IncMoveCounter() { move_counter_++; }
 
   bool HasLegalActions(Player player) const {
-    return legal_actions_[player].size() > 0;
+    return num_legal_actions_[player] > 0;
   }
 
   void RemoveLegalAction(Player, Position);
+  bool IsLegalLinkRemoval(Player, Action) const;
+  void RemoveLink(Link);
+  // the vertices and edges of connectivity_: a cell, a border line of a
+  // player; a link slot (by its end with direction kNNE..kSSE), the link
+  // of a peg to the border line it is on
+  int BorderVertex(Player, int border) const;
+  int LinkEdge(Position, int) const;
+  int BorderEdge(Position) const;
 
   void UpdateResult(Player, Position);
   void UndoFirstMove();
 
-  void InitializeCells(bool);
-  void InitializeNeighbors(Position, Cell&, bool);
-  void InitializeBlockerMap(Position, int, const LinkDescriptor&);
+  void InitializeCells();
 
   void InitializeLegalActions();
 
   void SetPegAndLinks(Player, Position);
-  void ExploreLocalGraph(Player, Cell&, enum Border,  std::set<Cell*>);
+  // links the peg at position to the one in direction dir
+  void AddLink(Position, int);
+  // true if a link crosses the slot from position in direction dir
+  bool LinkIsBlocked(Position, int) const;
+  // counts the new link from position in direction dir at the slots it
+  // crosses
+  void AddCrossings(Position, int);
+  void RemoveCrossings(Position, int);
+  void ExploreLocalGraph(Player, Position, enum Border);
 
   void AppendLinkChar(std::string&, Position, enum Compass, std::string) const;
   void AppendColorString(std::string&, std::string, std::string) const;
@@ -130,26 +291,6 @@ class Board {
   Action StringToAction(std::string s) const;
 };
 
-// used to construct new entries in BlockerMap
-class LinkHashFunction {
- public:
-    size_t operator()(const Link& link) const {
-      return link.position.x * 10000 + link.position.y * 100 + link.direction;
-    }
-};
-
-// stores for each link the set of links that could block it (i.e. cross it)
-class BlockerMap {
- public:
-    static const std::set<Link>& GetBlockers(Link link);
-    static void PushBlocker(Link link, Link blocked_link);
-    static void DeleteBlocker(Link link, Link blocked_link);
-    static void ClearBlocker();
-
- private:
-    static std::unordered_map<Link, std::set<Link>, LinkHashFunction> map_;
-};
-
 // twixt board:
 // * the board has board_size_ * board_size_ cells
 // * the x-axis (cols) points right,
@@ -157,7 +298,8 @@ class BlockerMap {
 // * coord labels c3, f4, d2, etc. start at the upper left corner (a1)
 // * player 0, 'x', red color, plays top/bottom
 // * player 1, 'o', blue color, plays left/right
-// * positions are labeled: col letter + row number, e.g. d4
+// * positions are labeled: col letter + row number, e.g. d4; beyond
+//   column z the columns are labeled aa, ab, ...
 // * moves are labeled: player label + col letter + row number, e.g. xd4
 // * empty cell code = 2
 // * corner cell code = 3
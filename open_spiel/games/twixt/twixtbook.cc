@@ -0,0 +1,255 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/games/twixt/twixtbook.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace open_spiel {
+namespace twixt {
+namespace {
+
+const char kBookMagic[8] = {'T', 'W', 'X', 'B', 'O', 'O', 'K', '1'};
+
+// direction of a link in each mirror image, see enum Compass
+const int kDirectionImage[kNumSymmetries][kMaxCompass] = {
+    {0, 1, 2, 3, 4, 5, 6, 7},  // identity
+    {7, 6, 5, 4, 3, 2, 1, 0},  // left/right: NNE <-> NNW, ...
+    {3, 2, 1, 0, 7, 6, 5, 4},  // top/bottom: NNE <-> SSE, ...
+    {4, 5, 6, 7, 0, 1, 2, 3}   // both: NNE <-> SSW, ...
+};
+
+// splitmix64 finalizer; the keys must not change between builds, since
+// they are stored in book files
+uint64_t Mix(uint64_t z) {
+  z += 0x9e3779b97f4a7c15ULL;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+// feature 0 and 1: peg of player 0 or 1; 2 + dir: link in direction dir
+uint64_t FeatureKey(Position position, int feature) {
+  return Mix((static_cast<uint64_t>(position.x) << 32) |
+             (static_cast<uint64_t>(position.y) << 16) | feature);
+}
+
+Position TransformPosition(Position position, int symmetry, int size) {
+  switch (symmetry) {
+  case kFlipX:
+    return {size - 1 - position.x, position.y};
+  case kFlipY:
+    return {position.x, size - 1 - position.y};
+  case kRotate180:
+    return {size - 1 - position.x, size - 1 - position.y};
+  default:
+    return position;
+  }
+}
+
+}  // namespace
+
+uint64_t CanonicalHash(const Board& board, Player player, int* tied) {
+  const int size = board.size();
+  uint64_t base = Mix(0x7717ULL << 48 | size);
+  if (player == kBluePlayer) {
+    base ^= Mix(0x7717ULL << 48 | 0xffff);
+  }
+  uint64_t hashes[kNumSymmetries];
+  std::fill(hashes, hashes + kNumSymmetries, base);
+
+  for (int x = 0; x < size; x++) {
+    for (uint64_t rows = board.GetPegRows(x); rows != 0; rows &= rows - 1) {
+      Position position = {x, __builtin_ctzll(rows)};
+      const Cell& cell = board.GetConstCell(position);
+      for (int s = 0; s < kNumSymmetries; s++) {
+        Position image = TransformPosition(position, s, size);
+        hashes[s] ^= FeatureKey(image, cell.color());
+        for (int dir = 0; dir < kMaxCompass; dir++) {
+          if (cell.HasLink(dir)) {
+            hashes[s] ^= FeatureKey(image, 2 + kDirectionImage[s][dir]);
+          }
+        }
+      }
+    }
+  }
+
+  uint64_t hash = *std::min_element(hashes, hashes + kNumSymmetries);
+  *tied = 0;
+  for (int s = 0; s < kNumSymmetries; s++) {
+    if (hashes[s] == hash) {
+      *tied |= 1 << s;
+    }
+  }
+  return hash;
+}
+
+Action TransformAction(Action action, int symmetry, int board_size) {
+  // action = x * size + y, see twixtboard.h
+  Position image = TransformPosition(
+      {static_cast<int>(action / board_size),
+       static_cast<int>(action % board_size)},
+      symmetry, board_size);
+  return image.x * board_size + image.y;
+}
+
+OpeningBookBuilder::OpeningBookBuilder(int board_size, int max_moves)
+    : max_moves_(max_moves), initial_board_(board_size, false) {}
+
+void OpeningBookBuilder::AddGame(const std::vector<Action>& actions,
+                                 int result) {
+  // replay the whole game first: a finished game overrides result
+  const int num_actions = actions.size();
+  Board board = initial_board_;
+  for (int i = 0; i < num_actions && board.result() == kOpen; i++) {
+    if (!board.IsLegalAction(i % 2, actions[i])) {
+      SpielFatalError("Not a legal action: " + std::to_string(actions[i]));
+    }
+    board.ApplyAction(i % 2, actions[i]);
+  }
+  if (board.result() != kOpen) {
+    result = board.result();
+  }
+
+  const int size = initial_board_.size();
+  board = initial_board_;
+  for (int i = 0; i < num_actions && i < max_moves_ &&
+                  board.result() == kOpen; i++) {
+    Player player = i % 2;
+    int tied;
+    uint64_t hash = CanonicalHash(board, player, &tied);
+    // equivalent moves in a symmetric position share one entry
+    Action canonical = size * size;
+    for (int s = 0; s < kNumSymmetries; s++) {
+      if (tied & (1 << s)) {
+        canonical = std::min(canonical, TransformAction(actions[i], s, size));
+      }
+    }
+
+    BookEntry& entry = entries_[{hash, canonical}];
+    entry.hash = hash;
+    entry.action = canonical;
+    entry.visits++;
+    if (result == (player == kRedPlayer ? kRedWin : kBlueWin)) {
+      entry.wins++;
+    } else if (result == kDraw) {
+      entry.draws++;
+    }
+    board.ApplyAction(player, actions[i]);
+  }
+}
+
+int OpeningBookBuilder::num_positions() const {
+  int n = 0;
+  uint64_t last = 0;
+  for (const auto& entry : entries_) {
+    if (n == 0 || entry.first.first != last) {
+      n++;
+      last = entry.first.first;
+    }
+  }
+  return n;
+}
+
+void OpeningBookBuilder::Write(const std::string& path,
+                               int min_visits) const {
+  BookHeader header;
+  std::memcpy(header.magic, kBookMagic, sizeof(kBookMagic));
+  header.board_size = initial_board_.size();
+  header.max_moves = max_moves_;
+  header.num_entries = 0;
+  for (const auto& entry : entries_) {
+    if (static_cast<int64_t>(entry.second.visits) >= min_visits) {
+      header.num_entries++;
+    }
+  }
+
+  FILE* file = std::fopen(path.c_str(), "wb");
+  if (file == nullptr) {
+    SpielFatalError("Cannot write opening book " + path);
+  }
+  bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+  for (const auto& entry : entries_) {
+    if (static_cast<int64_t>(entry.second.visits) >= min_visits) {
+      ok = ok && std::fwrite(&entry.second, sizeof(BookEntry), 1, file) == 1;
+    }
+  }
+  if (std::fclose(file) != 0 || !ok) {
+    SpielFatalError("Cannot write opening book " + path);
+  }
+}
+
+OpeningBook::OpeningBook(const std::string& path) : file_(path) {
+  absl::string_view contents = file_.contents();
+  if (!file_.ok() || contents.size() < sizeof(BookHeader)) {
+    SpielFatalError("Cannot read opening book " + path);
+  }
+  header_ = reinterpret_cast<const BookHeader*>(contents.data());
+  entries_ = reinterpret_cast<const BookEntry*>(contents.data() +
+                                                sizeof(BookHeader));
+  if (std::memcmp(header_->magic, kBookMagic, sizeof(kBookMagic)) != 0 ||
+      contents.size() != sizeof(BookHeader) +
+                             header_->num_entries * sizeof(BookEntry)) {
+    SpielFatalError("Not an opening book: " + path);
+  }
+}
+
+std::vector<BookMove> OpeningBook::Lookup(const Board& board,
+                                          Player player) const {
+  std::vector<BookMove> moves;
+  if (board.size() != board_size() || board.move_counter() >= max_moves()) {
+    return moves;
+  }
+  int tied;
+  uint64_t hash = CanonicalHash(board, player, &tied);
+  const BookEntry* begin = std::lower_bound(
+      entries_, entries_ + num_entries(), hash,
+      [](const BookEntry& entry, uint64_t h) { return entry.hash < h; });
+
+  for (const BookEntry* entry = begin;
+       entry != entries_ + num_entries() && entry->hash == hash; entry++) {
+    // each symmetry is its own inverse
+    for (int s = 0; s < kNumSymmetries; s++) {
+      if (!(tied & (1 << s))) {
+        continue;
+      }
+      Action action = TransformAction(entry->action, s, board.size());
+      bool seen = std::any_of(moves.begin(), moves.end(),
+                              [action](const BookMove& move) {
+                                return move.action == action;
+                              });
+      if (!seen && board.IsLegalAction(player, action)) {
+        moves.push_back({action, entry->visits, entry->wins, entry->draws});
+      }
+    }
+  }
+  std::sort(moves.begin(), moves.end(),
+            [](const BookMove& a, const BookMove& b) {
+              return a.visits > b.visits ||
+                     (a.visits == b.visits && a.action < b.action);
+            });
+  return moves;
+}
+
+std::vector<BookMove> OpeningBook::Lookup(const TwixTState& state) const {
+  if (state.IsTerminal()) {
+    return {};
+  }
+  return Lookup(state.board(), state.CurrentPlayer());
+}
+
+}  // namespace twixt
+}  // namespace open_spiel
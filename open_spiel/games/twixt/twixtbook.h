@@ -0,0 +1,119 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_GAMES_TWIXT_TWIXTBOOK_H_
+#define OPEN_SPIEL_GAMES_TWIXT_TWIXTBOOK_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/games/twixt/twixt.h"
+#include "open_spiel/games/twixt/twixtboard.h"
+#include "open_spiel/games/twixt/twixtrecord.h"
+
+// opening book: statistics of the moves played in a position, keyed by a
+// hash of the position.
+//
+// A position and its mirror images (left/right, top/bottom and both) are
+// equivalent, because each player keeps their borders. The book stores each
+// position once, in the mirror image with the smallest hash, and maps moves
+// into and out of that image. The swap move needs no special care: it is
+// the first move repeated, which maps like any other move.
+//
+// Book file: a BookHeader followed by BookEntry records sorted by hash and
+// action, in native byte order. The file is mmap'ed and searched in place.
+
+namespace open_spiel {
+namespace twixt {
+
+// the mirror images of a position
+enum Symmetry { kIdentity, kFlipX, kFlipY, kRotate180, kNumSymmetries };
+
+// hash of the position seen from player (who is to move) in its canonical
+// image; tied receives the bitmap of the symmetries that give that image
+uint64_t CanonicalHash(const Board& board, Player player, int* tied);
+
+// action as seen in the image of symmetry
+Action TransformAction(Action action, int symmetry, int board_size);
+
+struct BookHeader {
+  char magic[8];  // "TWXBOOK1"
+  uint32_t board_size;
+  uint32_t max_moves;
+  uint64_t num_entries;
+};
+
+struct BookEntry {
+  uint64_t hash;
+  uint32_t action;  // in the canonical image
+  uint32_t visits;
+  uint32_t wins;    // won by the player who made the move
+  uint32_t draws;
+};
+static_assert(sizeof(BookEntry) == 24, "book entries are stored as is");
+
+// a book move in the frame of the position it was looked up for
+struct BookMove {
+  Action action;
+  uint32_t visits;
+  uint32_t wins;
+  uint32_t draws;
+  // fraction of points won, draws count half
+  double Score() const { return (wins + 0.5 * draws) / visits; }
+};
+
+// collects the first max_moves moves of games and writes the book
+class OpeningBookBuilder {
+ public:
+  OpeningBookBuilder(int board_size, int max_moves);
+
+  // actions of a game from the start; result is kRedWin, kBlueWin, kDraw or
+  // kOpen if unknown
+  void AddGame(const std::vector<Action>& actions, int result);
+  int num_positions() const;
+  // writes all moves that have been played at least min_visits times
+  void Write(const std::string& path, int min_visits) const;
+
+ private:
+  int max_moves_;
+  Board initial_board_;
+  std::map<std::pair<uint64_t, uint32_t>, BookEntry> entries_;
+};
+
+class OpeningBook {
+ public:
+  explicit OpeningBook(const std::string& path);
+
+  int board_size() const { return header_->board_size; }
+  int max_moves() const { return header_->max_moves; }
+  uint64_t num_entries() const { return header_->num_entries; }
+
+  // legal book moves of player in board, most visited first
+  std::vector<BookMove> Lookup(const Board& board, Player player) const;
+  std::vector<BookMove> Lookup(const TwixTState& state) const;
+
+ private:
+  MappedFile file_;
+  const BookHeader* header_;
+  const BookEntry* entries_;
+};
+
+}  // namespace twixt
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_GAMES_TWIXT_TWIXTBOOK_H_
@@ -15,13 +15,14 @@
 #ifndef OPEN_SPIEL_GAMES_TWIXT_TWIXTCELL_H_
 #define OPEN_SPIEL_GAMES_TWIXT_TWIXTCELL_H_
 
+#include <cstdint>
 #include <utility>
 #include "open_spiel/spiel.h"
 
 struct Position {
   int x;
   int y;
-  Position operator+(const Position &p) {
+  Position operator+(const Position &p) const {
     return {x + p.x, y + p.y};
   }
   bool operator==(const Position &p) const {
@@ -72,20 +73,22 @@ class Cell {
   int color() const { return color_; }
   void set_color(int color) { color_ = color; }
   void set_link(int dir) { links_ |= (1UL << dir); }
+  void clear_link(int dir) { links_ &= ~(1UL << dir); }
   int links() const { return links_; }
 
   bool HasLink(int dir) const { return links_ & (1UL << dir); }
   bool HasLinks() const { return links_ > 0; }
 
   void SetBlockedNeighbor(int dir) { blocked_neighbors_ |= (1UL << dir); }
+  void ClearBlockedNeighbor(int dir) { blocked_neighbors_ &= ~(1UL << dir); }
+  bool HasBlockedNeighbor(int dir) const {
+    return blocked_neighbors_ & (1UL << dir);
+  }
   bool HasBlockedNeighbors() const { return blocked_neighbors_ > 0; }
   bool HasBlockedNeighborsEast() const {
     return (blocked_neighbors_ & 15UL) > 0;
   }
 
-  Position GetNeighbor(int dir) const { return neighbors_[dir]; }
-  void SetNeighbor(int dir, Position c) { neighbors_[dir] = c; }
-
   void SetLinkedToBorder(int player, int border) {
     linked_to_border_[player][border] = true;
   }
@@ -94,15 +97,27 @@ class Cell {
     return linked_to_border_[player][border];
   }
 
+  // number of links that cross the link slot from this cell in direction
+  // dir, which is one of kNNE..kSSE (the slots of the other directions are
+  // kept at their other end)
+  int crossings(int dir) const { return crossings_[dir]; }
+  void AddCrossing(int dir) { crossings_[dir]++; }
+  void RemoveCrossing(int dir) { crossings_[dir]--; }
+
+  // with link_removal: the link slot from this cell in direction dir
+  // (kNNE..kSSE) has had its link removed, and is never linked again
+  void SetRemovedLink(int dir) { removed_links_ |= (1UL << dir); }
+  bool HasRemovedLink(int dir) const { return removed_links_ & (1UL << dir); }
+
  private:
-  int color_;
+  int8_t color_;
   // bitmap of outgoing links from this cell
-  int links_ = 0;
+  uint8_t links_ = 0;
   // bitmap of neighbors same color that are blocked
-  int blocked_neighbors_ = 0;
-  // array of neighbor tuples
-  // (cells in knight's move distance that are on board)
-  Position neighbors_[kMaxCompass];
+  uint8_t blocked_neighbors_ = 0;
+  uint8_t crossings_[kMaxCompass / 2] = {0, 0, 0, 0};
+  // bitmap of the slots kNNE..kSSE whose link has been removed
+  uint8_t removed_links_ = 0;
   // indicator if cell is linked to START|END border of player 0|1
   bool linked_to_border_[kNumPlayers][kMaxBorder] = {{false, false},
                                                    {false, false}};
@@ -0,0 +1,100 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/games/twixt/twixtcompact.h"
+
+namespace open_spiel {
+namespace twixt {
+
+CompactActions::CompactActions(int board_size)
+    : board_size_(board_size), num_cells_(board_size * (board_size - 2)) {
+  SPIEL_CHECK_GE(board_size, kMinBoardSize);
+  SPIEL_CHECK_LE(board_size, kMaxBoardSize);
+  const Board board(board_size, false);
+  for (Player player = 0; player < kNumPlayers; player++) {
+    to_compact_[player].assign(board_size * board_size, -1);
+    from_compact_[player].assign(num_cells_, -1);
+    for (Action action = 0; action < board_size * board_size; action++) {
+      // the opponent's border lines are outside the planes of the player
+      Position tensor_position = board.GetTensorPosition(
+          board.ActionToPosition(action), player == kBluePlayer);
+      if (tensor_position.y >= 0 && tensor_position.y < board_size - 2) {
+        int index = tensor_position.x * (board_size - 2) + tensor_position.y;
+        to_compact_[player][action] = index;
+        from_compact_[player][index] = action;
+      }
+    }
+  }
+}
+
+Action CompactActions::SwapAction(const Board& board, Player player) const {
+  if (player != kBluePlayer || board.move_counter() != 1) {
+    return -1;
+  }
+  // the only peg on the board; blue may not swap a peg on red's border
+  for (int x = 0; x < board_size_; x++) {
+    if (uint64_t rows = board.GetPegRows(x)) {
+      Action action = board.PositionToAction({x, __builtin_ctzll(rows)});
+      return board.IsLegalAction(player, action) ? action : -1;
+    }
+  }
+  return -1;
+}
+
+int CompactActions::ToCompact(const Board& board, Player player,
+                              Action action) const {
+  SPIEL_CHECK_EQ(board.size(), board_size_);
+  if (action < 0 || action >= board_size_ * board_size_) {
+    return -1;
+  }
+  if (action == SwapAction(board, player)) {
+    return swap_index();
+  }
+  return to_compact_[player][action];
+}
+
+Action CompactActions::FromCompact(const Board& board, Player player,
+                                   int index) const {
+  SPIEL_CHECK_EQ(board.size(), board_size_);
+  SPIEL_CHECK_GE(index, 0);
+  SPIEL_CHECK_LT(index, size());
+  if (index == swap_index()) {
+    Action action = SwapAction(board, player);
+    SPIEL_CHECK_GE(action, 0);
+    return action;
+  }
+  return from_compact_[player][index];
+}
+
+void CompactActions::LegalIndices(const Board& board, Player player,
+                                  std::vector<int>* indices) const {
+  SPIEL_CHECK_EQ(board.size(), board_size_);
+  indices->clear();
+  if (board.result() != kOpen) {
+    return;
+  }
+  const Action swap_action = SwapAction(board, player);
+  for (int index = 0; index < num_cells_; index++) {
+    Action action = from_compact_[player][index];
+    if (action != swap_action && board.IsLegalAction(player, action)) {
+      indices->push_back(index);
+    }
+  }
+  if (swap_action >= 0) {
+    indices->push_back(swap_index());
+  }
+}
+
+}  // namespace twixt
+}  // namespace open_spiel
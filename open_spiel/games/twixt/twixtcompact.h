@@ -0,0 +1,71 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_GAMES_TWIXT_TWIXTCOMPACT_H_
+#define OPEN_SPIEL_GAMES_TWIXT_TWIXTCOMPACT_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "open_spiel/games/twixt/twixtboard.h"
+#include "open_spiel/spiel.h"
+
+// Compact action indices, e.g. for policy heads and visit counts.
+//
+// The actions of the game are the board_size^2 cells, but a player can
+// never play a corner or a border line of the opponent. The compact
+// indices of a player are only the board_size * (board_size - 2) cells the
+// player may ever play, plus one index for the swap:
+// * the index of a cell is its flat position (x * (board_size - 2) + y)
+//   in the observation planes of the player, i.e. the cells of blue are
+//   turned by 90 degrees as in the ObservationTensor, so a policy head
+//   sees the board the same way for both players,
+// * swap_index() is the swap: blue's second move on the cell of red's
+//   first one; that cell has no other index at that move.
+// There are no indices for the link removals of the link_removal variant.
+
+namespace open_spiel {
+namespace twixt {
+
+class CompactActions {
+ public:
+  explicit CompactActions(int board_size);
+
+  // number of compact indices, the swap included
+  int size() const { return num_cells_ + 1; }
+  int swap_index() const { return num_cells_; }
+
+  // the compact index of action for player (to move on board), or -1 if
+  // player can never play it
+  int ToCompact(const Board& board, Player player, Action action) const;
+  // the action of a compact index of player (to move on board)
+  Action FromCompact(const Board& board, Player player, int index) const;
+  // the legal compact indices of player in ascending order
+  void LegalIndices(const Board& board, Player player,
+                    std::vector<int>* indices) const;
+
+ private:
+  // red's first move while blue may swap, else -1
+  Action SwapAction(const Board& board, Player player) const;
+
+  int board_size_;
+  int num_cells_;
+  std::vector<int32_t> to_compact_[kNumPlayers];    // per action, or -1
+  std::vector<int32_t> from_compact_[kNumPlayers];  // per cell index
+};
+
+}  // namespace twixt
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_GAMES_TWIXT_TWIXTCOMPACT_H_
@@ -0,0 +1,373 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/games/twixt/twixtconnectivity.h"
+
+#include <algorithm>
+
+namespace open_spiel {
+namespace twixt {
+namespace {
+
+// an arc of a forest edge whose level is the level of the tour
+const uint8_t kLevelEdgeFlag = 1;
+// a vertex that has non-forest edges at the level of the tour
+const uint8_t kListFlag = 2;
+
+}  // namespace
+
+void DynamicConnectivity::Reset(int num_vertices, int num_edges) {
+  SPIEL_CHECK_GT(num_vertices, 0);
+  SPIEL_CHECK_GE(num_edges, 0);
+  num_vertices_ = num_vertices;
+  num_edges_ = num_edges;
+  // levels 0 .. floor(log2(num_vertices))
+  max_levels_ = 1;
+  while ((1 << max_levels_) <= num_vertices) {
+    max_levels_++;
+  }
+  arc_base_ = max_levels_ * num_vertices;
+  num_levels_ = 0;
+  random_ = 2463534242u;
+  free_arcs_ = -1;
+  vertex_nodes_.clear();
+  arc_nodes_.clear();
+  list_heads_.clear();
+  // the levels are added as edges are raised; reserved up front so that
+  // a state reused as a copy target does not allocate for a deeper game
+  vertex_nodes_.reserve(max_levels_ * num_vertices);
+  list_heads_.reserve(max_levels_ * num_vertices);
+  edge_ends_.assign(2 * num_edges, -1);
+  edge_levels_.assign(num_edges, -1);
+  edge_forest_.assign(num_edges, 0);
+  edge_arcs_.assign(num_edges, -1);
+  list_next_.assign(2 * num_edges, -1);
+  list_prev_.assign(2 * num_edges, -1);
+  AddLevel();
+}
+
+void DynamicConnectivity::AddLevel() {
+  SPIEL_CHECK_LT(num_levels_, max_levels_);
+  for (int v = 0; v < num_vertices_; v++) {
+    vertex_nodes_.push_back({-1, -1, -1, -1, v, NextPriority(), 1, 1, 0, 0});
+  }
+  list_heads_.resize(list_heads_.size() + num_vertices_, -1);
+  num_levels_++;
+}
+
+uint32_t DynamicConnectivity::NextPriority() {
+  random_ ^= random_ << 13;
+  random_ ^= random_ >> 17;
+  random_ ^= random_ << 5;
+  return random_;
+}
+
+void DynamicConnectivity::AddEdge(int edge, int u, int v) {
+  SPIEL_CHECK_LT(edge_levels_[edge], 0);
+  SPIEL_CHECK_NE(u, v);
+  edge_ends_[2 * edge] = u;
+  edge_ends_[2 * edge + 1] = v;
+  edge_levels_[edge] = 0;
+  if (Connected(u, v)) {
+    Attach(0, edge);
+  } else {
+    edge_forest_[edge] = 1;
+    Link(0, edge);
+  }
+}
+
+void DynamicConnectivity::RemoveEdge(int edge) {
+  const int level = edge_levels_[edge];
+  SPIEL_CHECK_GE(level, 0);
+  edge_levels_[edge] = -1;
+  if (!edge_forest_[edge]) {
+    Detach(level, edge);
+    return;
+  }
+  edge_forest_[edge] = 0;
+  for (int i = 0; i <= level; i++) {
+    Cut(i, edge);
+  }
+  for (int arc = edge_arcs_[edge]; arc >= 0;) {
+    const int next = node(arc).next;
+    FreeArcPair(arc);
+    arc = next;
+  }
+  edge_arcs_[edge] = -1;
+  Replace(level, edge_ends_[2 * edge], edge_ends_[2 * edge + 1]);
+}
+
+bool DynamicConnectivity::Connected(int u, int v) const {
+  return Root(VertexNode(0, u)) == Root(VertexNode(0, v));
+}
+
+int DynamicConnectivity::ComponentSize(int v) const {
+  return node(Root(VertexNode(0, v))).vertices;
+}
+
+int DynamicConnectivity::NewArcPair(int item) {
+  int first;
+  if (free_arcs_ >= 0) {
+    first = free_arcs_;
+    free_arcs_ = node(first).next;
+  } else {
+    first = arc_base_ + arc_nodes_.size();
+    arc_nodes_.resize(arc_nodes_.size() + 2);
+  }
+  for (int id : {first, first + 1}) {
+    node(id) = {-1, -1, -1, -1, item, NextPriority(), 1, 0, 0, 0};
+  }
+  return first;
+}
+
+void DynamicConnectivity::FreeArcPair(int first) {
+  node(first).next = free_arcs_;
+  free_arcs_ = first;
+}
+
+void DynamicConnectivity::Update(int id) {
+  TourNode& n = node(id);
+  n.count = 1;
+  n.vertices = id < arc_base_ ? 1 : 0;
+  n.flags = n.own_flags;
+  for (int child : {n.left, n.right}) {
+    if (child >= 0) {
+      const TourNode& c = node(child);
+      n.count += c.count;
+      n.vertices += c.vertices;
+      n.flags |= c.flags;
+    }
+  }
+}
+
+void DynamicConnectivity::SetOwnFlag(int id, uint8_t flag, bool on) {
+  TourNode& n = node(id);
+  n.own_flags = on ? n.own_flags | flag : n.own_flags & ~flag;
+  for (; id >= 0; id = node(id).parent) {
+    Update(id);
+  }
+}
+
+int DynamicConnectivity::Root(int id) const {
+  while (node(id).parent >= 0) {
+    id = node(id).parent;
+  }
+  return id;
+}
+
+int DynamicConnectivity::Index(int id) const {
+  int index = Count(node(id).left);
+  for (int parent = node(id).parent; parent >= 0;
+       id = parent, parent = node(id).parent) {
+    if (node(parent).right == id) {
+      index += Count(node(parent).left) + 1;
+    }
+  }
+  return index;
+}
+
+int DynamicConnectivity::Merge(int first, int second) {
+  if (first < 0) {
+    return second;
+  }
+  if (second < 0) {
+    return first;
+  }
+  if (node(first).priority > node(second).priority) {
+    const int right = Merge(node(first).right, second);
+    node(first).right = right;
+    node(right).parent = first;
+    Update(first);
+    return first;
+  }
+  const int left = Merge(first, node(second).left);
+  node(second).left = left;
+  node(left).parent = second;
+  Update(second);
+  return second;
+}
+
+void DynamicConnectivity::Split(int root, int k, int* first, int* second) {
+  if (root < 0) {
+    *first = -1;
+    *second = -1;
+    return;
+  }
+  // the caller links the part that keeps root to its parent again
+  node(root).parent = -1;
+  const int left = node(root).left;
+  if (Count(left) >= k) {
+    int rest;
+    Split(left, k, first, &rest);
+    node(root).left = rest;
+    if (rest >= 0) {
+      node(rest).parent = root;
+    }
+    Update(root);
+    *second = root;
+  } else {
+    int rest;
+    Split(node(root).right, k - Count(left) - 1, &rest, second);
+    node(root).right = rest;
+    if (rest >= 0) {
+      node(rest).parent = root;
+    }
+    Update(root);
+    *first = root;
+  }
+}
+
+int DynamicConnectivity::Find(int root, uint8_t flag) const {
+  if (!(node(root).flags & flag)) {
+    return -1;
+  }
+  int id = root;
+  while (!(node(id).own_flags & flag)) {
+    const int left = node(id).left;
+    id = left >= 0 && (node(left).flags & flag) ? left : node(id).right;
+  }
+  return id;
+}
+
+int DynamicConnectivity::Reroot(int id) {
+  int first, second;
+  Split(Root(id), Index(id), &first, &second);
+  return Merge(second, first);
+}
+
+int DynamicConnectivity::Arc(int level, int edge) const {
+  int arc = edge_arcs_[edge];
+  for (int i = 0; i < level; i++) {
+    arc = node(arc).next;
+  }
+  return arc;
+}
+
+void DynamicConnectivity::Link(int level, int edge) {
+  const int arc = NewArcPair(num_vertices_ + edge);
+  if (level == 0) {
+    edge_arcs_[edge] = arc;
+  } else {
+    node(Arc(level - 1, edge)).next = arc;
+  }
+  if (edge_levels_[edge] == level) {
+    node(arc).own_flags = kLevelEdgeFlag;
+    Update(arc);
+  }
+  // the tour of u, the arc to v, the tour of v, the arc back
+  const int u_tour = Reroot(VertexNode(level, edge_ends_[2 * edge]));
+  const int v_tour = Reroot(VertexNode(level, edge_ends_[2 * edge + 1]));
+  const int root = Merge(Merge(u_tour, arc), Merge(v_tour, arc + 1));
+  node(root).parent = -1;
+}
+
+void DynamicConnectivity::Cut(int level, int edge) {
+  const int arc = Arc(level, edge);
+  int begin = Index(arc);
+  int end = Index(arc + 1);
+  if (begin > end) {
+    std::swap(begin, end);
+  }
+  // before, first arc, between, second arc, after: the tree splits into
+  // the tour between the arcs and the one around them
+  int before, rest, first_arc, between, second_arc, after;
+  Split(Root(arc), begin, &before, &rest);
+  Split(rest, 1, &first_arc, &rest);
+  Split(rest, end - begin - 1, &between, &rest);
+  Split(rest, 1, &second_arc, &after);
+  const int root = Merge(before, after);
+  if (root >= 0) {
+    node(root).parent = -1;
+  }
+}
+
+void DynamicConnectivity::Attach(int level, int edge) {
+  for (int end = 2 * edge; end <= 2 * edge + 1; end++) {
+    const int vertex = edge_ends_[end];
+    int32_t& head = list_heads_[level * num_vertices_ + vertex];
+    list_prev_[end] = -1;
+    list_next_[end] = head;
+    if (head >= 0) {
+      list_prev_[head] = end;
+    } else {
+      SetOwnFlag(VertexNode(level, vertex), kListFlag, true);
+    }
+    head = end;
+  }
+}
+
+void DynamicConnectivity::Detach(int level, int edge) {
+  for (int end = 2 * edge; end <= 2 * edge + 1; end++) {
+    const int vertex = edge_ends_[end];
+    int32_t& head = list_heads_[level * num_vertices_ + vertex];
+    if (list_prev_[end] >= 0) {
+      list_next_[list_prev_[end]] = list_next_[end];
+    } else {
+      head = list_next_[end];
+    }
+    if (list_next_[end] >= 0) {
+      list_prev_[list_next_[end]] = list_prev_[end];
+    }
+    if (head < 0) {
+      SetOwnFlag(VertexNode(level, vertex), kListFlag, false);
+    }
+  }
+}
+
+void DynamicConnectivity::Replace(int level, int u, int v) {
+  for (int i = level; i >= 0; i--) {
+    const int u_root = Root(VertexNode(i, u));
+    const int v_root = Root(VertexNode(i, v));
+    // the half with at most half of the vertices; its forest edges of
+    // level i go up a level, which keeps the trees of level i + 1 at most
+    // num_vertices / 2^(i + 1) large
+    const int root =
+        node(u_root).vertices <= node(v_root).vertices ? u_root : v_root;
+    for (int arc; (arc = Find(root, kLevelEdgeFlag)) >= 0;) {
+      const int edge = node(arc).item - num_vertices_;
+      SetOwnFlag(arc, kLevelEdgeFlag, false);
+      edge_levels_[edge] = i + 1;
+      if (num_levels_ == i + 1) {
+        AddLevel();
+      }
+      Link(i + 1, edge);
+    }
+    // its non-forest edges of level i either join the halves again or go
+    // up a level
+    for (int vertex_node; (vertex_node = Find(root, kListFlag)) >= 0;) {
+      const int vertex = node(vertex_node).item;
+      int32_t end;
+      while ((end = list_heads_[i * num_vertices_ + vertex]) >= 0) {
+        const int edge = end / 2;
+        const int other = edge_ends_[end ^ 1];
+        Detach(i, edge);
+        if (Root(VertexNode(i, other)) != root) {
+          edge_forest_[edge] = 1;
+          for (int j = 0; j <= i; j++) {
+            Link(j, edge);
+          }
+          return;
+        }
+        edge_levels_[edge] = i + 1;
+        if (num_levels_ == i + 1) {
+          AddLevel();
+        }
+        Attach(i + 1, edge);
+      }
+    }
+  }
+}
+
+}  // namespace twixt
+}  // namespace open_spiel
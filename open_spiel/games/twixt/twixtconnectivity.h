@@ -0,0 +1,149 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_GAMES_TWIXT_TWIXTCONNECTIVITY_H_
+#define OPEN_SPIEL_GAMES_TWIXT_TWIXTCONNECTIVITY_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "open_spiel/spiel.h"
+
+// Fully dynamic connectivity of an undirected graph, for the link_removal
+// variant: pegs add links, removals delete them, and a player has won when
+// the two border lines of the player are connected.
+//
+// This is the structure of Holm, de Lichtenberg and Thorup (2001): every
+// edge has a level, at most log2(num_vertices); the edges of level >= i
+// that are in the spanning forest form the forest F_i, and each F_i is
+// kept as Euler tours in treaps. Connected is a root lookup in F_0, O(log
+// n). Adding an edge is O(log n). Removing a forest edge searches the
+// smaller of its two halves for a replacement at each level, and pays for
+// that by raising the levels of the edges it looks at, so a removal costs
+// O(log^2 n) amortized instead of a search of the whole component.
+//
+// Vertices and edges have fixed ids in [0, num_vertices) and
+// [0, num_edges), so all of the state is in flat vectors: copying a
+// structure into one of the same size reuses its memory, and the levels
+// above 0 are only set up once an edge is raised to them.
+
+namespace open_spiel {
+namespace twixt {
+
+class DynamicConnectivity {
+ public:
+  DynamicConnectivity() {}
+
+  // no vertices linked, no edges
+  void Reset(int num_vertices, int num_edges);
+
+  // adds edge (u, v); the id must not be in use
+  void AddEdge(int edge, int u, int v);
+  void RemoveEdge(int edge);
+  bool HasEdge(int edge) const { return edge_levels_[edge] >= 0; }
+  bool Connected(int u, int v) const;
+  // number of vertices connected to v, v included
+  int ComponentSize(int v) const;
+
+  // levels in use, for tests and statistics
+  int num_levels() const { return num_levels_; }
+
+ private:
+  // an Euler tour has one node per vertex and two (arcs) per forest edge
+  struct TourNode {
+    int32_t left;
+    int32_t right;
+    int32_t parent;
+    int32_t next;  // arcs: the arc of the next level, or the next free one
+    int32_t item;  // vertices: the vertex; arcs: num_vertices + edge
+    uint32_t priority;
+    int32_t count;     // nodes in the subtree
+    int32_t vertices;  // vertex nodes in the subtree
+    uint8_t flags;     // own flags or-ed with those of the subtree
+    uint8_t own_flags;
+  };
+
+  // vertex nodes are numbered level by level, arcs from arc_base_ on
+  int VertexNode(int level, int v) const {
+    return level * num_vertices_ + v;
+  }
+  TourNode& node(int id) {
+    return id < arc_base_ ? vertex_nodes_[id] : arc_nodes_[id - arc_base_];
+  }
+  const TourNode& node(int id) const {
+    return id < arc_base_ ? vertex_nodes_[id] : arc_nodes_[id - arc_base_];
+  }
+  int Count(int id) const { return id < 0 ? 0 : node(id).count; }
+  void AddLevel();
+  uint32_t NextPriority();
+
+  // treap operations on the tour nodes; a tree is given by its root
+  // returns the first of two adjacent arcs
+  int NewArcPair(int item);
+  void FreeArcPair(int first);
+  void Update(int id);
+  // updates id and its ancestors after its own flags changed
+  void SetOwnFlag(int id, uint8_t flag, bool on);
+  int Root(int id) const;
+  int Index(int id) const;
+  int Merge(int first, int second);
+  // the first k nodes of the tour and the others
+  void Split(int root, int k, int* first, int* second);
+  // a node of the tree with flag, or -1
+  int Find(int root, uint8_t flag) const;
+  // rotates the tour of the tree of a vertex node to start at it and
+  // returns the root
+  int Reroot(int id);
+
+  // the forest operations at one level; an edge is linked at the levels
+  // from 0 up
+  void Link(int level, int edge);
+  void Cut(int level, int edge);
+  // the arc from the first to the second end of edge at level; the arc
+  // back is the next node
+  int Arc(int level, int edge) const;
+
+  // the lists of the non-forest edges of each vertex at each level
+  void Attach(int level, int edge);
+  void Detach(int level, int edge);
+
+  // raises edges and looks for a replacement of the forest edge (u, v),
+  // just cut at all its levels; level is the level it had
+  void Replace(int level, int u, int v);
+
+  int num_vertices_ = 0;
+  int num_edges_ = 0;
+  int num_levels_ = 0;
+  int max_levels_ = 0;
+  int arc_base_ = 0;
+  uint32_t random_ = 0;  // xorshift state of the priorities
+  int free_arcs_ = -1;   // the first free pair
+  std::vector<TourNode> vertex_nodes_;
+  std::vector<TourNode> arc_nodes_;
+  // per edge
+  std::vector<int32_t> edge_ends_;    // 2 per edge
+  std::vector<int8_t> edge_levels_;   // -1 if the edge is not there
+  std::vector<uint8_t> edge_forest_;  // 1 for edges of the forest F_0
+  std::vector<int32_t> edge_arcs_;    // first arc at level 0, or -1
+  // per (level, vertex): the first non-forest edge end; per edge end: the
+  // next and previous ones (2 * edge + side)
+  std::vector<int32_t> list_heads_;
+  std::vector<int32_t> list_next_;
+  std::vector<int32_t> list_prev_;
+};
+
+}  // namespace twixt
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_GAMES_TWIXT_TWIXTCONNECTIVITY_H_
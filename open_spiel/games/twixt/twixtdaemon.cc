@@ -0,0 +1,683 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/games/twixt/twixtdaemon.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <thread>  // NOLINT
+#include <unordered_map>
+
+#include "open_spiel/abseil-cpp/absl/strings/numbers.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_split.h"
+
+namespace open_spiel {
+namespace twixt {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const char kBase64Digits[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+int Base64Digit(char c) {
+  const char* digit = std::strchr(kBase64Digits, c);
+  return c != 0 && digit != nullptr ? digit - kBase64Digits : -1;
+}
+
+// FNV-1a of what decides the future of a position: the player to move,
+// whether blue may still swap, and the color and links of each cell
+uint64_t PositionKey(const TwixTState& state, int command) {
+  const Board& board = state.board();
+  uint64_t hash = 14695981039346656037ull;
+  auto add = [&hash](uint64_t byte) {
+    hash = (hash ^ byte) * 1099511628211ull;
+  };
+  add(command);
+  add(state.CurrentPlayer() + 2);
+  add(board.move_counter() == 1);
+  for (int x = 0; x < board.size(); x++) {
+    for (int y = 0; y < board.size(); y++) {
+      const Cell& cell = board.GetConstCell({x, y});
+      add(cell.color() + 2);
+      add(cell.links());
+    }
+  }
+  return hash != 0 ? hash : 1;
+}
+
+bool SendAll(int fd, const std::string& data) {
+  for (size_t sent = 0; sent < data.size();) {
+    ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    sent += n;
+  }
+  return true;
+}
+
+}  // namespace
+
+std::string CompactEncoding(const Game& game,
+                            const std::vector<Action>& actions) {
+  const auto& twixt_game = static_cast<const TwixTGame&>(game);
+  SPIEL_CHECK_FALSE(twixt_game.link_removal());
+  CompactActions compact_actions(twixt_game.board_size());
+  // two digits per move
+  SPIEL_CHECK_LE(compact_actions.size(), 64 * 64);
+  std::unique_ptr<State> state = game.NewInitialState();
+  const Board& board = static_cast<const TwixTState&>(*state).board();
+  std::string encoding = "c:";
+  for (Action action : actions) {
+    int index =
+        compact_actions.ToCompact(board, state->CurrentPlayer(), action);
+    SPIEL_CHECK_GE(index, 0);
+    encoding.push_back(kBase64Digits[index / 64]);
+    encoding.push_back(kBase64Digits[index % 64]);
+    state->ApplyAction(action);
+  }
+  return encoding;
+}
+
+AnalysisDaemon::Worker::Worker(const Game& game, const MctsOptions& options,
+                               LeafEvaluator* evaluator)
+    : agent(new MctsAgent(game, options, evaluator)),
+      rollout_policy(static_cast<const TwixTGame&>(game).board_size()),
+      rollout_board(static_cast<const TwixTGame&>(game).board_size(),
+                    false),
+      empty_board(rollout_board) {}
+
+AnalysisDaemon::AnalysisDaemon(std::shared_ptr<const Game> game,
+                               const DaemonOptions& options,
+                               const std::vector<LeafEvaluator*>& evaluators)
+    : game_(game),
+      options_(options),
+      evaluators_(evaluators),
+      initial_state_(
+          static_cast<TwixTState*>(game->NewInitialState().release())),
+      cache_(options.cache_size) {
+  SPIEL_CHECK_EQ(game->GetType().short_name, "twixt");
+  SPIEL_CHECK_GT(options.num_threads, 0);
+  SPIEL_CHECK_GT(options.max_batch_requests, 0);
+  SPIEL_CHECK_GT(options.max_buffered_bytes, 0);
+  SPIEL_CHECK_GT(options.max_line_bytes, 0);
+  SPIEL_CHECK_GT(options.batch_size, 0);
+  SPIEL_CHECK_GT(options.num_rollouts, 0);
+  SPIEL_CHECK_GE(options.cache_size, 0);
+  SPIEL_CHECK_TRUE(evaluators.empty() ||
+                   static_cast<int>(evaluators.size()) == options.num_threads);
+  const auto& twixt_game = static_cast<const TwixTGame&>(*game);
+  if (!twixt_game.link_removal()) {
+    compact_actions_.reset(new CompactActions(twixt_game.board_size()));
+  }
+  MctsOptions mcts_options;
+  mcts_options.num_simulations = options.num_simulations;
+  mcts_options.uct_c = options.uct_c;
+  mcts_options.prune_useless_moves = options.prune_useless_moves;
+  for (int t = 0; t < options.num_threads; t++) {
+    workers_.emplace_back(new Worker(
+        *game, mcts_options, evaluators.empty() ? nullptr : evaluators[t]));
+  }
+  if (!evaluators.empty()) {
+    observations_.resize(options.batch_size * game->ObservationTensorSize());
+    priors_.resize(options.batch_size * game->NumDistinctActions());
+    values_.resize(options.batch_size);
+  }
+}
+
+AnalysisDaemon::~AnalysisDaemon() {
+  for (const Connection& connection : connections_) {
+    close(connection.fd);
+  }
+  if (listen_fd_ >= 0) {
+    close(listen_fd_);
+    unlink(path_.c_str());
+  }
+  for (int fd : wake_fds_) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+}
+
+void AnalysisDaemon::Listen(const std::string& path) {
+  SPIEL_CHECK_LT(listen_fd_, 0);
+  sockaddr_un address = {};
+  address.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(address.sun_path)) {
+    SpielFatalError("Socket path too long: " + path);
+  }
+  std::strcpy(address.sun_path, path.c_str());
+  unlink(path.c_str());
+  listen_fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listen_fd_ < 0 ||
+      bind(listen_fd_, reinterpret_cast<sockaddr*>(&address),
+           sizeof(address)) != 0 ||
+      listen(listen_fd_, SOMAXCONN) != 0 || pipe(wake_fds_) != 0) {
+    SpielFatalError("Cannot listen on " + path + ": " + std::strerror(errno));
+  }
+  path_ = path;
+}
+
+void AnalysisDaemon::Stop() {
+  SPIEL_CHECK_GE(wake_fds_[1], 0);
+  char byte = 0;
+  while (write(wake_fds_[1], &byte, 1) < 0 && errno == EINTR) {
+  }
+}
+
+void AnalysisDaemon::Serve() {
+  SPIEL_CHECK_GE(listen_fd_, 0);
+  std::vector<pollfd> fds;
+  std::vector<std::string> requests;
+  std::vector<std::string> responses;
+  std::vector<int> request_fds;
+  while (true) {
+    // the listening socket, the wake pipe, then the connections; no wait
+    // while requests are left over from a full batch
+    fds.assign({{listen_fd_, POLLIN, 0}, {wake_fds_[0], POLLIN, 0}});
+    for (const Connection& connection : connections_) {
+      int16_t events = 0;
+      const int64_t buffered =
+          connection.output.size() + connection.pending_bytes;
+      if (!connection.read_closed && buffered < options_.max_buffered_bytes) {
+        events |= POLLIN;
+      }
+      if (!connection.output.empty()) {
+        events |= POLLOUT;
+      }
+      fds.push_back({connection.fd, events, 0});
+    }
+    if (poll(fds.data(), fds.size(), pending_.empty() ? -1 : 0) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      SpielFatalError(std::string("poll: ") + std::strerror(errno));
+    }
+    if (fds[1].revents != 0) {
+      char byte;
+      if (read(wake_fds_[0], &byte, 1) == 1) {
+        return;
+      }
+    }
+    // the connections that fail are dropped with their pending requests;
+    // once the client has hung up altogether, Send fails
+    for (int i = connections_.size() - 1; i >= 0; i--) {
+      Connection& connection = connections_[i];
+      const int16_t revents = fds[i + 2].revents;
+      bool open = (revents & POLLERR) == 0;
+      if (open && !connection.read_closed && (revents & (POLLIN | POLLHUP))) {
+        open = Receive(i);
+      }
+      if (open && (revents & (POLLOUT | POLLHUP))) {
+        open = Send(&connection);
+      }
+      if (!open || connection.finished()) {
+        Close(i);
+      }
+    }
+    if (fds[0].revents != 0) {
+      int fd = accept(listen_fd_, nullptr, nullptr);
+      if (fd >= 0) {
+        // sends and receives never wait, see Send
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        connections_.push_back({fd, "", ""});
+        stats_.num_connections++;
+      }
+    }
+    if (pending_.empty()) {
+      continue;
+    }
+
+    const int num_requests =
+        std::min<int>(pending_.size(), options_.max_batch_requests);
+    requests.clear();
+    request_fds.clear();
+    for (int i = 0; i < num_requests; i++) {
+      request_fds.push_back(pending_[i].first);
+      requests.push_back(std::move(pending_[i].second));
+    }
+    pending_.erase(pending_.begin(), pending_.begin() + num_requests);
+    AnswerBatch(requests, &responses);
+    for (int i = 0; i < num_requests; i++) {
+      for (Connection& connection : connections_) {
+        if (connection.fd == request_fds[i]) {
+          connection.num_pending--;
+          connection.pending_bytes -= requests[i].size();
+          connection.output.append(responses[i]);
+          connection.output.push_back('\n');
+        }
+      }
+    }
+    // what the sockets do not take now is sent once poll says they can
+    for (int i = connections_.size() - 1; i >= 0; i--) {
+      if (!Send(&connections_[i]) || connections_[i].finished()) {
+        Close(i);
+      }
+    }
+  }
+}
+
+bool AnalysisDaemon::Receive(int connection) {
+  Connection& from = connections_[connection];
+  char buffer[4096];
+  ssize_t n = recv(from.fd, buffer, sizeof(buffer), 0);
+  if (n < 0) {
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+  }
+  if (n == 0) {
+    // the requests already received are still answered
+    from.read_closed = true;
+    return true;
+  }
+  from.input.append(buffer, n);
+  size_t start = 0;
+  for (size_t end; (end = from.input.find('\n', start)) != std::string::npos;
+       start = end + 1) {
+    size_t length = end - start;
+    if (length > 0 && from.input[end - 1] == '\r') {
+      length--;
+    }
+    if (length > static_cast<size_t>(options_.max_line_bytes)) {
+      return false;
+    }
+    pending_.emplace_back(from.fd, from.input.substr(start, length));
+    from.num_pending++;
+    from.pending_bytes += length;
+  }
+  from.input.erase(0, start);
+  return from.input.size() <= static_cast<size_t>(options_.max_line_bytes);
+}
+
+bool AnalysisDaemon::Send(Connection* connection) {
+  std::string& output = connection->output;
+  size_t sent = 0;
+  while (sent < output.size()) {
+    ssize_t n = send(connection->fd, output.data() + sent,
+                     output.size() - sent, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      break;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    sent += n;
+  }
+  output.erase(0, sent);
+  return true;
+}
+
+void AnalysisDaemon::Close(int connection) {
+  const int fd = connections_[connection].fd;
+  close(fd);
+  connections_.erase(connections_.begin() + connection);
+  pending_.erase(
+      std::remove_if(pending_.begin(), pending_.end(),
+                     [fd](const std::pair<int, std::string>& pending) {
+                       return pending.first == fd;
+                     }),
+      pending_.end());
+}
+
+void AnalysisDaemon::AnswerBatch(const std::vector<std::string>& requests,
+                                 std::vector<std::string>* responses) {
+  const auto start = Clock::now();
+  const int num_requests = requests.size();
+  if (static_cast<int>(requests_.size()) < num_requests) {
+    requests_.resize(num_requests);
+  }
+  responses->assign(num_requests, "");
+  std::unordered_map<uint64_t, int> leaders;
+  std::vector<int> to_evaluate;  // by the evaluator, in batches
+  std::vector<int> to_compute;   // searches and rollouts
+  for (int i = 0; i < num_requests; i++) {
+    std::string error = Parse(requests[i], i);
+    Request& request = requests_[i];
+    request.done = !error.empty() || request.command == kLegal ||
+                   request.command == kStats;
+    request.leader = -1;
+    if (!error.empty()) {
+      (*responses)[i] = "error " + error;
+      stats_.num_errors++;
+      continue;
+    }
+    if (request.done) {
+      continue;
+    }
+    request.key = PositionKey(*request.state, request.command);
+    if (const CacheEntry* entry = FindCacheEntry(request.key)) {
+      if (entry->key == request.key) {
+        request.action = entry->action;
+        request.value = entry->value;
+        request.visits = entry->visits;
+        request.done = true;
+        stats_.num_cache_hits++;
+        continue;
+      }
+    }
+    auto inserted = leaders.insert({request.key, i});
+    if (!inserted.second) {
+      request.leader = inserted.first->second;
+    } else if (request.command == kEval && !evaluators_.empty() &&
+               !request.state->IsTerminal()) {
+      to_evaluate.push_back(i);
+    } else {
+      to_compute.push_back(i);
+    }
+  }
+  EvaluateBatched(to_evaluate);
+  Compute(to_compute);
+  stats_.num_evaluations += to_evaluate.size();
+  stats_.num_requests += num_requests;
+  stats_.num_batches++;
+
+  for (int i = 0; i < num_requests; i++) {
+    Request& request = requests_[i];
+    if (!(*responses)[i].empty()) {
+      continue;
+    }
+    if (request.leader >= 0) {
+      const Request& leader = requests_[request.leader];
+      request.action = leader.action;
+      request.value = leader.value;
+      request.visits = leader.visits;
+    } else if (!request.done) {
+      if (CacheEntry* entry = FindCacheEntry(request.key)) {
+        *entry = {request.key, static_cast<int32_t>(request.action),
+                  request.visits, request.value};
+      }
+    }
+    (*responses)[i] = Respond(request);
+  }
+  stats_.batch_seconds +=
+      std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+std::string AnalysisDaemon::Parse(const std::string& request, int index) {
+  Request& parsed = requests_[index];
+  std::vector<std::string> words =
+      absl::StrSplit(request, ' ', absl::SkipEmpty());
+  if (words.empty()) {
+    return "empty request";
+  }
+  if (words[0] == "stats") {
+    parsed.command = kStats;
+    return words.size() == 1 ? "" : "stats takes no position";
+  }
+  if (words[0] == "legal") {
+    parsed.command = kLegal;
+  } else if (words[0] == "eval") {
+    parsed.command = kEval;
+  } else if (words[0] == "best") {
+    parsed.command = kBest;
+  } else {
+    return "unknown command: " + words[0];
+  }
+  if (words.size() != 2) {
+    return words[0] + " takes one position";
+  }
+  if (parsed.state == nullptr) {
+    parsed.state.reset(new TwixTState(*initial_state_));
+  }
+  std::string error = ParsePosition(words[1], parsed.state.get());
+  if (error.empty() && parsed.command == kBest &&
+      parsed.state->IsTerminal()) {
+    error = "the game is over";
+  }
+  return error;
+}
+
+std::string AnalysisDaemon::ParsePosition(const std::string& position,
+                                          TwixTState* state) {
+  initial_state_->CloneInto(state);
+  if (position == "-") {
+    return "";
+  }
+  // the actions of the position, decoded one at a time on state
+  std::vector<std::string> numbers;
+  int num_moves;
+  const bool compact = position.compare(0, 2, "c:") == 0;
+  if (compact) {
+    if (compact_actions_ == nullptr) {
+      return "no compact encoding with link_removal";
+    }
+    if (position.size() % 2 != 0) {
+      return "odd number of digits: " + position;
+    }
+    num_moves = position.size() / 2 - 1;
+  } else {
+    numbers = absl::StrSplit(position, ',');
+    num_moves = numbers.size();
+  }
+  for (int move = 0; move < num_moves; move++) {
+    if (state->IsTerminal()) {
+      return "move after the end of the game: " + position;
+    }
+    const Player player = state->CurrentPlayer();
+    const Board& board = state->board();
+    Action action = -1;
+    if (compact) {
+      const int high = Base64Digit(position[2 + 2 * move]);
+      const int low = Base64Digit(position[3 + 2 * move]);
+      const int index = high * 64 + low;
+      if (high < 0 || low < 0 || index >= compact_actions_->size()) {
+        return "bad compact digits: " + position;
+      }
+      if (index != compact_actions_->swap_index()) {
+        action = compact_actions_->FromCompact(board, player, index);
+      } else if (board.move_counter() == 1) {
+        // the swap is red's first move, played again by blue
+        for (Action cell = 0; cell < board.size() * board.size(); cell++) {
+          if (compact_actions_->ToCompact(board, player, cell) == index) {
+            action = cell;
+          }
+        }
+      }
+    } else if (!absl::SimpleAtoi(numbers[move], &action)) {
+      return "bad action: " + numbers[move];
+    }
+    if (action < 0 || action >= game_->NumDistinctActions() ||
+        !board.IsLegalAction(player, action)) {
+      return "illegal move " + std::to_string(move + 1) + ": " + position;
+    }
+    state->ApplyAction(action);
+  }
+  return "";
+}
+
+std::string AnalysisDaemon::Respond(const Request& request) const {
+  switch (request.command) {
+    case kLegal: {
+      std::vector<Action> legal;
+      request.state->LegalActions(&legal);
+      std::string response = absl::StrCat("ok ", legal.size());
+      for (Action action : legal) {
+        absl::StrAppend(&response, " ", action);
+      }
+      return response;
+    }
+    case kEval:
+      return absl::StrCat("ok ", request.value);
+    case kBest:
+      return absl::StrCat(
+          "ok ", request.action, " ",
+          request.state->ActionToString(request.state->CurrentPlayer(),
+                                        request.action),
+          " ", request.value, " ", request.visits);
+    case kStats:
+      return StatsString();
+  }
+  return "";
+}
+
+std::string AnalysisDaemon::StatsString() const {
+  return absl::StrCat(
+      "ok requests=", stats_.num_requests, " batches=", stats_.num_batches,
+      " errors=", stats_.num_errors, " cache_hits=", stats_.num_cache_hits,
+      " evaluations=", stats_.num_evaluations,
+      " searches=", stats_.num_searches,
+      " connections=", stats_.num_connections,
+      " batch_seconds=", stats_.batch_seconds);
+}
+
+AnalysisDaemon::CacheEntry* AnalysisDaemon::FindCacheEntry(uint64_t key) {
+  // direct-mapped: a new result replaces the one in its slot
+  return cache_.empty() ? nullptr : &cache_[key % cache_.size()];
+}
+
+void AnalysisDaemon::EvaluateBatched(const std::vector<int>& indices) {
+  const int observation_size = game_->ObservationTensorSize();
+  const int num_indices = indices.size();
+  for (int first = 0; first < num_indices; first += options_.batch_size) {
+    const int rows = std::min(options_.batch_size, num_indices - first);
+    for (int row = 0; row < rows; row++) {
+      const TwixTState& state = *requests_[indices[first + row]].state;
+      state.ObservationTensor(
+          state.CurrentPlayer(),
+          absl::MakeSpan(&observations_[row * observation_size],
+                         observation_size));
+    }
+    evaluators_[0]->Evaluate(rows, observations_.data(), priors_.data(),
+                             values_.data());
+    for (int row = 0; row < rows; row++) {
+      Request& request = requests_[indices[first + row]];
+      request.value = request.state->CurrentPlayer() == kRedPlayer
+                          ? values_[row]
+                          : -values_[row];
+    }
+  }
+}
+
+void AnalysisDaemon::Compute(const std::vector<int>& indices) {
+  const int num_indices = indices.size();
+  std::atomic<int> next(0);
+  auto work = [&](Worker* worker) {
+    for (int i = next++; i < num_indices; i = next++) {
+      ComputeOne(&requests_[indices[i]], worker);
+    }
+  };
+  // the threads are started for each batch, as in ParallelMctsAgent
+  std::vector<std::thread> threads;
+  for (int t = 1; t < std::min<int>(workers_.size(), num_indices); t++) {
+    threads.emplace_back(work, workers_[t].get());
+  }
+  work(workers_[0].get());
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (int i : indices) {
+    stats_.num_searches += requests_[i].command == kBest;
+    stats_.num_evaluations += requests_[i].command == kEval;
+  }
+}
+
+void AnalysisDaemon::ComputeOne(Request* request, Worker* worker) {
+  const TwixTState& state = *request->state;
+  // the answer depends on the position only, not on the batch or thread
+  worker->rng.seed(options_.seed * 1000003 + request->key);
+  if (request->command == kEval) {
+    if (state.IsTerminal()) {
+      request->value = ResultValue(state.board().result(), kRedPlayer);
+      return;
+    }
+    float sum = 0;
+    for (int r = 0; r < options_.num_rollouts; r++) {
+      worker->rollout_board = state.board();
+      sum += ResultValue(
+          worker->rollout_policy.Rollout(&worker->rollout_board, &worker->rng),
+          kRedPlayer);
+    }
+    // give up the columns shared with the state, see MctsAgent::Expand
+    worker->rollout_board = worker->empty_board;
+    request->value = sum / options_.num_rollouts;
+    return;
+  }
+  const Player player = state.CurrentPlayer();
+  request->action = worker->agent->Step(state, &worker->rng);
+  request->value = player == kRedPlayer ? worker->agent->move_value()
+                                        : -worker->agent->move_value();
+  request->visits = worker->agent->move_visits();
+}
+
+AnalysisClient::AnalysisClient(const std::string& path) {
+  sockaddr_un address = {};
+  address.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(address.sun_path)) {
+    SpielFatalError("Socket path too long: " + path);
+  }
+  std::strcpy(address.sun_path, path.c_str());
+  fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd_ < 0 || connect(fd_, reinterpret_cast<sockaddr*>(&address),
+                         sizeof(address)) != 0) {
+    SpielFatalError("Cannot connect to " + path + ": " +
+                    std::strerror(errno));
+  }
+}
+
+AnalysisClient::~AnalysisClient() {
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+void AnalysisClient::Send(const std::string& request) {
+  if (!SendAll(fd_, request + "\n")) {
+    SpielFatalError(std::string("Cannot send request: ") +
+                    std::strerror(errno));
+  }
+}
+
+void AnalysisClient::Shutdown() {
+  if (shutdown(fd_, SHUT_WR) != 0) {
+    SpielFatalError(std::string("Cannot shut down: ") + std::strerror(errno));
+  }
+}
+
+std::string AnalysisClient::Receive() {
+  size_t end;
+  while ((end = input_.find('\n')) == std::string::npos) {
+    char buffer[4096];
+    ssize_t n = recv(fd_, buffer, sizeof(buffer), 0);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      SpielFatalError("Connection closed by the daemon");
+    }
+    input_.append(buffer, n);
+  }
+  std::string response = input_.substr(0, end);
+  input_.erase(0, end + 1);
+  return response;
+}
+
+}  // namespace twixt
+}  // namespace open_spiel
@@ -0,0 +1,250 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_GAMES_TWIXT_TWIXTDAEMON_H_
+#define OPEN_SPIEL_GAMES_TWIXT_TWIXTDAEMON_H_
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "open_spiel/games/twixt/twixt.h"
+#include "open_spiel/games/twixt/twixtagent.h"
+#include "open_spiel/games/twixt/twixtcompact.h"
+#include "open_spiel/games/twixt/twixtrollout.h"
+#include "open_spiel/games/twixt/twixtselfplay.h"
+#include "open_spiel/spiel.h"
+
+// Analysis daemon: one long-running process answers the questions of the
+// tools of a host about TwixT positions over a Unix-domain stream socket,
+// so that the game, the search trees, the rollout tables and a cache of
+// results are set up once instead of by each tool (see
+// examples/twixt_daemon.cc and examples/twixt_daemon_bench.cc).
+//
+// Protocol: a request is a line, the response is a line; the responses of
+// a connection come in the order of its requests, and a client may send
+// several requests before it reads. The daemon never blocks on a client:
+// the responses a client has not read yet wait in the daemon, and while
+// its requests and responses there take more than max_buffered_bytes, the
+// daemon reads no more of its requests (so a client that sends without
+// reading is held up by its socket, not by the daemon).
+//
+//   legal <position>  ok <n> <action> ...             the legal actions
+//   eval <position>   ok <value>                      value of the position
+//   best <position>   ok <action> <move> <value> <visits>
+//                                                      MCTS: the best move,
+//                                                      its value and visits
+//   stats             ok requests=<n> batches=<n> ...
+//
+// Values are for red, in [-1, 1]. A position is either
+// * the actions from the initial state separated by commas, e.g. 24,35,18,
+//   or "-" for the initial state,
+// * or "c:" followed by its compact encoding (see CompactEncoding): two
+//   digits of the base-64 alphabet A-Z a-z 0-9 - _ per move, the compact
+//   index of the move (twixtcompact.h) for the player who made it, most
+//   significant digit first; not with link_removal.
+// A bad request gets "error <message>"; the connection stays open. A line
+// longer than max_line_bytes closes it. A client that shuts down its side
+// of the connection (shutdown(SHUT_WR), nc -N) still gets the responses to
+// all its requests; the daemon closes the connection after the last.
+//
+// Batching: a batch is every request that has arrived by the time the
+// previous one is done, up to max_batch_requests. Its eval requests are
+// valued by one evaluator call per batch_size positions; the searches and
+// rollouts are shared out among the threads. A position asked for twice
+// in a batch is analyzed once, and the results stay in a cache for the
+// following batches.
+
+namespace open_spiel {
+namespace twixt {
+
+struct DaemonOptions {
+  int num_threads = 1;           // for the searches and rollouts
+  int max_batch_requests = 256;  // requests answered together
+  int batch_size = 64;           // observations per evaluator call
+  int num_simulations = 800;     // per best request
+  int num_rollouts = 64;         // per eval request without evaluators
+  double uct_c = 1.5;
+  // no children for useless moves, see Board::GetLiveLegalActions
+  bool prune_useless_moves = false;
+  int cache_size = 1 << 16;  // results kept, 0 for no cache
+  int seed = 0;
+  // per connection, see above; a line of a game of 48x48 with link
+  // removal can have ~150 KB
+  int max_buffered_bytes = 1 << 20;
+  int max_line_bytes = 1 << 20;
+};
+
+struct DaemonStats {
+  int64_t num_connections = 0;
+  int64_t num_requests = 0;
+  int64_t num_errors = 0;
+  int64_t num_batches = 0;
+  int64_t num_cache_hits = 0;    // eval and best requests from the cache
+  int64_t num_evaluations = 0;   // eval requests computed
+  int64_t num_searches = 0;      // best requests computed
+  double batch_seconds = 0;      // in AnswerBatch
+};
+
+// the compact encoding of the position after actions, see above
+std::string CompactEncoding(const Game& game,
+                            const std::vector<Action>& actions);
+
+class AnalysisDaemon {
+ public:
+  // With evaluators, one per thread, eval requests are valued by the first
+  // (by its value, in batches) and the searches of thread t use the
+  // priors and values of evaluator t; without, eval requests average
+  // num_rollouts rollouts of RolloutPolicy and the searches use rollouts.
+  AnalysisDaemon(std::shared_ptr<const Game> game,
+                 const DaemonOptions& options,
+                 const std::vector<LeafEvaluator*>& evaluators = {});
+  ~AnalysisDaemon();
+
+  AnalysisDaemon(const AnalysisDaemon&) = delete;
+  AnalysisDaemon& operator=(const AnalysisDaemon&) = delete;
+
+  // binds the socket at path, replacing a file that is there
+  void Listen(const std::string& path);
+  // answers requests until Stop is called
+  void Serve();
+  // makes Serve return; may be called from any thread
+  void Stop();
+
+  // the responses of a batch of request lines; Serve calls it for each
+  // batch, tests can call it without a socket
+  void AnswerBatch(const std::vector<std::string>& requests,
+                   std::vector<std::string>* responses);
+
+  const DaemonStats& stats() const { return stats_; }
+
+ private:
+  enum Command { kLegal, kEval, kBest, kStats };
+
+  // a request of the batch being answered
+  struct Request {
+    Command command;
+    std::unique_ptr<TwixTState> state;  // reused from batch to batch
+    uint64_t key = 0;                   // of the position and command
+    int leader = -1;  // the request of the batch with the same key, or -1
+    bool done = false;
+    Action action = -1;
+    float value = 0;  // for red
+    int visits = 0;
+  };
+
+  // what a thread needs for its searches and rollouts
+  struct Worker {
+    std::unique_ptr<MctsAgent> agent;
+    RolloutPolicy rollout_policy;
+    Board rollout_board;
+    Board empty_board;
+    std::mt19937 rng;
+
+    Worker(const Game& game, const MctsOptions& options,
+           LeafEvaluator* evaluator);
+  };
+
+  struct CacheEntry {
+    uint64_t key = 0;  // 0 if empty
+    int32_t action;
+    int32_t visits;
+    float value;
+  };
+
+  struct Connection {
+    int fd;
+    std::string input;   // the start of a line not received in full yet
+    std::string output;  // responses not sent yet
+    int num_pending = 0;        // of its lines in pending_
+    int64_t pending_bytes = 0;  // of its lines in pending_
+    bool read_closed = false;   // the client sends no more requests
+
+    // the client has shut down its side and has all its responses
+    bool finished() const {
+      return read_closed && num_pending == 0 && output.empty();
+    }
+  };
+
+  // parses request into requests_[index]; returns an error message or ""
+  std::string Parse(const std::string& request, int index);
+  std::string ParsePosition(const std::string& position, TwixTState* state);
+  std::string Respond(const Request& request) const;
+  std::string StatsString() const;
+  // runs the eval and best requests of indices on all threads
+  void Compute(const std::vector<int>& indices);
+  void ComputeOne(Request* request, Worker* worker);
+  void EvaluateBatched(const std::vector<int>& indices);
+  CacheEntry* FindCacheEntry(uint64_t key);
+
+  // reads what the connection has sent and queues its lines; false once
+  // it fails or its line is too long
+  bool Receive(int connection);
+  // sends what the socket takes of the output; false once it is closed
+  bool Send(Connection* connection);
+  // closes the connection and drops its pending requests
+  void Close(int connection);
+
+  std::shared_ptr<const Game> game_;
+  DaemonOptions options_;
+  std::vector<LeafEvaluator*> evaluators_;
+  std::unique_ptr<CompactActions> compact_actions_;  // null with removals
+  std::unique_ptr<TwixTState> initial_state_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::vector<Request> requests_;
+  std::vector<CacheEntry> cache_;
+  std::vector<float> observations_;
+  std::vector<float> priors_;
+  std::vector<float> values_;
+  DaemonStats stats_;
+
+  int listen_fd_ = -1;
+  std::string path_;
+  int wake_fds_[2] = {-1, -1};  // Stop writes to [1], Serve polls [0]
+  std::vector<Connection> connections_;
+  // the lines received and not answered yet, with their connection
+  std::vector<std::pair<int, std::string>> pending_;
+};
+
+// a blocking client of an AnalysisDaemon, e.g. for tools and benchmarks
+class AnalysisClient {
+ public:
+  explicit AnalysisClient(const std::string& path);
+  ~AnalysisClient();
+
+  AnalysisClient(const AnalysisClient&) = delete;
+  AnalysisClient& operator=(const AnalysisClient&) = delete;
+
+  // sends one request line, without the newline
+  void Send(const std::string& request);
+  // sends no more requests; the responses to those sent still come
+  void Shutdown();
+  // the next response line, without the newline
+  std::string Receive();
+  std::string Request(const std::string& request) {
+    Send(request);
+    return Receive();
+  }
+
+ private:
+  int fd_;
+  std::string input_;
+};
+
+}  // namespace twixt
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_GAMES_TWIXT_TWIXTDAEMON_H_
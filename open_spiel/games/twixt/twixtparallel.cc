@@ -0,0 +1,263 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/games/twixt/twixtparallel.h"
+
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <thread>  // NOLINT
+
+namespace open_spiel {
+namespace twixt {
+namespace {
+
+void AtomicAdd(std::atomic<float>* sum, float value) {
+  float old = sum->load(std::memory_order_relaxed);
+  while (!sum->compare_exchange_weak(old, old + value,
+                                     std::memory_order_relaxed)) {
+  }
+}
+
+}  // namespace
+
+ParallelMctsAgent::Worker::Worker(const Game& game, int board_size)
+    : scratch(static_cast<TwixTState*>(game.NewInitialState().release())),
+      rollout_policy(board_size) {
+  path.reserve(game.MaxGameLength() + 1);
+  movers.reserve(game.MaxGameLength() + 1);
+}
+
+ParallelMctsAgent::ParallelMctsAgent(
+    const Game& game, const ParallelMctsOptions& options,
+    const std::vector<LeafEvaluator*>& evaluators)
+    : options_(options),
+      empty_board_(static_cast<const TwixTGame&>(game).board_size(), false),
+      // not value-initialized: a slot is written when it is handed out
+      nodes_(new Node[options.max_nodes]),
+      num_nodes_(0),
+      next_simulation_(0) {
+  SPIEL_CHECK_EQ(game.GetType().short_name, "twixt");
+  SPIEL_CHECK_GT(options.num_simulations, 0);
+  SPIEL_CHECK_GT(options.num_threads, 0);
+  SPIEL_CHECK_GE(options.virtual_loss, 0);
+  const int board_size = static_cast<const TwixTGame&>(game).board_size();
+  // the root always fits
+  SPIEL_CHECK_GT(options.max_nodes, game.NumDistinctActions());
+  SPIEL_CHECK_TRUE(evaluators.empty() ||
+                   static_cast<int>(evaluators.size()) == options.num_threads);
+  for (int t = 0; t < options.num_threads; t++) {
+    workers_.emplace_back(new Worker(game, board_size));
+    if (!evaluators.empty()) {
+      Worker& worker = *workers_.back();
+      worker.evaluator = evaluators[t];
+      worker.observation.resize(game.ObservationTensorSize());
+      worker.priors.resize(game.NumDistinctActions());
+    }
+  }
+}
+
+Action ParallelMctsAgent::Step(const TwixTState& state, std::mt19937* rng) {
+  const auto start = std::chrono::steady_clock::now();
+  SPIEL_CHECK_FALSE(state.IsTerminal());
+  Node& root = nodes_[0];
+  root.first_child.store(kUnexpanded, std::memory_order_relaxed);
+  root.visits.store(0, std::memory_order_relaxed);
+  root.value_sum.store(0, std::memory_order_relaxed);
+  root.prior = 1;
+  root.action = -1;
+  root.num_children = 0;
+  num_nodes_ = 1;
+  for (auto& worker : workers_) {
+    worker->rng.seed((*rng)());
+    worker->num_nodes = 0;
+    worker->num_collisions = 0;
+  }
+
+  // the root alone, then all threads
+  next_simulation_ = 1;
+  Simulate(state, workers_[0].get());
+  std::vector<std::thread> threads;
+  const int num_threads = workers_.size();
+  for (int t = 1; t < num_threads; t++) {
+    threads.emplace_back(&ParallelMctsAgent::Work, this, std::cref(state),
+                         workers_[t].get());
+  }
+  Work(state, workers_[0].get());
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  const int first = root.first_child.load(std::memory_order_relaxed);
+  int best = first;
+  for (int i = first; i < first + root.num_children; i++) {
+    if (nodes_[i].visits.load(std::memory_order_relaxed) >
+        nodes_[best].visits.load(std::memory_order_relaxed)) {
+      best = i;
+    }
+  }
+  if (nodes_[best].visits.load(std::memory_order_relaxed) == 0) {
+    best = first + (*rng)() % root.num_children;
+  }
+
+  stats_.num_moves++;
+  stats_.num_simulations += options_.num_simulations;
+  for (const auto& worker : workers_) {
+    stats_.num_nodes += worker->num_nodes;
+    stats_.num_collisions += worker->num_collisions;
+  }
+  stats_.seconds += std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+  return nodes_[best].action;
+}
+
+void ParallelMctsAgent::Work(const TwixTState& state, Worker* worker) {
+  while (next_simulation_.fetch_add(1, std::memory_order_relaxed) <
+         options_.num_simulations) {
+    Simulate(state, worker);
+  }
+}
+
+void ParallelMctsAgent::Simulate(const TwixTState& state, Worker* worker) {
+  TwixTState* scratch = worker->scratch.get();
+  state.CloneInto(scratch);
+  worker->path.assign(1, 0);
+  worker->movers.assign(1, kInvalidPlayer);
+  const int virtual_loss = options_.virtual_loss;
+  nodes_[0].visits.fetch_add(virtual_loss, std::memory_order_relaxed);
+  int node = 0;
+  int first;
+  while ((first = nodes_[node].first_child.load(
+              std::memory_order_acquire)) >= 0) {
+    node = SelectChild(node, first);
+    nodes_[node].visits.fetch_add(virtual_loss, std::memory_order_relaxed);
+    AtomicAdd(&nodes_[node].value_sum, -virtual_loss);
+    worker->movers.push_back(scratch->CurrentPlayer());
+    scratch->ApplyAction(nodes_[node].action);
+    worker->path.push_back(node);
+  }
+  if (scratch->IsTerminal()) {
+    Backup(*worker, ResultValue(scratch->board().result(), kRedPlayer));
+    return;
+  }
+  const Player player = scratch->CurrentPlayer();
+  int32_t expected = kUnexpanded;
+  const bool expand = nodes_[node].first_child.compare_exchange_strong(
+      expected, kExpanding, std::memory_order_acquire);
+  if (expected == kExpanding) {
+    worker->num_collisions++;
+  }
+  const float value = Evaluate(node, expand, worker);
+  Backup(*worker, player == kRedPlayer ? value : -value);
+}
+
+int ParallelMctsAgent::SelectChild(int node, int first_child) const {
+  const Node& parent = nodes_[node];
+  const float scale =
+      options_.uct_c *
+      std::sqrt(parent.visits.load(std::memory_order_relaxed));
+  int best = first_child;
+  float best_score = -1e30;
+  for (int i = first_child; i < first_child + parent.num_children; i++) {
+    const Node& child = nodes_[i];
+    const int visits = child.visits.load(std::memory_order_relaxed);
+    float q = visits > 0
+                  ? child.value_sum.load(std::memory_order_relaxed) / visits
+                  : 0;
+    float score = q + scale * child.prior / (1 + visits);
+    if (score > best_score) {
+      best_score = score;
+      best = i;
+    }
+  }
+  return best;
+}
+
+float ParallelMctsAgent::Evaluate(int node, bool expand, Worker* worker) {
+  TwixTState* scratch = worker->scratch.get();
+  std::vector<Action>& legal = worker->legal;
+  const Player player = scratch->CurrentPlayer();
+  if (expand || worker->evaluator != nullptr) {
+    if (options_.prune_useless_moves) {
+      scratch->board().GetLiveLegalActions(player, &legal);
+    } else {
+      scratch->LegalActions(&legal);
+    }
+    SPIEL_CHECK_FALSE(legal.empty());
+  }
+
+  float value;
+  float sum = 0;
+  if (worker->evaluator != nullptr) {
+    scratch->ObservationTensor(player, absl::MakeSpan(worker->observation));
+    worker->evaluator->Evaluate(1, worker->observation.data(),
+                                worker->priors.data(), &value);
+    for (Action action : legal) {
+      sum += worker->priors[action];
+    }
+  } else {
+    worker->rollout_board = scratch->board();
+    value = ResultValue(
+        worker->rollout_policy.Rollout(&worker->rollout_board, &worker->rng),
+        player);
+    // give up the columns shared with scratch, see MctsAgent::Expand
+    worker->rollout_board = empty_board_;
+  }
+  if (!expand) {
+    return value;
+  }
+
+  // a full array leaves the node a leaf; the check before taking the
+  // slots keeps num_nodes_ from growing without bound
+  Node& leaf = nodes_[node];
+  const int num_children = legal.size();
+  int first = -1;
+  if (num_nodes_.load(std::memory_order_relaxed) + num_children <=
+      options_.max_nodes) {
+    first = num_nodes_.fetch_add(num_children, std::memory_order_relaxed);
+  }
+  if (first < 0 || first + num_children > options_.max_nodes) {
+    leaf.first_child.store(kUnexpanded, std::memory_order_release);
+    return value;
+  }
+  for (int i = 0; i < num_children; i++) {
+    Node& child = nodes_[first + i];
+    child.first_child.store(kUnexpanded, std::memory_order_relaxed);
+    child.visits.store(0, std::memory_order_relaxed);
+    child.value_sum.store(0, std::memory_order_relaxed);
+    child.prior = sum > 0 ? worker->priors[legal[i]] / sum
+                          : 1.0f / num_children;
+    child.action = legal[i];
+  }
+  leaf.num_children = num_children;
+  leaf.first_child.store(first, std::memory_order_release);
+  worker->num_nodes += num_children;
+  return value;
+}
+
+void ParallelMctsAgent::Backup(const Worker& worker, float red_value) {
+  const int virtual_loss = options_.virtual_loss;
+  for (int i = worker.path.size() - 1; i >= 0; i--) {
+    Node& node = nodes_[worker.path[i]];
+    node.visits.fetch_add(1 - virtual_loss, std::memory_order_relaxed);
+    float value =
+        worker.movers[i] == kBluePlayer ? -red_value : red_value;
+    // the root's value is never read and got no virtual loss
+    AtomicAdd(&node.value_sum, i > 0 ? value + virtual_loss : value);
+  }
+}
+
+}  // namespace twixt
+}  // namespace open_spiel
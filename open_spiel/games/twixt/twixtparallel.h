@@ -0,0 +1,150 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_GAMES_TWIXT_TWIXTPARALLEL_H_
+#define OPEN_SPIEL_GAMES_TWIXT_TWIXTPARALLEL_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "open_spiel/games/twixt/twixt.h"
+#include "open_spiel/games/twixt/twixtagent.h"
+#include "open_spiel/games/twixt/twixtrollout.h"
+#include "open_spiel/games/twixt/twixtselfplay.h"
+#include "open_spiel/spiel.h"
+
+// Tree-parallel MCTS: several threads run the simulations of one move on
+// one shared tree, instead of a tree per thread (root parallelism), which
+// would multiply the memory of a 24x24 tree by the threads.
+//
+// The tree takes no lock:
+// * visits and values of a node are atomics, updated with fetch_add (the
+//   value by compare-and-swap, there is no fetch_add for float before
+//   C++20); a thread may see the visits of a node without its value, which
+//   only blurs one selection,
+// * a leaf is expanded by the thread that moves it from kUnexpanded to
+//   kExpanding; that thread takes the slots of the children from a shared
+//   counter, fills them in and publishes them with a release store of
+//   first_child. A thread that reaches a leaf being expanded values it
+//   (rollout or evaluator) without expanding it (a collision),
+// * virtual loss: a thread counts each node on its path as virtual_loss
+//   visits that were lost, until its backup replaces them by the real
+//   result, so the other threads pick other paths meanwhile.
+//
+// The nodes live in one array of max_nodes slots of 20 bytes (the action
+// and the number of children fit in 16 bits: a 48x48 board with link
+// removal has 11520 actions), made once by the agent; a slot is only
+// touched when a leaf is expanded into it, so a small tree only commits
+// the memory it uses. Once the array is full, leaves are valued but not
+// expanded.
+
+namespace open_spiel {
+namespace twixt {
+
+struct ParallelMctsOptions {
+  int num_simulations = 10000;  // per move, by all threads together
+  int num_threads = 1;
+  double uct_c = 1.5;
+  // visits counted as losses for each thread on a path
+  int virtual_loss = 1;
+  // no children for useless moves, see Board::GetLiveLegalActions
+  bool prune_useless_moves = false;
+  int max_nodes = 1 << 22;
+};
+
+struct ParallelSearchStats {
+  int64_t num_moves = 0;
+  int64_t num_simulations = 0;
+  int64_t num_nodes = 0;       // tree nodes created
+  int64_t num_collisions = 0;  // leaves valued while being expanded
+  double seconds = 0;          // wall time of the searches
+};
+
+// PUCT search of num_simulations simulations per move on num_threads
+// threads (the calling one included) that share one tree, and plays the
+// most visited move. With evaluators, one per thread, the leaves get their
+// priors (by action) and values from them; without, the priors are
+// uniform and a leaf is valued by one rollout of RolloutPolicy.
+//
+// Each move starts a new tree, whose root is expanded before the other
+// threads start. The threads are started for each move, which costs some
+// 50 us. With one thread, the moves depend on the generator only.
+class ParallelMctsAgent : public Agent {
+ public:
+  ParallelMctsAgent(const Game& game, const ParallelMctsOptions& options,
+                    const std::vector<LeafEvaluator*>& evaluators = {});
+
+  Action Step(const TwixTState& state, std::mt19937* rng) override;
+
+  // of all moves since the agent was made
+  const ParallelSearchStats& stats() const { return stats_; }
+
+ private:
+  static const int32_t kUnexpanded = -1;
+  static const int32_t kExpanding = -2;
+
+  struct Node {
+    std::atomic<int32_t> first_child;  // or kUnexpanded, kExpanding
+    std::atomic<int32_t> visits;       // virtual ones included
+    std::atomic<float> value_sum;      // for the player who moved into it
+    float prior;
+    int16_t action;
+    int16_t num_children;
+  };
+
+  // what a thread needs for its simulations
+  struct Worker {
+    std::unique_ptr<TwixTState> scratch;  // the state of a simulation
+    RolloutPolicy rollout_policy;
+    Board rollout_board;
+    std::mt19937 rng;
+    std::vector<int> path;       // from the root to the leaf
+    std::vector<Player> movers;  // who moved into each of them
+    std::vector<Action> legal;
+    std::vector<float> observation;
+    std::vector<float> priors;
+    LeafEvaluator* evaluator = nullptr;
+    int64_t num_nodes = 0;
+    int64_t num_collisions = 0;
+
+    Worker(const Game& game, int board_size);
+  };
+
+  // runs simulations until num_simulations have been started
+  void Work(const TwixTState& state, Worker* worker);
+  void Simulate(const TwixTState& state, Worker* worker);
+  int SelectChild(int node, int first_child) const;
+  // values the leaf, the state of worker->scratch, for the player to move
+  // there; expands it into the tree if expand
+  float Evaluate(int node, bool expand, Worker* worker);
+  // backs up the value for red along the path of worker, for the player
+  // who moved into each node, see MctsAgent::Backup
+  void Backup(const Worker& worker, float red_value);
+
+  ParallelMctsOptions options_;
+  Board empty_board_;
+  std::unique_ptr<Node[]> nodes_;  // nodes_[0] is the root
+  std::atomic<int> num_nodes_;
+  std::atomic<int> next_simulation_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  ParallelSearchStats stats_;
+};
+
+}  // namespace twixt
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_GAMES_TWIXT_TWIXTPARALLEL_H_
@@ -0,0 +1,129 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/games/twixt/twixtperft.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace open_spiel {
+namespace twixt {
+namespace {
+
+// counts the child reached by action and recurses into it
+void PerftChild(const Board& board, Player player, Action action, int depth,
+                PerftCounts* counts) {
+  Board child = board;
+  child.ApplyAction(player, action);
+  counts->nodes++;
+  if (board.move_counter() == 1 && child.swapped()) {
+    counts->swaps++;
+  }
+
+  switch (child.result()) {
+  case kRedWin:
+    counts->red_wins++;
+    break;
+  case kBlueWin:
+    counts->blue_wins++;
+    break;
+  case kDraw:
+    counts->draws++;
+    break;
+  default:
+    break;
+  }
+
+  if (depth == 1) {
+    counts->leaves++;
+  } else if (child.result() == kOpen) {
+    for (Action a : child.GetLegalActions(1 - player)) {
+      PerftChild(child, 1 - player, a, depth - 1, counts);
+    }
+  }
+}
+
+}  // namespace
+
+PerftCounts& PerftCounts::operator+=(const PerftCounts& other) {
+  nodes += other.nodes;
+  leaves += other.leaves;
+  red_wins += other.red_wins;
+  blue_wins += other.blue_wins;
+  draws += other.draws;
+  swaps += other.swaps;
+  return *this;
+}
+
+bool PerftCounts::operator==(const PerftCounts& other) const {
+  return nodes == other.nodes && leaves == other.leaves &&
+         red_wins == other.red_wins && blue_wins == other.blue_wins &&
+         draws == other.draws && swaps == other.swaps;
+}
+
+PerftCounts Perft(const Board& board, Player player, int depth) {
+  PerftCounts counts;
+  if (depth <= 0 || board.result() != kOpen) {
+    return counts;
+  }
+  for (Action action : board.GetLegalActions(player)) {
+    PerftChild(board, player, action, depth, &counts);
+  }
+  return counts;
+}
+
+PerftCounts ParallelPerft(
+    const Board& board, Player player, int depth, int num_threads,
+    std::vector<std::pair<Action, PerftCounts>>* divide) {
+  std::vector<Action> root_actions;
+  if (depth > 0 && board.result() == kOpen) {
+    root_actions = board.GetLegalActions(player);
+  }
+  const int num_root_actions = root_actions.size();
+  std::vector<PerftCounts> root_counts(num_root_actions);
+
+  // each thread takes the next unclaimed root action until none are left
+  std::atomic<int> next_root(0);
+  auto worker = [&]() {
+    for (int i = next_root++; i < num_root_actions; i = next_root++) {
+      PerftChild(board, player, root_actions[i], depth, &root_counts[i]);
+    }
+  };
+
+  num_threads = std::max(1, std::min(num_threads, num_root_actions));
+  std::vector<std::thread> threads;
+  for (int t = 1; t < num_threads; t++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  PerftCounts counts;
+  if (divide != nullptr) {
+    divide->clear();
+  }
+  for (int i = 0; i < num_root_actions; i++) {
+    counts += root_counts[i];
+    if (divide != nullptr) {
+      divide->push_back({root_actions[i], root_counts[i]});
+    }
+  }
+  return counts;
+}
+
+}  // namespace twixt
+}  // namespace open_spiel
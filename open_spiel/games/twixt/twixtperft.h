@@ -0,0 +1,57 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_GAMES_TWIXT_TWIXTPERFT_H_
+#define OPEN_SPIEL_GAMES_TWIXT_TWIXTPERFT_H_
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/games/twixt/twixtboard.h"
+
+// perft: count the move tree below a position to a fixed depth.
+// The counts only depend on the rules, so any change to Board must
+// reproduce them exactly; the time it takes is a measure of engine speed.
+
+namespace open_spiel {
+namespace twixt {
+
+struct PerftCounts {
+  uint64_t nodes = 0;      // positions generated below the root
+  uint64_t leaves = 0;     // positions generated at exactly the given depth
+  uint64_t red_wins = 0;   // positions won by x (at any depth)
+  uint64_t blue_wins = 0;  // positions won by o (at any depth)
+  uint64_t draws = 0;      // positions drawn (at any depth)
+  uint64_t swaps = 0;      // swap moves played
+
+  PerftCounts& operator+=(const PerftCounts& other);
+  bool operator==(const PerftCounts& other) const;
+};
+
+// enumerates all move sequences of up to depth moves, starting with player
+// on board; terminal positions are counted but not expanded
+PerftCounts Perft(const Board& board, Player player, int depth);
+
+// like Perft, but the subtrees of the root actions are shared out among
+// num_threads threads; if divide is not null, it receives the counts of
+// each root action in ascending action order
+PerftCounts ParallelPerft(const Board& board, Player player, int depth,
+                          int num_threads,
+                          std::vector<std::pair<Action, PerftCounts>>* divide);
+
+}  // namespace twixt
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_GAMES_TWIXT_TWIXTPERFT_H_
@@ -0,0 +1,39 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/games/twixt/twixtpool.h"
+
+namespace open_spiel {
+namespace twixt {
+
+StatePool::StatePool(std::shared_ptr<const Game> game)
+    : initial_state_(
+          static_cast<TwixTState*>(game->NewInitialState().release())) {}
+
+TwixTState* StatePool::Clone(const TwixTState& state) {
+  if (num_used_ == capacity()) {
+    states_.emplace_back(state);
+    return &states_[num_used_++];
+  }
+  TwixTState* target = &states_[num_used_++];
+  state.CloneInto(target);
+  return target;
+}
+
+TwixTState* StatePool::NewInitialState() {
+  return Clone(*initial_state_);
+}
+
+}  // namespace twixt
+}  // namespace open_spiel
@@ -0,0 +1,61 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_GAMES_TWIXT_TWIXTPOOL_H_
+#define OPEN_SPIEL_GAMES_TWIXT_TWIXTPOOL_H_
+
+#include <deque>
+#include <memory>
+
+#include "open_spiel/games/twixt/twixt.h"
+#include "open_spiel/spiel.h"
+
+namespace open_spiel {
+namespace twixt {
+
+// Arena of TwixT states for search trees.
+// States are handed out with Clone / NewInitialState and all of them are
+// released at once with Reset, e.g. between two moves of a search. Released
+// states keep their buffers: once the pool has grown to the size of a
+// search, cloning into it does not allocate any more.
+// A pool must only be used by one thread; keep one pool per thread.
+class StatePool {
+ public:
+  explicit StatePool(std::shared_ptr<const Game> game);
+
+  StatePool(const StatePool&) = delete;
+  StatePool& operator=(const StatePool&) = delete;
+
+  // returns a copy of state that is owned by the pool;
+  // it stays valid until the next call of Reset
+  TwixTState* Clone(const TwixTState& state);
+  TwixTState* NewInitialState();
+
+  // releases all states in O(1)
+  void Reset() { num_used_ = 0; }
+
+  int num_used() const { return num_used_; }
+  int capacity() const { return states_.size(); }
+
+ private:
+  std::unique_ptr<TwixTState> initial_state_;
+  // a deque grows in blocks and never moves its elements
+  std::deque<TwixTState> states_;
+  int num_used_ = 0;
+};
+
+}  // namespace twixt
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_GAMES_TWIXT_TWIXTPOOL_H_
@@ -0,0 +1,429 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/games/twixt/twixtrecord.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+
+namespace open_spiel {
+namespace twixt {
+namespace {
+
+bool IsSeparator(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == ',' || c == ';';
+}
+
+bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+char ToLower(char c) { return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c; }
+
+bool IsLetter(char c) { return ToLower(c) >= 'a' && ToLower(c) <= 'z'; }
+
+// case insensitive comparison with a lower case word
+bool EqualsWord(absl::string_view token, absl::string_view word) {
+  if (token.size() != word.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < token.size(); i++) {
+    if (ToLower(token[i]) != word[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int ResultFromString(absl::string_view s) {
+  if (s == "1-0") {
+    return kRedWin;
+  } else if (s == "0-1") {
+    return kBlueWin;
+  } else if (s == "1/2-1/2") {
+    return kDraw;
+  }
+  return kOpen;
+}
+
+absl::string_view TrimRight(absl::string_view s) {
+  while (!s.empty() && (s.back() == ' ' || s.back() == '\t' ||
+                        s.back() == '\r')) {
+    s.remove_suffix(1);
+  }
+  return s;
+}
+
+// replays the records of one buffer, line by line
+class RecordParser {
+ public:
+  RecordParser(absl::string_view source, const ImportOptions& options,
+               const RecordCallback& callback, ImportStats* stats)
+      : options_(options), callback_(callback), stats_(stats) {
+    record_.source = source;
+  }
+
+  void AddLine(absl::string_view line, int line_number);
+  // called at empty lines and at the end of the buffer
+  void EndRecord();
+
+ private:
+  void ParseTag(absl::string_view line);
+  void ParseMove(absl::string_view token);
+  bool PrepareBoard();
+  void Error(absl::string_view message, absl::string_view token = "");
+
+  const ImportOptions& options_;
+  const RecordCallback& callback_;
+  ImportStats* stats_;
+
+  bool in_record_ = false;
+  bool failed_ = false;
+  bool board_ready_ = false;
+  int board_size_ = 0;
+  int line_number_ = 0;
+  GameRecord record_;
+  // empty boards by size, copied at the start of each record
+  std::unique_ptr<Board> initial_boards_[kMaxBoardSize + 1];
+};
+
+void RecordParser::AddLine(absl::string_view line, int line_number) {
+  line_number_ = line_number;
+  line = TrimRight(line);
+  size_t start = line.find_first_not_of(" \t");
+  if (start == absl::string_view::npos) {
+    EndRecord();
+    return;
+  }
+  line.remove_prefix(start);
+  if (line.front() == '#') {
+    return;
+  }
+
+  if (!in_record_) {
+    in_record_ = true;
+    failed_ = false;
+    board_ready_ = false;
+    board_size_ = options_.board_size;
+    record_.line = line_number;
+    record_.declared_result = kOpen;
+    record_.actions.clear();
+    stats_->num_records++;
+  }
+  if (failed_) {
+    return;
+  }
+
+  if (line.front() == '[') {
+    ParseTag(line);
+    return;
+  }
+  while (!line.empty() && !failed_) {
+    size_t i = 0;
+    while (i < line.size() && IsSeparator(line[i])) {
+      i++;
+    }
+    size_t j = i;
+    while (j < line.size() && !IsSeparator(line[j])) {
+      j++;
+    }
+    if (j > i) {
+      ParseMove(line.substr(i, j - i));
+    }
+    line.remove_prefix(j);
+  }
+}
+
+void RecordParser::EndRecord() {
+  if (!in_record_) {
+    return;
+  }
+  in_record_ = false;
+  if (failed_ || !PrepareBoard()) {
+    return;
+  }
+  int result = record_.board.result();
+  if (result != kOpen && record_.declared_result != kOpen &&
+      result != record_.declared_result) {
+    line_number_ = record_.line;
+    Error("declared result does not match the game");
+    return;
+  }
+  stats_->num_games++;
+  stats_->num_moves += record_.actions.size();
+  if (callback_) {
+    callback_(record_);
+  }
+}
+
+void RecordParser::ParseTag(absl::string_view line) {
+  // [Name "value"]
+  size_t name_end = line.find_first_of(" \t");
+  size_t open_quote = line.find('"');
+  size_t close_quote = line.rfind('"');
+  if (line.back() != ']' || name_end == absl::string_view::npos ||
+      open_quote == absl::string_view::npos || close_quote <= open_quote) {
+    Error("malformed tag", line);
+    return;
+  }
+  absl::string_view name = line.substr(1, name_end - 1);
+  absl::string_view value =
+      line.substr(open_quote + 1, close_quote - open_quote - 1);
+
+  if (EqualsWord(name, "size") || EqualsWord(name, "boardsize")) {
+    if (board_ready_) {
+      Error("size tag after the first move", line);
+      return;
+    }
+    int size = 0;
+    for (char c : value) {
+      if (!IsDigit(c) || size > kMaxBoardSize) {
+        size = -1;
+        break;
+      }
+      size = size * 10 + (c - '0');
+    }
+    if (size < kMinBoardSize || size > kMaxBoardSize) {
+      Error("unsupported board size", line);
+      return;
+    }
+    board_size_ = size;
+  } else if (EqualsWord(name, "result")) {
+    record_.declared_result = ResultFromString(value);
+  }
+}
+
+bool RecordParser::PrepareBoard() {
+  if (!board_ready_) {
+    if (board_size_ < kMinBoardSize || board_size_ > kMaxBoardSize) {
+      Error("unsupported board size");
+      return false;
+    }
+    if (initial_boards_[board_size_] == nullptr) {
+      initial_boards_[board_size_] =
+          std::make_unique<Board>(board_size_, false);
+    }
+    record_.board = *initial_boards_[board_size_];
+    board_ready_ = true;
+  }
+  return true;
+}
+
+void RecordParser::ParseMove(absl::string_view token) {
+  // skip move numbers like "12." or "12..."
+  size_t i = 0;
+  while (i < token.size() && IsDigit(token[i])) {
+    i++;
+  }
+  if (i > 0 && i < token.size() && token[i] == '.') {
+    while (i < token.size() && token[i] == '.') {
+      i++;
+    }
+    token.remove_prefix(i);
+    if (token.empty()) {
+      return;
+    }
+  }
+  if (token == "*" || ResultFromString(token) != kOpen) {
+    return;
+  }
+  if (!PrepareBoard()) {
+    return;
+  }
+
+  const Board& board = record_.board;
+  const Player player = record_.actions.size() % 2;
+  Action action;
+  if (EqualsWord(token, "swap")) {
+    if (record_.actions.size() != 1) {
+      Error("swap is only allowed as the second move", token);
+      return;
+    }
+    action = record_.actions[0];
+  } else {
+    // [x|o] column row
+    size_t pos = 0;
+    if (token.size() > 1 && IsLetter(token[1]) &&
+        (ToLower(token[0]) == 'x' || ToLower(token[0]) == 'o')) {
+      if ((ToLower(token[0]) == 'x') != (player == kRedPlayer)) {
+        Error("move by the wrong player", token);
+        return;
+      }
+      pos = 1;
+    }
+    int column = 0;
+    size_t letters = pos;
+    while (pos < token.size() && IsLetter(token[pos]) &&
+           column <= kMaxBoardSize) {
+      column = column * 26 + (ToLower(token[pos]) - 'a' + 1);
+      pos++;
+    }
+    int row = 0;
+    size_t digits = pos;
+    while (pos < token.size() && IsDigit(token[pos]) &&
+           row <= kMaxBoardSize) {
+      row = row * 10 + (token[pos] - '0');
+      pos++;
+    }
+    if (letters == digits || digits == pos || pos != token.size()) {
+      Error("not a move", token);
+      return;
+    }
+    if (column > board.size() || row < 1 || row > board.size()) {
+      Error("move is off the board", token);
+      return;
+    }
+    Position position = {column - 1, options_.rows_from_bottom
+                                         ? row - 1
+                                         : board.size() - row};
+    action = board.PositionToAction(position);
+  }
+
+  if (board.result() != kOpen) {
+    Error("move after the end of the game", token);
+    return;
+  }
+  if (!board.IsLegalAction(player, action)) {
+    Error("illegal move", token);
+    return;
+  }
+  record_.board.ApplyAction(player, action);
+  record_.actions.push_back(action);
+}
+
+void RecordParser::Error(absl::string_view message, absl::string_view token) {
+  failed_ = true;
+  stats_->num_errors++;
+  if (stats_->errors.size() < kMaxImportErrors) {
+    std::string s(record_.source);
+    s += ":" + std::to_string(line_number_) + ": ";
+    s.append(message.data(), message.size());
+    if (!token.empty()) {
+      s += ": ";
+      s.append(token.data(), token.size());
+    }
+    stats_->errors.push_back(s);
+  }
+}
+
+}  // namespace
+
+ImportStats& ImportStats::operator+=(const ImportStats& other) {
+  num_records += other.num_records;
+  num_games += other.num_games;
+  num_moves += other.num_moves;
+  num_errors += other.num_errors;
+  for (const std::string& error : other.errors) {
+    if (errors.size() >= kMaxImportErrors) {
+      break;
+    }
+    errors.push_back(error);
+  }
+  return *this;
+}
+
+ImportStats ImportRecords(absl::string_view text, absl::string_view source,
+                          const ImportOptions& options,
+                          const RecordCallback& callback) {
+  ImportStats stats;
+  RecordParser parser(source, options, callback, &stats);
+  int line_number = 1;
+  while (!text.empty()) {
+    size_t end = text.find('\n');
+    if (end == absl::string_view::npos) {
+      end = text.size();
+    }
+    parser.AddLine(text.substr(0, end), line_number++);
+    text.remove_prefix(std::min(end + 1, text.size()));
+  }
+  parser.EndRecord();
+  return stats;
+}
+
+MappedFile::MappedFile(const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+  struct stat st;
+  if (fstat(fd, &st) == 0) {
+    size_ = st.st_size;
+    if (size_ == 0) {
+      ok_ = true;
+    } else {
+      data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data_ == MAP_FAILED) {
+        data_ = nullptr;
+        size_ = 0;
+      } else {
+        madvise(data_, size_, MADV_SEQUENTIAL);
+        ok_ = true;
+      }
+    }
+  }
+  close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr) {
+    munmap(data_, size_);
+  }
+}
+
+ImportStats ImportFiles(const std::vector<std::string>& paths,
+                        const ImportOptions& options, int num_threads,
+                        const RecordCallback& callback) {
+  ImportStats stats;
+  std::mutex mutex;
+  std::atomic<size_t> next_path{0};
+
+  auto worker = [&]() {
+    ImportStats thread_stats;
+    for (size_t i = next_path++; i < paths.size(); i = next_path++) {
+      MappedFile file(paths[i]);
+      if (!file.ok()) {
+        thread_stats.num_errors++;
+        if (thread_stats.errors.size() < kMaxImportErrors) {
+          thread_stats.errors.push_back(paths[i] + ": cannot read file");
+        }
+        continue;
+      }
+      thread_stats += ImportRecords(file.contents(), paths[i], options,
+                                    callback);
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    stats += thread_stats;
+  };
+
+  num_threads = std::max(
+      1, std::min(num_threads, static_cast<int>(paths.size())));
+  std::vector<std::thread> threads;
+  for (int t = 1; t < num_threads; t++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  return stats;
+}
+
+}  // namespace twixt
+}  // namespace open_spiel
@@ -0,0 +1,121 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_GAMES_TWIXT_TWIXTRECORD_H_
+#define OPEN_SPIEL_GAMES_TWIXT_TWIXTRECORD_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
+#include "open_spiel/games/twixt/twixtboard.h"
+
+// importer for archives of TwixT game records, e.g.
+//
+//   # game 1
+//   [Size "12"]
+//   [Result "1-0"]
+//   1. xc5 2. swap 3. oe4 4. xh10
+//   5. of9 ...
+//
+//   1. xd4 2. of5 ...
+//
+// * records are separated by empty lines
+// * lines starting with '#' are comments
+// * [Name "value"] lines are tags; Size (or BoardSize) sets the board size,
+//   Result ("1-0", "0-1" or "1/2-1/2") the declared result
+// * all other lines hold moves, separated by blanks, commas or semicolons;
+//   move numbers like "12." and result tokens like "1-0" are skipped
+// * a move is an optional player prefix (x or o), a column label (a, b, ...)
+//   and a row number, as written by TwixTState::ActionToString; case does
+//   not matter
+// * the swap move is written "swap" or as the first move repeated
+//
+// Every record is replayed on a Board: all moves must be legal for the
+// player to move and there must be no moves after the end of the game.
+// Parsing works on the buffer in place; the actions and the board of a
+// record are reused for the next one.
+
+namespace open_spiel {
+namespace twixt {
+
+// number of error messages kept in ImportStats
+const int kMaxImportErrors = 20;
+
+struct ImportOptions {
+  // board size of records without a Size tag
+  int board_size = kDefaultBoardSize;
+  // row 1 is the bottom row instead of the top row
+  bool rows_from_bottom = false;
+};
+
+// a record that has been replayed; only valid during the callback
+struct GameRecord {
+  absl::string_view source;     // name of the file or buffer
+  int line = 0;                 // line where the record starts
+  int declared_result = kOpen;  // from the Result tag, kOpen if none
+  std::vector<Action> actions;  // as applied to TwixTState
+  Board board;                  // position after the last move
+};
+
+struct ImportStats {
+  int64_t num_records = 0;  // records seen, valid or not
+  int64_t num_games = 0;    // records replayed without error
+  int64_t num_moves = 0;    // moves of the valid records
+  int64_t num_errors = 0;
+  std::vector<std::string> errors;  // the first kMaxImportErrors errors
+
+  ImportStats& operator+=(const ImportStats& other);
+};
+
+using RecordCallback = std::function<void(const GameRecord&)>;
+
+// parses all records in text and calls callback for each valid one;
+// source is used in error messages
+ImportStats ImportRecords(absl::string_view text, absl::string_view source,
+                          const ImportOptions& options,
+                          const RecordCallback& callback);
+
+// read-only memory mapping of a whole file
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& path);
+  ~MappedFile();
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  bool ok() const { return ok_; }
+  absl::string_view contents() const {
+    return absl::string_view(static_cast<const char*>(data_), size_);
+  }
+
+ private:
+  void* data_ = nullptr;
+  size_t size_ = 0;
+  bool ok_ = false;
+};
+
+// imports the files, which are shared out among num_threads threads;
+// callback is called from these threads, possibly at the same time
+ImportStats ImportFiles(const std::vector<std::string>& paths,
+                        const ImportOptions& options, int num_threads,
+                        const RecordCallback& callback);
+
+}  // namespace twixt
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_GAMES_TWIXT_TWIXTRECORD_H_
@@ -0,0 +1,310 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/games/twixt/twixtrollout.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "open_spiel/games/twixt/twixtcell.h"
+
+namespace open_spiel {
+namespace twixt {
+namespace {
+
+const int kNumPatterns = 1 << (2 * kMaxCompass);
+// pattern codes of a neighbor
+const int kPatternEmpty = 0;
+const int kPatternRed = 1;
+const int kPatternBlue = 2;
+const int kPatternOffBoard = 3;
+
+// how often (in percent) an intrusion into a bridge is answered
+const int kAnswerPercent = 90;
+
+int PatternCode(int color) {
+  switch (color) {
+    case kRedColor:
+      return kPatternRed;
+    case kBlueColor:
+      return kPatternBlue;
+    case kEmpty:
+      return kPatternEmpty;
+    default:
+      return kPatternOffBoard;
+  }
+}
+
+int Neighbor(uint16_t pattern, int dir) { return (pattern >> (2 * dir)) & 3; }
+
+inline int OppDir(int dir) { return (dir + kMaxCompass / 2) % kMaxCompass; }
+
+// two steps along the axis of player, i.e. towards one of its borders
+bool IsSteep(Player player, int dir) {
+  const Position& offsets = GetLinkDescriptor(dir).offsets;
+  return std::abs(player == kRedPlayer ? offsets.y : offsets.x) == 2;
+}
+
+// the weight level of each pattern for each player
+std::vector<uint8_t> BuildLevelTable(Player player) {
+  const int own = player == kRedPlayer ? kPatternRed : kPatternBlue;
+  const int opponent = player == kRedPlayer ? kPatternBlue : kPatternRed;
+  std::vector<uint8_t> table(kNumPatterns);
+  for (int pattern = 0; pattern < kNumPatterns; pattern++) {
+    int points = 0;
+    int num_own = 0;
+    for (int dir = 0; dir < kMaxCompass; dir++) {
+      int neighbor = Neighbor(pattern, dir);
+      if (neighbor == own) {
+        // extends a chain
+        num_own++;
+        points += IsSteep(player, dir) ? 2 : 1;
+      } else if (neighbor == opponent && IsSteep(1 - player, dir)) {
+        // blocks an extension of the opponent
+        points += 2;
+      }
+    }
+    if (num_own >= 2) {
+      // joins two pegs
+      points += 2;
+    }
+    table[pattern] = std::min(points, 5);
+  }
+  return table;
+}
+
+const std::vector<uint8_t>& LevelTable(Player player) {
+  static const std::vector<uint8_t>* kTables[kNumPlayers] = {
+      new std::vector<uint8_t>(BuildLevelTable(kRedPlayer)),
+      new std::vector<uint8_t>(BuildLevelTable(kBluePlayer))};
+  return *kTables[player];
+}
+
+}  // namespace
+
+RolloutPolicy::RolloutPolicy(int board_size)
+    : size_(board_size), num_cells_(board_size * board_size) {
+  SPIEL_CHECK_GE(size_, kMinBoardSize);
+  SPIEL_CHECK_LE(size_, kMaxBoardSize);
+  for (int dir = 0; dir < kMaxCompass; dir++) {
+    const Position& offsets = GetLinkDescriptor(dir).offsets;
+    neighbors_[dir].assign(num_cells_, -1);
+    for (int x = 0; x < size_; x++) {
+      for (int y = 0; y < size_; y++) {
+        int tx = x + offsets.x;
+        int ty = y + offsets.y;
+        if (tx >= 0 && tx < size_ && ty >= 0 && ty < size_) {
+          neighbors_[dir][x * size_ + y] = tx * size_ + ty;
+        }
+      }
+    }
+  }
+  patterns_.resize(num_cells_);
+  for (Player player = 0; player < kNumPlayers; player++) {
+    levels_[player].resize(num_cells_);
+    indices_[player].resize(num_cells_);
+    for (int level = 0; level <= kUselessLevel; level++) {
+      buckets_[player][level].reserve(num_cells_);
+    }
+  }
+  answers_.reserve(kMaxCompass * kMaxCompass);
+}
+
+int RolloutPolicy::Weight(const Board& board, Player player,
+                          Action cell) const {
+  if (!board.IsLegalAction(player, cell)) {
+    return 0;
+  }
+  int pattern = 0;
+  for (int dir = 0; dir < kMaxCompass; dir++) {
+    int neighbor = neighbors_[dir][cell];
+    int code = neighbor < 0
+        ? kPatternOffBoard
+        : PatternCode(
+              board.GetConstCell(board.ActionToPosition(neighbor)).color());
+    pattern |= code << (2 * dir);
+  }
+  return 1 << LevelTable(player)[pattern];
+}
+
+void RolloutPolicy::Reset(const Board& board) {
+  for (Player player = 0; player < kNumPlayers; player++) {
+    std::fill(levels_[player].begin(), levels_[player].end(), -1);
+    for (int level = 0; level <= kUselessLevel; level++) {
+      buckets_[player][level].clear();
+    }
+  }
+  for (int cell = 0; cell < num_cells_; cell++) {
+    uint16_t pattern = 0;
+    for (int dir = 0; dir < kMaxCompass; dir++) {
+      int neighbor = neighbors_[dir][cell];
+      int code = neighbor < 0
+          ? kPatternOffBoard
+          : PatternCode(
+                board.GetConstCell(board.ActionToPosition(neighbor)).color());
+      pattern |= code << (2 * dir);
+    }
+    patterns_[cell] = pattern;
+    for (Player player = 0; player < kNumPlayers; player++) {
+      if (board.IsLegalAction(player, cell)) {
+        Insert(player, cell, LevelTable(player)[pattern]);
+      }
+    }
+  }
+}
+
+void RolloutPolicy::Insert(Player player, int cell, int level) {
+  levels_[player][cell] = level;
+  indices_[player][cell] = buckets_[player][level].size();
+  buckets_[player][level].push_back(cell);
+}
+
+void RolloutPolicy::Remove(Player player, int cell) {
+  // the last cell of the bucket takes the place of the removed one
+  std::vector<int32_t>& bucket = buckets_[player][levels_[player][cell]];
+  int index = indices_[player][cell];
+  bucket[index] = bucket.back();
+  indices_[player][bucket[index]] = index;
+  bucket.pop_back();
+  levels_[player][cell] = -1;
+}
+
+void RolloutPolicy::PlacePeg(int cell, int color) {
+  for (Player player = 0; player < kNumPlayers; player++) {
+    if (levels_[player][cell] >= 0) {
+      Remove(player, cell);
+    }
+  }
+  const int code = PatternCode(color);
+  for (int dir = 0; dir < kMaxCompass; dir++) {
+    int neighbor = neighbors_[dir][cell];
+    if (neighbor < 0) {
+      continue;
+    }
+    // the peg is in the opposite direction seen from the neighbor
+    int shift = 2 * OppDir(dir);
+    uint16_t pattern = (patterns_[neighbor] & ~(3 << shift)) | (code << shift);
+    patterns_[neighbor] = pattern;
+    for (Player player = 0; player < kNumPlayers; player++) {
+      int level = LevelTable(player)[pattern];
+      if (levels_[player][neighbor] >= 0 &&
+          levels_[player][neighbor] != kUselessLevel &&
+          levels_[player][neighbor] != level) {
+        Remove(player, neighbor);
+        Insert(player, neighbor, level);
+      }
+    }
+  }
+}
+
+Action RolloutPolicy::Sample(Player player, std::mt19937* rng) const {
+  // a bucket is picked by its total weight, then a cell of it uniformly
+  uint64_t total = 0;
+  for (int level = 0; level < kNumLevels; level++) {
+    total += static_cast<uint64_t>(buckets_[player][level].size()) << level;
+  }
+  if (total == 0) {
+    return -1;
+  }
+  uint64_t r = (*rng)() % total;
+  for (int level = 0; level < kNumLevels; level++) {
+    uint64_t weight =
+        static_cast<uint64_t>(buckets_[player][level].size()) << level;
+    if (r < weight) {
+      return buckets_[player][level][r >> level];
+    }
+    r -= weight;
+  }
+  SpielFatalError("RolloutPolicy::Sample: no bucket");
+}
+
+void RolloutPolicy::FindAnswers(const Board& board, Player player,
+                                int cell) {
+  answers_.clear();
+  const int own = player == kRedPlayer ? kPatternRed : kPatternBlue;
+  int pegs[kMaxCompass];
+  int num_pegs = 0;
+  for (int dir = 0; dir < kMaxCompass; dir++) {
+    if (Neighbor(patterns_[cell], dir) == own) {
+      pegs[num_pegs++] = neighbors_[dir][cell];
+    }
+  }
+  // cell was a hole between each two of the pegs; the other holes of the
+  // pair answer
+  for (int i = 0; i < num_pegs; i++) {
+    for (int j = i + 1; j < num_pegs; j++) {
+      for (int dir = 0; dir < kMaxCompass; dir++) {
+        int hole = neighbors_[dir][pegs[i]];
+        if (hole < 0 || hole == cell || !board.IsLegalAction(player, hole)) {
+          continue;
+        }
+        for (int dir2 = 0; dir2 < kMaxCompass; dir2++) {
+          if (neighbors_[dir2][pegs[j]] == hole) {
+            answers_.push_back(hole);
+          }
+        }
+      }
+    }
+  }
+}
+
+int RolloutPolicy::Rollout(Board* board, std::mt19937* rng,
+                           std::vector<Action>* actions) {
+  while (board->result() == kOpen && board->move_counter() < 2) {
+    Player player = board->move_counter() % 2;
+    board->GetLegalActions(player, &legal_);
+    Action action = legal_[(*rng)() % legal_.size()];
+    board->ApplyAction(player, action);
+    if (actions != nullptr) {
+      actions->push_back(action);
+    }
+  }
+  if (board->result() != kOpen) {
+    return board->result();
+  }
+
+  Reset(*board);
+  answers_.clear();
+  while (board->result() == kOpen) {
+    Player player = board->move_counter() % 2;
+    Action action;
+    if (!answers_.empty() && (*rng)() % 100 < kAnswerPercent) {
+      action = answers_[(*rng)() % answers_.size()];
+    } else {
+      // useless moves are moved to their own bucket when they come up
+      action = Sample(player, rng);
+      while (action >= 0 && board->IsUselessMove(player, action)) {
+        Remove(player, action);
+        Insert(player, action, kUselessLevel);
+        action = Sample(player, rng);
+      }
+      if (action < 0) {
+        // only useless moves are left
+        const std::vector<int32_t>& useless = buckets_[player][kUselessLevel];
+        SPIEL_CHECK_FALSE(useless.empty());
+        action = useless[(*rng)() % useless.size()];
+      }
+    }
+    board->ApplyAction(player, action);
+    if (actions != nullptr) {
+      actions->push_back(action);
+    }
+    PlacePeg(action, player);
+    FindAnswers(*board, 1 - player, action);
+  }
+  return board->result();
+}
+
+}  // namespace twixt
+}  // namespace open_spiel
@@ -0,0 +1,97 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_GAMES_TWIXT_TWIXTROLLOUT_H_
+#define OPEN_SPIEL_GAMES_TWIXT_TWIXTROLLOUT_H_
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "open_spiel/games/twixt/twixtboard.h"
+#include "open_spiel/spiel.h"
+
+// Rollouts with pattern weights instead of uniform moves.
+//
+// The pattern of a cell is what lies at its eight knight-move neighbors
+// (empty, red, blue or off board, 2 bits each), so there are 4^8 patterns.
+// A table computed once from the link directions gives each pattern a
+// weight for each player:
+// * a peg of the player's own in a steep direction (two steps along the
+//   player's axis, towards one of the player's borders) extends a chain,
+// * a peg of the opponent's in the opponent's steep directions marks a
+//   cell the opponent wants to extend to, so a peg there blocks,
+// * a cell next to two own pegs joins them.
+// Besides, when the opponent's last peg took one of two holes that join
+// two pegs of the player, the other hole is played (answering the
+// intrusion into the bridge), and useless moves (Board::IsUselessMove) are
+// not played while there are others.
+//
+// The weights are powers of two. The legal cells of each player are kept
+// in one bucket per weight, so a move is sampled in O(1) (pick a bucket by
+// its total weight, then a cell of it) and a peg only moves its eight
+// neighbors between buckets.
+//
+// A policy must only be used by one thread; keep one per thread.
+
+namespace open_spiel {
+namespace twixt {
+
+class RolloutPolicy {
+ public:
+  explicit RolloutPolicy(int board_size);
+
+  // plays the game on board to its end with moves of the policy and
+  // returns the result (kRedWin, kBlueWin or kDraw); the first two moves,
+  // which may include the swap, are uniform; if actions is not null, the
+  // moves are appended to it
+  int Rollout(Board* board, std::mt19937* rng,
+              std::vector<Action>* actions = nullptr);
+
+  // the weight of cell for player with the pegs currently on board
+  int Weight(const Board& board, Player player, Action cell) const;
+
+ private:
+  static const int kNumLevels = 6;  // weights 1, 2, 4, ..., 32
+  // the bucket of the useless moves, which have no weight
+  static const int kUselessLevel = kNumLevels;
+
+  void Reset(const Board& board);
+  void Insert(Player player, int cell, int level);
+  void Remove(Player player, int cell);
+  void PlacePeg(int cell, int color);
+  // -1 if the buckets of player are empty
+  Action Sample(Player player, std::mt19937* rng) const;
+  // the cells that answer an intrusion of the opponent's peg at cell
+  // into a bridge of player
+  void FindAnswers(const Board& board, Player player, int cell);
+
+  int size_;
+  int num_cells_;
+  // knight-move neighbor of each cell in each direction, or -1
+  std::vector<int32_t> neighbors_[kMaxCompass];
+  std::vector<uint16_t> patterns_;  // per cell
+  // per player: the bucket of each cell (-1 if not legal) and its index
+  // in the bucket
+  std::vector<int8_t> levels_[kNumPlayers];
+  std::vector<int32_t> indices_[kNumPlayers];
+  std::vector<int32_t> buckets_[kNumPlayers][kNumLevels + 1];
+  std::vector<int32_t> answers_;
+  std::vector<Action> legal_;  // of the first two moves
+};
+
+}  // namespace twixt
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_GAMES_TWIXT_TWIXTROLLOUT_H_
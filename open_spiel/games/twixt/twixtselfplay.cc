@@ -0,0 +1,463 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/games/twixt/twixtselfplay.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>  // NOLINT
+#include <mutex>               // NOLINT
+#include <random>
+#include <thread>  // NOLINT
+
+namespace open_spiel {
+namespace twixt {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Node {
+  int32_t first_child;  // -1 if not expanded
+  int32_t visits;
+  float value_sum;  // for the player who moved into the node
+  float prior;
+  int16_t action;
+  int16_t num_children;
+};
+
+// The MCTS search of one game, see twixtselfplay.h.
+class ResumableSearch {
+ public:
+  ResumableSearch(const TwixTState& initial_state,
+                  const SelfPlayOptions& options,
+                  const CompactActions* compact_actions)
+      : options_(options),
+        compact_actions_(compact_actions),
+        initial_state_(initial_state),
+        root_(new TwixTState(initial_state)),
+        scratch_(new TwixTState(initial_state)) {}
+
+  // starts game number game, or no game if game is -1
+  void StartGame(int game) {
+    game_ = game;
+    initial_state_.CloneInto(root_.get());
+    actions_.clear();
+    rng_.seed(options_.seed * 1000003 + game);
+    ResetTree();
+  }
+
+  int game() const { return game_; }
+  const std::vector<Action>& actions() const { return actions_; }
+  const TwixTState& state() const { return *root_; }
+
+  // runs simulations and plays moves until a leaf needs an evaluation
+  // (true) or the game has ended (false)
+  bool Advance() {
+    while (true) {
+      if (simulations_ == options_.num_simulations) {
+        Action action = ChooseMove();
+        root_->ApplyAction(action);
+        actions_.push_back(action);
+        ResetTree();
+        if (root_->IsTerminal()) {
+          return false;
+        }
+      }
+
+      root_->CloneInto(scratch_.get());
+      path_.assign(1, 0);
+      movers_.assign(1, kInvalidPlayer);
+      int node = 0;
+      while (nodes_[node].first_child >= 0) {
+        node = SelectChild(node);
+        movers_.push_back(scratch_->CurrentPlayer());
+        scratch_->ApplyAction(nodes_[node].action);
+        path_.push_back(node);
+      }
+      if (!scratch_->IsTerminal()) {
+        return true;
+      }
+      Backup(scratch_->PlayerReturn(kRedPlayer));
+    }
+  }
+
+  // the observation of the leaf for the player to move
+  void WriteObservation(float* observation, int observation_size) const {
+    scratch_->ObservationTensor(scratch_->CurrentPlayer(),
+                                absl::MakeSpan(observation, observation_size));
+  }
+
+  // expands the leaf with priors and backs up value, which is for the
+  // player to move at the leaf
+  void Resume(const float* priors, float value) {
+    std::vector<Action> legal = options_.prune_useless_moves
+                                    ? scratch_->LiveLegalActions()
+                                    : scratch_->LegalActions();
+    SPIEL_CHECK_FALSE(legal.empty());
+    // the row of priors, indexed by action or by compact index
+    prior_indices_ = legal;
+    if (compact_actions_ != nullptr) {
+      const Player player = scratch_->CurrentPlayer();
+      for (Action& index : prior_indices_) {
+        index = compact_actions_->ToCompact(scratch_->board(), player, index);
+      }
+    }
+    float sum = 0;
+    for (Action index : prior_indices_) {
+      sum += priors[index];
+    }
+    const int num_legal = legal.size();
+    Node& leaf = nodes_[path_.back()];
+    leaf.first_child = nodes_.size();
+    leaf.num_children = num_legal;
+    for (int i = 0; i < num_legal; i++) {
+      float prior =
+          sum > 0 ? priors[prior_indices_[i]] / sum : 1.0f / num_legal;
+      nodes_.push_back({-1, 0, 0, prior, static_cast<int16_t>(legal[i]), 0});
+    }
+    Backup(scratch_->CurrentPlayer() == kRedPlayer ? value : -value);
+  }
+
+ private:
+  void ResetTree() {
+    nodes_.assign(1, {-1, 0, 0, 1, -1, 0});
+    simulations_ = 0;
+  }
+
+  int SelectChild(int node) const {
+    const Node& parent = nodes_[node];
+    const float scale = options_.uct_c * std::sqrt(parent.visits);
+    int best = parent.first_child;
+    float best_score = -1e30;
+    for (int i = parent.first_child;
+         i < parent.first_child + parent.num_children; i++) {
+      const Node& child = nodes_[i];
+      float q = child.visits > 0 ? child.value_sum / child.visits : 0;
+      float score = q + scale * child.prior / (1 + child.visits);
+      if (score > best_score) {
+        best_score = score;
+        best = i;
+      }
+    }
+    return best;
+  }
+
+  // red_value is the value for red; each node gets it for the player who
+  // moved into it (a player moves twice in a row after a link removal)
+  void Backup(float red_value) {
+    for (int i = path_.size() - 1; i >= 0; i--) {
+      nodes_[path_[i]].visits++;
+      nodes_[path_[i]].value_sum +=
+          movers_[i] == kBluePlayer ? -red_value : red_value;
+    }
+    simulations_++;
+  }
+
+  Action ChooseMove() {
+    const Node& root = nodes_[0];
+    int best = root.first_child;
+    if (static_cast<int>(actions_.size()) < options_.num_sampled_moves) {
+      int r = rng_() % std::max(1, root.visits - 1);
+      for (int i = root.first_child;
+           i < root.first_child + root.num_children; i++) {
+        best = i;
+        r -= nodes_[i].visits;
+        if (r < 0) {
+          break;
+        }
+      }
+    } else {
+      for (int i = root.first_child;
+           i < root.first_child + root.num_children; i++) {
+        if (nodes_[i].visits > nodes_[best].visits) {
+          best = i;
+        }
+      }
+    }
+    return nodes_[best].action;
+  }
+
+  const SelfPlayOptions& options_;
+  const CompactActions* compact_actions_;  // null: priors by action
+  const TwixTState& initial_state_;
+  std::unique_ptr<TwixTState> root_;     // the game
+  std::unique_ptr<TwixTState> scratch_;  // the state of a simulation
+  std::vector<Node> nodes_;              // the tree, nodes_[0] is the root
+  std::vector<int> path_;                // from the root to the leaf
+  std::vector<Player> movers_;           // who moved into each of them
+  std::vector<Action> prior_indices_;
+  std::vector<Action> actions_;
+  std::mt19937 rng_;
+  int game_ = -1;
+  int simulations_ = 0;
+};
+
+int PolicySize(const Game& game, bool compact_actions) {
+  if (compact_actions) {
+    const auto& twixt_game = static_cast<const TwixTGame&>(game);
+    return CompactActions(twixt_game.board_size()).size();
+  }
+  return game.NumDistinctActions();
+}
+
+void AddStats(const SelfPlayStats& from, SelfPlayStats* to) {
+  to->num_games += from.num_games;
+  to->num_moves += from.num_moves;
+  for (int i = 0; i < 3; i++) {
+    to->num_results[i] += from.num_results[i];
+  }
+  to->leaf_seconds += from.leaf_seconds;
+}
+
+}  // namespace
+
+StubEvaluator::StubEvaluator(const Game& game, int hidden, int seed,
+                             bool compact_actions)
+    : observation_size_(game.ObservationTensorSize()),
+      policy_size_(PolicySize(game, compact_actions)),
+      hidden_(hidden) {
+  SPIEL_CHECK_GT(hidden, 0);
+  std::mt19937 rng(seed);
+  auto init = [&rng](std::vector<float>* weights, int size, int fan_in) {
+    std::uniform_real_distribution<float> dist(-1, 1);
+    weights->resize(size);
+    for (float& weight : *weights) {
+      weight = dist(rng) / std::sqrt(fan_in);
+    }
+  };
+  init(&input_weights_, observation_size_ * hidden_, observation_size_);
+  init(&policy_weights_, hidden_ * policy_size_, hidden_);
+  init(&value_weights_, hidden_, hidden_);
+}
+
+void StubEvaluator::Evaluate(int batch_size, const float* observations,
+                             float* priors, float* values) {
+  activations_.assign(batch_size * hidden_, 0);
+  for (int b = 0; b < batch_size; b++) {
+    const float* observation = observations + b * observation_size_;
+    float* activation = &activations_[b * hidden_];
+    // observations are mostly zeros
+    for (int i = 0; i < observation_size_; i++) {
+      if (observation[i] != 0) {
+        const float* weights = &input_weights_[i * hidden_];
+        for (int h = 0; h < hidden_; h++) {
+          activation[h] += observation[i] * weights[h];
+        }
+      }
+    }
+    float value = 0;
+    for (int h = 0; h < hidden_; h++) {
+      activation[h] = std::max(activation[h], 0.0f);
+      value += activation[h] * value_weights_[h];
+    }
+    values[b] = std::tanh(value);
+
+    float* logits = priors + b * policy_size_;
+    std::fill(logits, logits + policy_size_, 0.0f);
+    for (int h = 0; h < hidden_; h++) {
+      const float* weights = &policy_weights_[h * policy_size_];
+      for (int a = 0; a < policy_size_; a++) {
+        logits[a] += activation[h] * weights[a];
+      }
+    }
+    float max_logit = *std::max_element(logits, logits + policy_size_);
+    float sum = 0;
+    for (int a = 0; a < policy_size_; a++) {
+      logits[a] = std::exp(logits[a] - max_logit);
+      sum += logits[a];
+    }
+    for (int a = 0; a < policy_size_; a++) {
+      logits[a] /= sum;
+    }
+  }
+}
+
+double SelfPlayStats::FillRate(int batch_size) const {
+  return num_batches > 0
+             ? static_cast<double>(num_evaluations) / (num_batches * batch_size)
+             : 0;
+}
+
+double SelfPlayStats::MeanBatchSeconds() const {
+  return num_batches > 0 ? evaluation_seconds / num_batches : 0;
+}
+
+double SelfPlayStats::MeanLeafSeconds() const {
+  return num_evaluations > 0 ? leaf_seconds / num_evaluations : 0;
+}
+
+SelfPlayStats PlaySelfPlayGames(std::shared_ptr<const Game> game,
+                                LeafEvaluator* evaluator,
+                                const SelfPlayOptions& options,
+                                const GameCallback& callback) {
+  SPIEL_CHECK_EQ(game->GetType().short_name, "twixt");
+  SPIEL_CHECK_GT(options.games_in_flight, 0);
+  SPIEL_CHECK_GT(options.num_simulations, 0);
+  SPIEL_CHECK_GT(options.batch_size, 0);
+  SPIEL_CHECK_GT(options.num_threads, 0);
+  // the compact indices only cover the pegs
+  SPIEL_CHECK_FALSE(options.compact_actions &&
+                    static_cast<const TwixTGame&>(*game).link_removal());
+  const auto start_time = Clock::now();
+  const int observation_size = game->ObservationTensorSize();
+  const int policy_size = PolicySize(*game, options.compact_actions);
+  std::unique_ptr<CompactActions> compact_actions;
+  if (options.compact_actions) {
+    compact_actions.reset(new CompactActions(
+        static_cast<const TwixTGame&>(*game).board_size()));
+  }
+  const int num_searches = std::min(options.games_in_flight,
+                                    std::max(options.num_games, 1));
+
+  std::unique_ptr<TwixTState> initial_state(
+      static_cast<TwixTState*>(game->NewInitialState().release()));
+  std::vector<std::unique_ptr<ResumableSearch>> searches;
+  for (int s = 0; s < num_searches; s++) {
+    searches.emplace_back(new ResumableSearch(*initial_state, options,
+                                               compact_actions.get()));
+    searches[s]->StartGame(s < options.num_games ? s : -1);
+  }
+
+  // one row per search, rows are handed out in the order searches suspend
+  std::vector<float> observations(num_searches * observation_size);
+  std::vector<float> priors(num_searches * policy_size);
+  std::vector<float> values(num_searches);
+  std::vector<int> rows(num_searches, -1);
+  std::vector<Clock::time_point> suspended_at(num_searches);
+  std::atomic<int> next_row(0);
+  std::atomic<int> next_search(0);
+  std::atomic<int> next_game(num_searches);
+  std::mutex callback_mutex;
+
+  const int num_threads = std::min(options.num_threads, num_searches);
+  std::vector<SelfPlayStats> thread_stats(num_threads);
+
+  // resumes search s with its row and advances it to its next leaf
+  auto step = [&](int s, SelfPlayStats* stats) {
+    ResumableSearch& search = *searches[s];
+    if (rows[s] >= 0) {
+      std::chrono::duration<double> latency = Clock::now() - suspended_at[s];
+      stats->leaf_seconds += latency.count();
+      search.Resume(&priors[rows[s] * policy_size], values[rows[s]]);
+      rows[s] = -1;
+    }
+    while (search.game() >= 0) {
+      if (search.Advance()) {
+        rows[s] = next_row++;
+        search.WriteObservation(&observations[rows[s] * observation_size],
+                                observation_size);
+        suspended_at[s] = Clock::now();
+        return;
+      }
+      const TwixTState& state = search.state();
+      stats->num_games++;
+      stats->num_moves += search.actions().size();
+      stats->num_results[state.board().result() - kRedWin]++;
+      if (callback) {
+        std::lock_guard<std::mutex> lock(callback_mutex);
+        callback(search.actions(), state.Returns());
+      }
+      // the game does not depend on the search that plays it
+      int game = next_game++;
+      search.StartGame(game < options.num_games ? game : -1);
+    }
+  };
+  auto work = [&](int thread) {
+    for (int s = next_search++; s < num_searches; s = next_search++) {
+      step(s, &thread_stats[thread]);
+    }
+  };
+
+  // the other threads wait for the next round, do their share of it and
+  // report back
+  std::mutex mutex;
+  std::condition_variable round_started, round_done;
+  int64_t round = 0;
+  int num_busy = 0;
+  bool stop = false;
+  std::vector<std::thread> threads;
+  for (int t = 1; t < num_threads; t++) {
+    threads.emplace_back([&, t]() {
+      int64_t seen = 0;
+      while (true) {
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          round_started.wait(lock, [&]() { return stop || round != seen; });
+          if (stop) {
+            return;
+          }
+          seen = round;
+        }
+        work(t);
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--num_busy == 0) {
+          round_done.notify_one();
+        }
+      }
+    });
+  }
+
+  SelfPlayStats stats;
+  while (true) {
+    next_row = 0;
+    next_search = 0;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      round++;
+      num_busy = num_threads - 1;
+    }
+    round_started.notify_all();
+    work(0);
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      round_done.wait(lock, [&]() { return num_busy == 0; });
+    }
+
+    const int num_rows = next_row;
+    if (num_rows == 0) {
+      break;
+    }
+    stats.num_rounds++;
+    const auto evaluation_start = Clock::now();
+    for (int row = 0; row < num_rows; row += options.batch_size) {
+      evaluator->Evaluate(std::min(options.batch_size, num_rows - row),
+                          &observations[row * observation_size],
+                          &priors[row * policy_size], &values[row]);
+      stats.num_batches++;
+    }
+    stats.evaluation_seconds +=
+        std::chrono::duration<double>(Clock::now() - evaluation_start).count();
+    stats.num_evaluations += num_rows;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop = true;
+  }
+  round_started.notify_all();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (const SelfPlayStats& from : thread_stats) {
+    AddStats(from, &stats);
+  }
+  stats.seconds =
+      std::chrono::duration<double>(Clock::now() - start_time).count();
+  return stats;
+}
+
+}  // namespace twixt
+}  // namespace open_spiel
@@ -0,0 +1,132 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_GAMES_TWIXT_TWIXTSELFPLAY_H_
+#define OPEN_SPIEL_GAMES_TWIXT_TWIXTSELFPLAY_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "open_spiel/games/twixt/twixt.h"
+#include "open_spiel/games/twixt/twixtcompact.h"
+#include "open_spiel/spiel.h"
+
+// Self-play of many TwixT games at once, with batched leaf evaluation.
+//
+// Each game in flight is played by its own MCTS search (PUCT with the
+// priors and values of an evaluator). A search runs until it reaches a
+// leaf that needs an evaluation, writes the observation of the leaf into
+// a row of a shared buffer and suspends; it is resumed with the priors and
+// the value of that row. The scheduler works in rounds:
+// * the threads advance all searches that are not suspended, or were just
+//   resumed, up to their next leaf,
+// * the rows are evaluated in batches of batch_size,
+// * the next round resumes every search with its row.
+// A search is a plain object that keeps where it stopped (a stackless
+// coroutine written by hand), so thousands of them need no thread or stack
+// of their own; the memory of a search is its tree, about 20 bytes per
+// legal move of each expanded node.
+
+namespace open_spiel {
+namespace twixt {
+
+// Evaluates batches of observations. Observations, priors and values are
+// contiguous and row-major: one row of observation_size floats per state,
+// one row of priors (probabilities, not necessarily zero for illegal
+// actions) and one value in [-1, 1] for the player to move. The priors are
+// indexed by action, or by compact index with compact_actions (see
+// twixtcompact.h).
+class LeafEvaluator {
+ public:
+  virtual ~LeafEvaluator() = default;
+  virtual void Evaluate(int batch_size, const float* observations,
+                        float* priors, float* values) = 0;
+};
+
+// A small network on the CPU with fixed pseudo-random weights: one hidden
+// relu layer, a softmax policy head and a tanh value head. It stands in
+// for a real model in tests and benchmarks; its cost grows with hidden.
+class StubEvaluator : public LeafEvaluator {
+ public:
+  StubEvaluator(const Game& game, int hidden, int seed,
+                bool compact_actions = false);
+
+  void Evaluate(int batch_size, const float* observations, float* priors,
+                float* values) override;
+
+ private:
+  int observation_size_;
+  int policy_size_;
+  int hidden_;
+  std::vector<float> input_weights_;   // observation_size x hidden
+  std::vector<float> policy_weights_;  // hidden x policy_size
+  std::vector<float> value_weights_;   // hidden
+  std::vector<float> activations_;     // batch x hidden
+};
+
+struct SelfPlayOptions {
+  int num_games = 1000;       // games to play
+  int games_in_flight = 256;  // searches that run at the same time
+  int num_simulations = 100;  // per move
+  int batch_size = 64;
+  int num_threads = 1;
+  double uct_c = 1.5;
+  // the first moves of each game are sampled in proportion to the visit
+  // counts, the others are the most visited
+  int num_sampled_moves = 4;
+  // priors by compact index instead of by action
+  bool compact_actions = false;
+  // no children for useless moves, see Board::GetLiveLegalActions
+  bool prune_useless_moves = false;
+  int seed = 0;
+};
+
+struct SelfPlayStats {
+  int64_t num_games = 0;
+  int64_t num_moves = 0;
+  int64_t num_results[3] = {0, 0, 0};  // red wins, blue wins, draws
+  int64_t num_evaluations = 0;
+  int64_t num_batches = 0;
+  int64_t num_rounds = 0;
+  double seconds = 0;             // wall time of all games
+  double evaluation_seconds = 0;  // in the evaluator
+  double leaf_seconds = 0;        // from suspending to resuming, summed
+
+  // evaluations per batch slot
+  double FillRate(int batch_size) const;
+  double MeanBatchSeconds() const;
+  double MeanLeafSeconds() const;
+};
+
+// called with the actions and the returns of each finished game, from any
+// of the threads but never from two at once
+using GameCallback = std::function<void(const std::vector<Action>& actions,
+                                        const std::vector<double>& returns)>;
+
+// Plays options.num_games games on options.games_in_flight searches; a
+// search that has finished its game takes the next one. Game i is played
+// with a random generator seeded with options.seed and i, so the games do
+// not depend on num_threads or batch_size as long as the evaluator
+// evaluates each row on its own.
+SelfPlayStats PlaySelfPlayGames(std::shared_ptr<const Game> game,
+                                LeafEvaluator* evaluator,
+                                const SelfPlayOptions& options,
+                                const GameCallback& callback = nullptr);
+
+}  // namespace twixt
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_GAMES_TWIXT_TWIXTSELFPLAY_H_
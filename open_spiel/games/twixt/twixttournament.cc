@@ -0,0 +1,256 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/games/twixt/twixttournament.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <mutex>  // NOLINT
+#include <random>
+#include <thread>  // NOLINT
+#include <utility>
+
+namespace open_spiel {
+namespace twixt {
+namespace {
+
+// Elo points per natural unit of the Bradley-Terry strength
+const double kEloScale = 400 / std::log(10.0);
+// two-sided 95% quantile of the normal distribution
+const double kNormalQuantile95 = 1.959964;
+
+// inverts the symmetric positive definite matrix a (n x n, row-major) in
+// place by Gauss-Jordan elimination; false if it is singular
+bool Invert(int n, std::vector<double>* a) {
+  std::vector<double>& m = *a;
+  std::vector<double> inverse(n * n, 0);
+  for (int i = 0; i < n; i++) {
+    inverse[i * n + i] = 1;
+  }
+  for (int col = 0; col < n; col++) {
+    int pivot = col;
+    for (int row = col + 1; row < n; row++) {
+      if (std::abs(m[row * n + col]) > std::abs(m[pivot * n + col])) {
+        pivot = row;
+      }
+    }
+    if (std::abs(m[pivot * n + col]) < 1e-12) {
+      return false;
+    }
+    for (int k = 0; k < n; k++) {
+      std::swap(m[col * n + k], m[pivot * n + k]);
+      std::swap(inverse[col * n + k], inverse[pivot * n + k]);
+    }
+    const double scale = 1 / m[col * n + col];
+    for (int k = 0; k < n; k++) {
+      m[col * n + k] *= scale;
+      inverse[col * n + k] *= scale;
+    }
+    for (int row = 0; row < n; row++) {
+      const double factor = m[row * n + col];
+      if (row != col && factor != 0) {
+        for (int k = 0; k < n; k++) {
+          m[row * n + k] -= factor * m[col * n + k];
+          inverse[row * n + k] -= factor * inverse[col * n + k];
+        }
+      }
+    }
+  }
+  m = std::move(inverse);
+  return true;
+}
+
+}  // namespace
+
+std::vector<TournamentGame> PlayTournament(
+    std::shared_ptr<const Game> game,
+    const std::vector<TournamentEntry>& entries,
+    const TournamentOptions& options, const TournamentCallback& callback) {
+  SPIEL_CHECK_EQ(game->GetType().short_name, "twixt");
+  const int num_entries = entries.size();
+  SPIEL_CHECK_GE(num_entries, 2);
+  SPIEL_CHECK_GT(options.games_per_pairing, 0);
+  SPIEL_CHECK_GT(options.num_threads, 0);
+
+  // the schedule: pairing after pairing, colors alternating
+  std::vector<TournamentGame> games;
+  for (int first = 0; first < num_entries; first++) {
+    for (int second = first + 1; second < num_entries; second++) {
+      for (int k = 0; k < options.games_per_pairing; k++) {
+        TournamentGame scheduled;
+        scheduled.game = games.size();
+        scheduled.red = k % 2 == 0 ? first : second;
+        scheduled.blue = k % 2 == 0 ? second : first;
+        games.push_back(scheduled);
+      }
+    }
+  }
+
+  const int num_games = games.size();
+  std::atomic<int> next_game(0);
+  std::mutex callback_mutex;
+  auto worker = [&]() {
+    std::vector<std::unique_ptr<Agent>> agents(entries.size());
+    std::unique_ptr<TwixTState> state(
+        static_cast<TwixTState*>(game->NewInitialState().release()));
+    const std::unique_ptr<TwixTState> initial_state(
+        static_cast<TwixTState*>(game->NewInitialState().release()));
+    for (int g = next_game++; g < num_games; g = next_game++) {
+      TournamentGame& played = games[g];
+      for (int entry : {played.red, played.blue}) {
+        if (agents[entry] == nullptr) {
+          agents[entry] = entries[entry].factory();
+        }
+      }
+      std::seed_seq seed{options.seed, g};
+      std::mt19937 rng(seed);
+      initial_state->CloneInto(state.get());
+      while (!state->IsTerminal()) {
+        int entry =
+            state->CurrentPlayer() == kRedPlayer ? played.red : played.blue;
+        Action action = agents[entry]->Step(*state, &rng);
+        state->ApplyAction(action);
+        played.actions.push_back(action);
+      }
+      played.result = state->board().result();
+      played.swapped = state->board().swapped();
+      if (callback) {
+        std::lock_guard<std::mutex> lock(callback_mutex);
+        callback(played);
+      }
+    }
+  };
+
+  const int num_threads = std::min(options.num_threads, num_games);
+  std::vector<std::thread> threads;
+  for (int t = 1; t < num_threads; t++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  return games;
+}
+
+std::vector<Rating> ComputeRatings(int num_entries,
+                                   const std::vector<TournamentGame>& games,
+                                   double prior_draws) {
+  SPIEL_CHECK_GT(num_entries, 0);
+  SPIEL_CHECK_GT(prior_draws, 0);
+  const int n = num_entries;
+  std::vector<Rating> ratings(n);
+  // games and scores between each two entries, the prior included
+  std::vector<double> pair_games(n * n, 0);
+  std::vector<double> scores(n, 0);
+  for (const TournamentGame& game : games) {
+    SPIEL_CHECK_NE(game.result, kOpen);
+    double red_score = 0.5;
+    if (game.result != kDraw) {
+      red_score = game.result == kRedWin ? 1 : 0;
+    }
+    ratings[game.red].games++;
+    ratings[game.blue].games++;
+    ratings[game.red].score += red_score;
+    ratings[game.blue].score += 1 - red_score;
+    pair_games[game.red * n + game.blue]++;
+    pair_games[game.blue * n + game.red]++;
+  }
+  for (int i = 0; i < n; i++) {
+    scores[i] = ratings[i].score;
+    for (int j = 0; j < n; j++) {
+      if (pair_games[i * n + j] > 0) {
+        pair_games[i * n + j] += prior_draws;
+        scores[i] += prior_draws / 2;
+      }
+    }
+  }
+
+  // strengths by the minorization-maximization iteration of Hunter (2004)
+  std::vector<double> strengths(n, 1);
+  for (int iteration = 0; iteration < 100000; iteration++) {
+    double max_change = 0;
+    for (int i = 0; i < n; i++) {
+      double sum = 0;
+      for (int j = 0; j < n; j++) {
+        sum += pair_games[i * n + j] / (strengths[i] + strengths[j]);
+      }
+      if (sum > 0) {
+        double strength = scores[i] / sum;
+        max_change = std::max(
+            max_change, std::abs(strength - strengths[i]) / strengths[i]);
+        strengths[i] = strength;
+      }
+    }
+    if (max_change < 1e-12) {
+      break;
+    }
+  }
+  for (int i = 0; i < n; i++) {
+    ratings[i].elo = kEloScale * std::log(strengths[i] / strengths[0]);
+  }
+
+  // the entries linked to the first one by games
+  std::vector<bool> linked(n, false);
+  std::vector<int> queue = {0};
+  linked[0] = true;
+  while (!queue.empty()) {
+    int i = queue.back();
+    queue.pop_back();
+    for (int j = 0; j < n; j++) {
+      if (!linked[j] && pair_games[i * n + j] > 0) {
+        linked[j] = true;
+        queue.push_back(j);
+      }
+    }
+  }
+  std::vector<int> free_entries;  // all linked ones but the first
+  for (int i = 1; i < n; i++) {
+    if (linked[i]) {
+      free_entries.push_back(i);
+    } else {
+      ratings[i].margin = std::numeric_limits<double>::infinity();
+    }
+  }
+
+  // the covariance of the strengths is the inverse of the Fisher
+  // information of the free ones
+  const int k = free_entries.size();
+  std::vector<double> information(k * k, 0);
+  for (int a = 0; a < k; a++) {
+    const int i = free_entries[a];
+    for (int j = 0; j < n; j++) {
+      const double p = strengths[i] / (strengths[i] + strengths[j]);
+      const double curvature = pair_games[i * n + j] * p * (1 - p);
+      information[a * k + a] += curvature;
+      auto other = std::find(free_entries.begin(), free_entries.end(), j);
+      if (other != free_entries.end()) {
+        information[a * k + (other - free_entries.begin())] -= curvature;
+      }
+    }
+  }
+  const bool invertible = k == 0 || Invert(k, &information);
+  for (int a = 0; a < k; a++) {
+    ratings[free_entries[a]].margin =
+        invertible ? kNormalQuantile95 * kEloScale *
+                         std::sqrt(information[a * k + a])
+                   : std::numeric_limits<double>::infinity();
+  }
+  return ratings;
+}
+
+}  // namespace twixt
+}  // namespace open_spiel
@@ -0,0 +1,96 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_GAMES_TWIXT_TWIXTTOURNAMENT_H_
+#define OPEN_SPIEL_GAMES_TWIXT_TWIXTTOURNAMENT_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "open_spiel/games/twixt/twixtagent.h"
+#include "open_spiel/spiel.h"
+
+// Round-robin tournaments of agents (twixtagent.h) on one machine, and
+// Elo ratings of the results.
+//
+// Every two entries play games_per_pairing games, each entry red in every
+// other one; blue may swap as usual. The games of all pairings are shared
+// out among the threads, each of which has its own agents, so a slow
+// pairing does not hold up the others.
+
+namespace open_spiel {
+namespace twixt {
+
+// creates an agent of an entry; each thread calls it once per entry
+using AgentFactory = std::function<std::unique_ptr<Agent>()>;
+
+struct TournamentEntry {
+  std::string name;
+  AgentFactory factory;
+};
+
+struct TournamentOptions {
+  int games_per_pairing = 100;
+  int num_threads = 1;
+  int seed = 0;
+};
+
+struct TournamentGame {
+  int game = 0;  // number in the schedule
+  int red = 0;   // entry indices
+  int blue = 0;
+  int result = kOpen;  // kRedWin, kBlueWin or kDraw
+  bool swapped = false;
+  std::vector<Action> actions;
+};
+
+// called with each finished game, in the order the games finish, never
+// from two threads at once
+using TournamentCallback = std::function<void(const TournamentGame& game)>;
+
+// Plays the tournament and returns the games in schedule order. Game i is
+// played with a generator seeded with options.seed and i, so the games do
+// not depend on num_threads as long as the agents keep nothing from one
+// move to the next.
+std::vector<TournamentGame> PlayTournament(
+    std::shared_ptr<const Game> game,
+    const std::vector<TournamentEntry>& entries,
+    const TournamentOptions& options,
+    const TournamentCallback& callback = nullptr);
+
+struct Rating {
+  double elo = 0;
+  // half width of the 95% confidence interval of the difference to the
+  // first entry; infinite if no chain of games leads to the first entry
+  double margin = 0;
+  int games = 0;
+  double score = 0;  // wins plus half the draws
+};
+
+// Elo ratings by the maximum of the Bradley-Terry likelihood with a
+// prior, as in BayesElo but without its draw and first-move parameters:
+// a draw counts as half a win for each player, and each pair that has
+// played gets prior_draws extra draws, which keeps the ratings finite
+// when an entry wins all its games. The first entry is fixed at 0; the
+// margins come from the curvature of the likelihood at the maximum.
+std::vector<Rating> ComputeRatings(int num_entries,
+                                   const std::vector<TournamentGame>& games,
+                                   double prior_draws = 2);
+
+}  // namespace twixt
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_GAMES_TWIXT_TWIXTTOURNAMENT_H_
@@ -0,0 +1,285 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/games/twixt/twixttrace.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>  // NOLINT
+
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace twixt {
+namespace {
+
+const char kTraceMagic[8] = {'T', 'W', 'X', 'T', 'R', 'C', '2', '\n'};
+
+// the buffer of a thread is written as a block when it grows beyond this
+const int kTraceBufferSize = 1 << 16;
+
+void AppendVarint(std::vector<uint8_t>* buffer, uint64_t value) {
+  while (value >= 0x80) {
+    buffer->push_back(static_cast<uint8_t>(value) | 0x80);
+    value >>= 7;
+  }
+  buffer->push_back(static_cast<uint8_t>(value));
+}
+
+}  // namespace
+
+const char* TraceOpName(int op) {
+  static const char* kNames[kNumTraceOps] = {
+      "New", "Clone", "ApplyAction", "LegalActions", "ObservationTensor",
+      "ToString", "Delete"};
+  return op >= 0 && op < kNumTraceOps ? kNames[op] : "?";
+}
+
+std::atomic<TraceRecorder*> TraceRecorder::active_{nullptr};
+std::atomic<int64_t> TraceRecorder::num_in_flight_{0};
+uint64_t TraceRecorder::num_activations_ = 0;
+thread_local uint64_t TraceRecorder::thread_activation_ = 0;
+thread_local TraceRecorder::ThreadBuffer* TraceRecorder::thread_buffer_ =
+    nullptr;
+
+TraceRecorder::TraceRecorder(const std::string& path) {
+  file_ = std::fopen(path.c_str(), "wb");
+  if (file_ == nullptr) {
+    SpielFatalError("Cannot write trace " + path);
+  }
+  if (std::fwrite(kTraceMagic, 1, sizeof(kTraceMagic), file_) !=
+      sizeof(kTraceMagic)) {
+    SpielFatalError("Cannot write trace " + path);
+  }
+}
+
+TraceRecorder::~TraceRecorder() {
+  if (active() == this) {
+    SetActive(nullptr);
+  }
+  Flush();
+  std::fclose(file_);
+}
+
+void TraceRecorder::SetActive(TraceRecorder* recorder) {
+  if (recorder == active()) {
+    return;
+  }
+  if (recorder != nullptr) {
+    // the states of an earlier activation are not traced by this one
+    recorder->activation_ = ++num_activations_;
+  }
+  active_.store(recorder, std::memory_order_seq_cst);
+  // a call that saw the previous recorder counted itself in before, see
+  // Acquire
+  while (num_in_flight_.load(std::memory_order_seq_cst) != 0) {
+    std::this_thread::yield();
+  }
+}
+
+TraceRecorder* TraceRecorder::Acquire() {
+  num_in_flight_.fetch_add(1, std::memory_order_seq_cst);
+  TraceRecorder* recorder = active_.load(std::memory_order_seq_cst);
+  if (recorder == nullptr) {
+    Release();
+  }
+  return recorder;
+}
+
+void TraceRecorder::Release() {
+  num_in_flight_.fetch_sub(1, std::memory_order_release);
+}
+
+void TraceRecorder::Record(TraceOp op, uint64_t state_id, uint64_t arg) {
+  ThreadBuffer* buffer = ThisThreadBuffer();
+  // orders the records of all threads: a call made after another one in
+  // a different thread (e.g. on a state handed over) gets a larger number
+  const uint64_t sequence =
+      next_sequence_.fetch_add(1, std::memory_order_relaxed);
+  if (buffer->bytes.empty()) {
+    buffer->first_sequence = sequence;
+    buffer->last_sequence = sequence;
+  }
+  AppendVarint(&buffer->bytes, sequence - buffer->last_sequence);
+  buffer->last_sequence = sequence;
+  buffer->bytes.push_back(op);
+  AppendVarint(&buffer->bytes, state_id);
+  AppendVarint(&buffer->bytes, arg);
+  buffer->num_records.store(
+      buffer->num_records.load(std::memory_order_relaxed) + 1,
+      std::memory_order_relaxed);
+  if (buffer->bytes.size() >= kTraceBufferSize) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    WriteBlockLocked(buffer);
+  }
+}
+
+TraceRecorder::ThreadBuffer* TraceRecorder::ThisThreadBuffer() {
+  if (thread_activation_ != activation_) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffers_.emplace_back(new ThreadBuffer());
+    buffers_.back()->bytes.reserve(kTraceBufferSize + 32);
+    thread_activation_ = activation_;
+    thread_buffer_ = buffers_.back().get();
+  }
+  return thread_buffer_;
+}
+
+void TraceRecorder::Flush() {
+  SPIEL_CHECK_TRUE(active() != this);
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (std::unique_ptr<ThreadBuffer>& buffer : buffers_) {
+    WriteBlockLocked(buffer.get());
+  }
+  std::fflush(file_);
+}
+
+int64_t TraceRecorder::num_records() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  int64_t num_records = 0;
+  for (const std::unique_ptr<ThreadBuffer>& buffer : buffers_) {
+    num_records += buffer->num_records.load(std::memory_order_relaxed);
+  }
+  return num_records;
+}
+
+void TraceRecorder::WriteBlockLocked(ThreadBuffer* buffer) {
+  if (buffer->bytes.empty()) {
+    return;
+  }
+  std::vector<uint8_t> header;
+  AppendVarint(&header, buffer->bytes.size());
+  AppendVarint(&header, buffer->first_sequence);
+  if (std::fwrite(header.data(), 1, header.size(), file_) != header.size() ||
+      std::fwrite(buffer->bytes.data(), 1, buffer->bytes.size(), file_) !=
+          buffer->bytes.size()) {
+    SpielFatalError("Cannot write trace");
+  }
+  buffer->bytes.clear();
+}
+
+void TraceId::Start() {
+  if (TraceRecorder* recorder = TraceRecorder::Acquire()) {
+    activation_ = recorder->activation_;
+    id_ = recorder->NewStateId();
+    TraceRecorder::Release();
+  }
+}
+
+void TraceId::CloneFrom(const TraceId& other) {
+  if (TraceRecorder* recorder = TraceRecorder::Acquire()) {
+    if (other.TracedBy(*recorder)) {
+      activation_ = recorder->activation_;
+      id_ = recorder->NewStateId();
+      recorder->Record(kTraceClone, other.id_, id_);
+    }
+    TraceRecorder::Release();
+  }
+}
+
+void TraceId::Assign(const TraceId& other) {
+  if (TraceRecorder* recorder = TraceRecorder::Acquire()) {
+    if (other.TracedBy(*recorder)) {
+      if (!TracedBy(*recorder)) {
+        activation_ = recorder->activation_;
+        id_ = recorder->NewStateId();
+      }
+      recorder->Record(kTraceClone, other.id_, id_);
+    } else if (TracedBy(*recorder)) {
+      // the replay could not know what this state holds from now on
+      recorder->Record(kTraceDelete, id_, 0);
+      id_ = 0;
+    }
+    TraceRecorder::Release();
+  }
+}
+
+void TraceId::RecordSlow(TraceOp op, uint64_t arg) const {
+  if (TraceRecorder* recorder = TraceRecorder::Acquire()) {
+    if (TracedBy(*recorder)) {
+      recorder->Record(op, id_, arg);
+    }
+    TraceRecorder::Release();
+  }
+}
+
+TraceReader::TraceReader(absl::string_view data) {
+  ok_ = data.size() >= sizeof(kTraceMagic) &&
+        std::memcmp(data.data(), kTraceMagic, sizeof(kTraceMagic)) == 0;
+  if (!ok_) {
+    return;
+  }
+  data.remove_prefix(sizeof(kTraceMagic));
+  uint64_t size;
+  Block block;
+  while (ReadVarint(&data, &size) && ReadVarint(&data, &block.sequence)) {
+    // a truncated last block keeps what there is of it
+    block.data = data.substr(0, size);
+    data.remove_prefix(block.data.size());
+    if (Advance(&block)) {
+      blocks_.push_back(block);
+    }
+  }
+  std::make_heap(blocks_.begin(), blocks_.end(), BlockAfter);
+}
+
+bool TraceReader::Next(TraceRecord* record) {
+  while (!blocks_.empty()) {
+    std::pop_heap(blocks_.begin(), blocks_.end(), BlockAfter);
+    Block& block = blocks_.back();
+    const bool complete =
+        !block.data.empty() &&
+        static_cast<uint8_t>(block.data[0]) < kNumTraceOps;
+    if (complete) {
+      record->op = static_cast<TraceOp>(block.data[0]);
+      block.data.remove_prefix(1);
+    }
+    if (complete && ReadVarint(&block.data, &record->state_id) &&
+        ReadVarint(&block.data, &record->arg)) {
+      if (Advance(&block)) {
+        std::push_heap(blocks_.begin(), blocks_.end(), BlockAfter);
+      } else {
+        blocks_.pop_back();
+      }
+      return true;
+    }
+    blocks_.pop_back();
+  }
+  return false;
+}
+
+bool TraceReader::Advance(Block* block) {
+  uint64_t difference;
+  if (!ReadVarint(&block->data, &difference)) {
+    return false;
+  }
+  block->sequence += difference;
+  return true;
+}
+
+bool TraceReader::ReadVarint(absl::string_view* data, uint64_t* value) {
+  *value = 0;
+  for (int shift = 0; shift < 64 && !data->empty(); shift += 7) {
+    uint8_t byte = (*data)[0];
+    data->remove_prefix(1);
+    *value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace twixt
+}  // namespace open_spiel
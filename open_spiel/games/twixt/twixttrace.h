@@ -0,0 +1,221 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_GAMES_TWIXT_TWIXTTRACE_H_
+#define OPEN_SPIEL_GAMES_TWIXT_TWIXTTRACE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
+
+// trace of the engine calls made on TwixTStates, for replaying production
+// workloads in benchmarks (see examples/twixt_replay.cc).
+//
+// Recording is off unless a TraceRecorder is made active:
+//
+//   TraceRecorder recorder("/tmp/twixt.trace");
+//   TraceRecorder::SetActive(&recorder);
+//   ...  // all states created from now on are traced
+//   TraceRecorder::SetActive(nullptr);
+//
+// While no recorder is active, tracing costs one atomic load per call.
+// States are traced by the activation they were created or cloned in:
+// once another recorder is made active, or the same one again, the calls
+// on the older states are not recorded any more (some of their calls
+// would be missing from the trace).
+//
+// Each thread buffers its records and writes them as a block of their own,
+// so the blocks of several threads do not come in the order of the calls;
+// each record has a sequence number and TraceReader puts them back in that
+// order.
+//
+// Trace file: the magic "TWXTRC2\n", then blocks: the number of bytes of
+// its records and the sequence number of its first record as LEB128
+// varints, then the records: the sequence number as a varint difference
+// to that of the previous record of the block (0 for the first), the op
+// as one byte, the state id and an argument as varints.
+
+namespace open_spiel {
+namespace twixt {
+
+enum TraceOp : uint8_t {
+  kTraceNew,                // arg: board_size + 256 * ansi_color_output
+                            //      + 512 * adjudicate
+                            //      + 1024 * link_removal
+  kTraceClone,              // arg: id of the copy
+  kTraceApplyAction,        // arg: action
+  kTraceLegalActions,       // arg: number of legal actions
+  kTraceObservationTensor,  // arg: player
+  kTraceToString,           // arg: length of the string
+  kTraceDelete,             // arg: 0
+  kNumTraceOps
+};
+
+const char* TraceOpName(int op);
+
+struct TraceRecord {
+  TraceOp op;
+  uint64_t state_id;
+  uint64_t arg;
+};
+
+class TraceRecorder {
+ public:
+  explicit TraceRecorder(const std::string& path);
+  // makes the recorder inactive first if it is active
+  ~TraceRecorder();
+  TraceRecorder(const TraceRecorder&) = delete;
+  TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+  // the recorder states report to, nullptr if tracing is off
+  static TraceRecorder* active() {
+    return active_.load(std::memory_order_acquire);
+  }
+  // waits until the calls that may still record into the recorder that
+  // was active have returned, after which it may be deleted; not to be
+  // called from several threads at once
+  static void SetActive(TraceRecorder* recorder);
+
+  // writes the records the threads have buffered; not while the recorder
+  // is active
+  void Flush();
+  int64_t num_records() const;
+
+ private:
+  friend class TraceId;
+
+  // the records of one thread not written yet
+  struct ThreadBuffer {
+    std::vector<uint8_t> bytes;
+    uint64_t first_sequence = 0;
+    uint64_t last_sequence = 0;
+    std::atomic<int64_t> num_records{0};
+  };
+
+  // between the two, the recorder that Acquire returns is not deleted
+  // (see SetActive); Acquire returns nullptr if tracing is off
+  static TraceRecorder* Acquire();
+  static void Release();
+
+  uint64_t NewStateId() {
+    return next_state_id_.fetch_add(1, std::memory_order_relaxed);
+  }
+  void Record(TraceOp op, uint64_t state_id, uint64_t arg);
+  ThreadBuffer* ThisThreadBuffer();
+  void WriteBlockLocked(ThreadBuffer* buffer);
+
+  static std::atomic<TraceRecorder*> active_;
+  static std::atomic<int64_t> num_in_flight_;  // calls between Acquire
+                                               // and Release
+  static uint64_t num_activations_;
+  // the buffer of this thread, for the activation it was made for
+  static thread_local uint64_t thread_activation_;
+  static thread_local ThreadBuffer* thread_buffer_;
+  uint64_t activation_ = 0;  // of the current or last SetActive
+  std::atomic<uint64_t> next_state_id_{1};
+  std::atomic<uint64_t> next_sequence_{0};
+  // guards buffers_ and the file
+  mutable std::mutex mutex_;
+  FILE* file_;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+};
+
+// identity of a TwixTState in the trace, 0 if the state is not traced;
+// copying a traced state records a clone, destroying it a delete
+class TraceId {
+ public:
+  TraceId() {
+    if (TraceRecorder::active() != nullptr) {
+      Start();
+    }
+  }
+  TraceId(const TraceId& other) {
+    if (other.id_ != 0 && TraceRecorder::active() != nullptr) {
+      CloneFrom(other);
+    }
+  }
+  // a traced state assigned to this one is recorded as a clone into it
+  // (which gets an id if it has none); an untraced one makes this state
+  // untraced, with a delete
+  TraceId& operator=(const TraceId& other) {
+    if (this != &other && (id_ != 0 || other.id_ != 0) &&
+        TraceRecorder::active() != nullptr) {
+      Assign(other);
+    }
+    return *this;
+  }
+  ~TraceId() { Record(kTraceDelete, 0); }
+
+  uint64_t id() const { return id_; }
+  void Record(TraceOp op, uint64_t arg) const {
+    if (id_ != 0 && TraceRecorder::active() != nullptr) {
+      RecordSlow(op, arg);
+    }
+  }
+
+ private:
+  bool TracedBy(const TraceRecorder& recorder) const {
+    return id_ != 0 && activation_ == recorder.activation_;
+  }
+  void Start();
+  void CloneFrom(const TraceId& other);
+  void Assign(const TraceId& other);
+  void RecordSlow(TraceOp op, uint64_t arg) const;
+
+  uint64_t activation_ = 0;  // of the recorder that knows the id
+  uint64_t id_ = 0;
+};
+
+// decodes the records of a trace file in place
+class TraceReader {
+ public:
+  explicit TraceReader(absl::string_view data);
+
+  // false if data does not start with the trace magic
+  bool ok() const { return ok_; }
+  // the records in the order of the calls; false at the end of the trace
+  // (a truncated record ends its block)
+  bool Next(TraceRecord* record);
+
+ private:
+  // the records of a block not read yet, the first one after its sequence
+  // number, which is in sequence
+  struct Block {
+    absl::string_view data;
+    uint64_t sequence;
+  };
+
+  // reads the sequence number of the next record of block; false at its
+  // end
+  static bool Advance(Block* block);
+  static bool BlockAfter(const Block& a, const Block& b) {
+    return a.sequence > b.sequence;
+  }
+  static bool ReadVarint(absl::string_view* data, uint64_t* value);
+
+  bool ok_;
+  // a heap by sequence number of the blocks that have records left
+  std::vector<Block> blocks_;
+};
+
+}  // namespace twixt
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_GAMES_TWIXT_TWIXTTRACE_H_
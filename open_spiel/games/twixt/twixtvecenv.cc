@@ -0,0 +1,89 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/games/twixt/twixtvecenv.h"
+
+#include <algorithm>
+
+namespace open_spiel {
+namespace twixt {
+
+VectorEnv::VectorEnv(std::shared_ptr<const Game> game, int num_envs)
+    : game_(game),
+      observation_size_(game->ObservationTensorSize()),
+      num_distinct_actions_(game->NumDistinctActions()) {
+  SPIEL_CHECK_EQ(game->GetType().short_name, "twixt");
+  SPIEL_CHECK_GT(num_envs, 0);
+  initial_state_.reset(
+      static_cast<TwixTState*>(game->NewInitialState().release()));
+  for (int i = 0; i < num_envs; i++) {
+    states_.emplace_back(new TwixTState(*initial_state_));
+  }
+  observations_.resize(num_envs * observation_size_);
+  legal_action_masks_.resize(num_envs * num_distinct_actions_);
+  rewards_.resize(num_envs * kNumPlayers);
+  dones_.resize(num_envs);
+  current_players_.resize(num_envs);
+  Reset();
+}
+
+void VectorEnv::Reset() {
+  for (int i = 0; i < num_envs(); i++) {
+    ResetGame(i);
+    WriteOutputs(i);
+  }
+  std::fill(rewards_.begin(), rewards_.end(), 0.0);
+  std::fill(dones_.begin(), dones_.end(), 0);
+}
+
+void VectorEnv::Step(absl::Span<const Action> actions) {
+  SPIEL_CHECK_EQ(static_cast<int>(actions.size()), num_envs());
+  for (int i = 0; i < num_envs(); i++) {
+    State& state = *states_[i];
+    state.ApplyAction(actions[i]);
+    if (state.IsTerminal()) {
+      std::vector<double> returns = state.Returns();
+      for (Player p = 0; p < kNumPlayers; p++) {
+        rewards_[i * kNumPlayers + p] = returns[p];
+      }
+      dones_[i] = 1;
+      ResetGame(i);
+    } else {
+      rewards_[i * kNumPlayers] = 0.0;
+      rewards_[i * kNumPlayers + 1] = 0.0;
+      dones_[i] = 0;
+    }
+    WriteOutputs(i);
+  }
+}
+
+void VectorEnv::ResetGame(int index) {
+  initial_state_->CloneInto(states_[index].get());
+}
+
+void VectorEnv::WriteOutputs(int index) {
+  const TwixTState& state = *states_[index];
+  Player player = state.CurrentPlayer();
+  current_players_[index] = player;
+
+  state.ObservationTensor(
+      player, absl::MakeSpan(&observations_[index * observation_size_],
+                             observation_size_));
+
+  state.board().GetLegalActionMask(
+      player, &legal_action_masks_[index * num_distinct_actions_]);
+}
+
+}  // namespace twixt
+}  // namespace open_spiel
@@ -0,0 +1,81 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_GAMES_TWIXT_TWIXTVECENV_H_
+#define OPEN_SPIEL_GAMES_TWIXT_TWIXTVECENV_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "open_spiel/games/twixt/twixt.h"
+#include "open_spiel/spiel.h"
+
+namespace open_spiel {
+namespace twixt {
+
+// Steps num_envs TwixT games in one call.
+// The results of a step are written into buffers that are allocated once
+// and live as long as the env, so that the python bindings can hand them
+// out as numpy arrays without copying:
+// * observations:       num_envs x ObservationTensorSize() floats,
+//                        observation of the player to move
+// * legal_action_masks: num_envs x NumDistinctActions() bytes (0|1)
+// * rewards:            num_envs x kNumPlayers floats,
+//                        returns of the game that ended in this step
+// * dones:              num_envs bytes, 1 if the game ended in this step
+// * current_players:    num_envs ints, player to move
+// A finished game is reset to the initial state within the same step,
+// so the observation and mask of a done game belong to the new game.
+class VectorEnv {
+ public:
+  VectorEnv(std::shared_ptr<const Game> game, int num_envs);
+
+  // resets all games to the initial state
+  void Reset();
+  // applies actions[i] to game i (actions.size() == num_envs())
+  void Step(absl::Span<const Action> actions);
+
+  int num_envs() const { return states_.size(); }
+  int observation_size() const { return observation_size_; }
+  int num_distinct_actions() const { return num_distinct_actions_; }
+  const TwixTState& state(int index) const { return *states_[index]; }
+
+  float* observations() { return observations_.data(); }
+  uint8_t* legal_action_masks() { return legal_action_masks_.data(); }
+  float* rewards() { return rewards_.data(); }
+  uint8_t* dones() { return dones_.data(); }
+  int* current_players() { return current_players_.data(); }
+
+ private:
+  void ResetGame(int index);
+  void WriteOutputs(int index);
+
+  std::shared_ptr<const Game> game_;
+  std::unique_ptr<TwixTState> initial_state_;
+  std::vector<std::unique_ptr<TwixTState>> states_;
+  int observation_size_;
+  int num_distinct_actions_;
+
+  std::vector<float> observations_;
+  std::vector<uint8_t> legal_action_masks_;
+  std::vector<float> rewards_;
+  std::vector<uint8_t> dones_;
+  std::vector<int> current_players_;
+};
+
+}  // namespace twixt
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_GAMES_TWIXT_TWIXTVECENV_H_
@@ -0,0 +1,104 @@
+// Copyright 2019 DeepMind Technologies Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/python/pybind11/games_twixt.h"
+
+#include <memory>
+
+#include "open_spiel/games/twixt/twixtvecenv.h"
+#include "open_spiel/spiel.h"
+#include "pybind11/include/pybind11/numpy.h"
+
+namespace py = ::pybind11;
+
+namespace open_spiel {
+namespace {
+
+using twixt::VectorEnv;
+
+// numpy view of a buffer owned by env; the array keeps env alive
+template <typename T>
+py::array BufferView(py::object env, T* data, std::vector<ssize_t> shape) {
+  std::vector<ssize_t> strides(shape.size(), sizeof(T));
+  for (int i = shape.size() - 2; i >= 0; i--) {
+    strides[i] = strides[i + 1] * shape[i + 1];
+  }
+  return py::array(py::dtype::of<T>(), shape, strides, data, env);
+}
+
+}  // namespace
+
+void init_pyspiel_games_twixt(py::module& m) {
+  py::module twixt = m.def_submodule("twixt");
+
+  // Usage:
+  //   env = pyspiel.twixt.VectorEnv(pyspiel.load_game("twixt"), 1024)
+  //   obs, mask = env.observations, env.legal_action_masks
+  //   env.step(actions)  # obs and mask now hold the next positions
+  py::class_<VectorEnv>(twixt, "VectorEnv")
+      .def(py::init<std::shared_ptr<const Game>, int>(), py::arg("game"),
+           py::arg("num_envs"))
+      .def("reset", &VectorEnv::Reset)
+      .def("step",
+           [](VectorEnv& env,
+              py::array_t<Action, py::array::c_style | py::array::forcecast>
+                  actions) {
+             if (actions.ndim() != 1 || actions.shape(0) != env.num_envs()) {
+               throw py::value_error("step() needs one action per game");
+             }
+             absl::Span<const Action> span(actions.data(), actions.shape(0));
+             py::gil_scoped_release release;
+             env.Step(span);
+           },
+           py::arg("actions"))
+      .def_property_readonly("num_envs", &VectorEnv::num_envs)
+      .def_property_readonly(
+          "observations",
+          [](py::object self) {
+            VectorEnv& env = self.cast<VectorEnv&>();
+            return BufferView(self, env.observations(),
+                              {env.num_envs(), env.observation_size()});
+          })
+      .def_property_readonly(
+          "legal_action_masks",
+          [](py::object self) {
+            VectorEnv& env = self.cast<VectorEnv&>();
+            // bytes are 0|1, so they can be viewed as numpy bools
+            return BufferView(self,
+                              reinterpret_cast<bool*>(
+                                  env.legal_action_masks()),
+                              {env.num_envs(), env.num_distinct_actions()});
+          })
+      .def_property_readonly(
+          "rewards",
+          [](py::object self) {
+            VectorEnv& env = self.cast<VectorEnv&>();
+            return BufferView(self, env.rewards(),
+                              {env.num_envs(), twixt::kNumPlayers});
+          })
+      .def_property_readonly(
+          "dones",
+          [](py::object self) {
+            VectorEnv& env = self.cast<VectorEnv&>();
+            return BufferView(self, reinterpret_cast<bool*>(env.dones()),
+                              {env.num_envs()});
+          })
+      .def_property_readonly(
+          "current_players", [](py::object self) {
+            VectorEnv& env = self.cast<VectorEnv&>();
+            return BufferView(self, env.current_players(), {env.num_envs()});
+          });
+}
+
+}  // namespace open_spiel